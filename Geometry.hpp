@@ -11,16 +11,29 @@
 #include "geom/primitives/Vector2D.hpp"
 
 #include "geom/shapes/ShapeContainer.hpp"
-#include "geom/shapes/Shape.hpp"
 #include "geom/shapes/Rectangle.hpp"
 #include "geom/shapes/Polygon.hpp"
+#include "geom/shapes/PolygonPool.hpp"
+#include "geom/shapes/PolygonView.hpp"
 #include "geom/shapes/Circle.hpp"
 
 #include "geom/intersections/intersections.hpp"
 #include "geom/intersections/overlaps.hpp"
+#include "geom/intersections/sat.hpp"
+#include "geom/intersections/SeparatingAxisCache.hpp"
+#include "geom/intersections/gjk.hpp"
+#include "geom/intersections/RectBatch.hpp"
 
 #include "geom/collisions/collisions.hpp"
+#include "geom/collisions/overlapping_pairs.hpp"
 #include "geom/collisions/CollisionMap.hpp"
+#include "geom/collisions/broadphase.hpp"
+#include "geom/collisions/GridCollisionMap.hpp"
+#include "geom/collisions/DynamicTreeCollisionMap.hpp"
+#include "geom/collisions/SweepAndPruneCollisionMap.hpp"
+#include "geom/collisions/LooseQuadtreeCollisionMap.hpp"
+#include "geom/collisions/StaticBVHCollisionMap.hpp"
+#include "geom/collisions/HashedGridCollisionMap.hpp"
 #include "geom/collisions/Collidable.hpp"
 #include "geom/collisions/Movable.hpp"
 #include "geom/collisions/Wall.hpp"
@@ -0,0 +1,42 @@
+#include "CollisionMap.hpp"
+
+#include <cmath>
+
+#include "Collidable.hpp"
+#include "../debug_logger.hpp"
+#include "../units.hpp"
+#include "../intersections/isect_ray_shape_container.hpp"
+#include "../primitives/Ray.hpp"
+#include "../shapes/ShapeContainer.hpp"
+
+namespace ctp {
+namespace {
+// A point at the ray's origin, so the ray's path can be found as a swept collider.
+class RayOrigin : public Collidable {
+public:
+	explicit RayOrigin(Coord2 origin) : point_(Rect(0, 0, 0, 0)), origin_(origin) {}
+	Coord2 getPosition() const override { return origin_; }
+	ConstShapeRef getCollider() const override { return point_; }
+private:
+	ShapeContainer point_;
+	Coord2 origin_;
+};
+}
+
+RaycastHit CollisionMap::raycast(const Ray& ray, gFloat maxT) const {
+	DBG_CHECK(!std::isfinite(maxT), "ERR", "Raycasts against a CollisionMap need a finite maxT.");
+	RaycastHit hit;
+	const RayOrigin origin(ray.origin);
+	gFloat t;
+	Coord2 normal;
+	for (Collidable* collidable : getColliding(origin, ray.dir * maxT)) {
+		if (intersects(ray, collidable->getCollider(), collidable->getPosition(), t, normal) && t <= maxT) {
+			maxT = t;
+			hit.collidable = collidable;
+			hit.t = t;
+			hit.normal = normal;
+		}
+	}
+	return hit;
+}
+}
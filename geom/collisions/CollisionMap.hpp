@@ -7,16 +7,40 @@
 
 namespace ctp {
 class Collidable;
+struct Ray;
+
+// The closest collidable hit by a ray.
+struct RaycastHit {
+	Collidable* collidable{nullptr}; // Collidable hit, or nullptr if the ray hit nothing.
+	gFloat t{0};                     // Distance along the ray to the hit.
+	Coord2 normal;                   // Normal of the surface hit. (0, 0) if the ray starts inside the collidable.
+	explicit operator bool() const noexcept { return collidable != nullptr; }
+};
 
 class CollisionMap {
 public:
 	virtual ~CollisionMap() = default;
 	// Given a collider and its delta, return a set of shapes it may collide with.
 	virtual const std::vector<Collidable*> getColliding(const Collidable& collider, Coord2 delta) const = 0;
+	// Given a collider at a given position and its delta, return a set of shapes it may collide with.
+	// A Movable's position changes while it resolves a move, so it queries with its current position rather than getPosition().
+	// Default implementation ignores the position, for maps that don't sort by location.
+	virtual const std::vector<Collidable*> getColliding(const Collidable& collider, Coord2, Coord2 delta) const {
+		return getColliding(collider, delta);
+	}
+	// Fill colliding with the set of shapes a collider at a given position may collide with, replacing its contents.
+	// Reusing one vector across queries keeps its capacity, so repeated queries don't allocate.
+	// Default implementation copies the result of the position query, for maps that don't implement it.
+	virtual void getColliding(const Collidable& collider, Coord2 position, Coord2 delta, std::vector<Collidable*>& colliding) const {
+		colliding = getColliding(collider, position, delta);
+	}
 	// Given a collider, return a set of shapes it may overlap with.
 	virtual const std::vector<Collidable*> getColliding(const Collidable& collider) const {
 		return getColliding(collider, Coord2(0, 0));
 	}
+	// Find the closest collidable the ray hits within maxT of its origin. maxT must be finite.
+	// Default implementation tests every collidable the ray's path may collide with.
+	virtual RaycastHit raycast(const Ray& ray, gFloat maxT) const;
 };
 }
 #endif // INCLUDE_GEOM_COLLISION_MAP_HPP
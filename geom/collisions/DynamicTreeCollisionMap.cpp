@@ -0,0 +1,272 @@
+#include "DynamicTreeCollisionMap.hpp"
+
+#include <algorithm>
+
+#include "Collidable.hpp"
+#include "broadphase.hpp"
+#include "../units.hpp"
+#include "../intersections/isect_ray_shape_container.hpp"
+#include "../primitives/Ray.hpp"
+#include "../shapes/ShapeContainer.hpp"
+
+namespace ctp {
+
+const gFloat DynamicTreeCollisionMap::DEFAULT_MARGIN = 0.1f;
+
+const std::vector<Collidable*> DynamicTreeCollisionMap::getColliding(const Collidable& collider, Coord2 delta) const {
+	return getColliding(collider, collider.getPosition(), delta);
+}
+
+const std::vector<Collidable*> DynamicTreeCollisionMap::getColliding(const Collidable& collider, Coord2 position, Coord2 delta) const {
+	std::vector<Collidable*> colliding;
+	getColliding(collider, position, delta, colliding);
+	return colliding;
+}
+
+void DynamicTreeCollisionMap::getColliding(const Collidable& collider, Coord2 position, Coord2 delta, std::vector<Collidable*>& colliding) const {
+	colliding.clear();
+	if (root_ == NULL_NODE)
+		return;
+	const broadphase::AABB query(broadphase::sweep(broadphase::getAABB(collider, position), delta));
+	broadphase::NodeStack stack;
+	stack.push_back(root_);
+	while (!stack.empty()) {
+		const Node& node = nodes_[stack.back()];
+		stack.pop_back();
+		if (!broadphase::overlaps(node.aabb, query))
+			continue;
+		if (node.isLeaf()) {
+			if (node.collidable != &collider)
+				colliding.push_back(node.collidable);
+		} else {
+			stack.push_back(node.left);
+			stack.push_back(node.right);
+		}
+	}
+}
+
+RaycastHit DynamicTreeCollisionMap::raycast(const Ray& ray, gFloat maxT) const {
+	RaycastHit hit;
+	const Coord2 inverseDir(broadphase::getInverseDir(ray));
+	gFloat enter, t;
+	Coord2 normal;
+	broadphase::RayNodeStack stack;
+	if (root_ != NULL_NODE && broadphase::raycast(ray, inverseDir, nodes_[root_].aabb, maxT, enter))
+		stack.push_back({root_, enter});
+	while (!stack.empty()) {
+		const auto [index, nodeEnter] = stack.back();
+		stack.pop_back();
+		if (nodeEnter > maxT)
+			continue; // A closer hit was found after this node was added.
+		const Node& node = nodes_[index];
+		if (node.isLeaf()) {
+			if (intersects(ray, node.collidable->getCollider(), node.collidable->getPosition(), t, normal) && t <= maxT) {
+				maxT = t;
+				hit.collidable = node.collidable;
+				hit.t = t;
+				hit.normal = normal;
+			}
+			continue;
+		}
+		// Add the nearer child last, so it's visited first.
+		gFloat leftEnter, rightEnter;
+		const bool hitsLeft(broadphase::raycast(ray, inverseDir, nodes_[node.left].aabb, maxT, leftEnter));
+		const bool hitsRight(broadphase::raycast(ray, inverseDir, nodes_[node.right].aabb, maxT, rightEnter));
+		if (hitsLeft && hitsRight) {
+			if (leftEnter < rightEnter) {
+				stack.push_back({node.right, rightEnter});
+				stack.push_back({node.left, leftEnter});
+			} else {
+				stack.push_back({node.left, leftEnter});
+				stack.push_back({node.right, rightEnter});
+			}
+		} else if (hitsLeft) {
+			stack.push_back({node.left, leftEnter});
+		} else if (hitsRight) {
+			stack.push_back({node.right, rightEnter});
+		}
+	}
+	return hit;
+}
+
+void DynamicTreeCollisionMap::insert(Collidable* collidable) {
+	if (contains(collidable))
+		return;
+	const int leaf = _allocate_node();
+	nodes_[leaf].aabb = broadphase::fatten(broadphase::getAABB(*collidable), margin_);
+	nodes_[leaf].collidable = collidable;
+	nodes_[leaf].height = 0;
+	_insert_leaf(leaf);
+	leaves_.emplace(collidable, leaf);
+}
+
+void DynamicTreeCollisionMap::remove(const Collidable* collidable) {
+	const auto it = leaves_.find(collidable);
+	if (it == leaves_.end())
+		return;
+	_remove_leaf(it->second);
+	_free_node(it->second);
+	leaves_.erase(it);
+}
+
+bool DynamicTreeCollisionMap::update(Collidable* collidable) {
+	const auto it = leaves_.find(collidable);
+	if (it == leaves_.end()) {
+		insert(collidable);
+		return true;
+	}
+	const int leaf = it->second;
+	const broadphase::AABB aabb(broadphase::getAABB(*collidable));
+	if (broadphase::contains(nodes_[leaf].aabb, aabb))
+		return false; // Still inside its fat box.
+	_remove_leaf(leaf);
+	nodes_[leaf].aabb = broadphase::fatten(aabb, margin_);
+	_insert_leaf(leaf);
+	return true;
+}
+
+void DynamicTreeCollisionMap::clear() {
+	root_ = NULL_NODE;
+	free_list_ = NULL_NODE;
+	nodes_.clear();
+	leaves_.clear();
+}
+
+int DynamicTreeCollisionMap::_allocate_node() {
+	if (free_list_ == NULL_NODE) {
+		nodes_.emplace_back();
+		return static_cast<int>(nodes_.size()) - 1;
+	}
+	const int node = free_list_;
+	free_list_ = nodes_[node].parent;
+	nodes_[node] = Node{};
+	return node;
+}
+
+void DynamicTreeCollisionMap::_free_node(int node) {
+	nodes_[node].parent = free_list_;
+	nodes_[node].height = -1;
+	nodes_[node].collidable = nullptr;
+	free_list_ = node;
+}
+
+void DynamicTreeCollisionMap::_insert_leaf(int leaf) {
+	if (root_ == NULL_NODE) {
+		root_ = leaf;
+		nodes_[leaf].parent = NULL_NODE;
+		return;
+	}
+	// Descend the tree to find the best sibling, by the cost of enlarging the boxes along the way (branch and bound, greedily).
+	const broadphase::AABB leafAABB(nodes_[leaf].aabb);
+	int index = root_;
+	while (!nodes_[index].isLeaf()) {
+		const Node& node = nodes_[index];
+		const gFloat area(broadphase::perimeter(node.aabb));
+		const gFloat combinedArea(broadphase::perimeter(broadphase::combine(node.aabb, leafAABB)));
+		const gFloat cost(2 * combinedArea); // Cost of making a new parent for this node and the leaf.
+		const gFloat inheritanceCost(2 * (combinedArea - area)); // Minimum cost of pushing the leaf further down the tree.
+		const auto descendCost = [&](int child) {
+			const Node& c = nodes_[child];
+			const gFloat enlarged(broadphase::perimeter(broadphase::combine(c.aabb, leafAABB)));
+			return (c.isLeaf() ? enlarged : enlarged - broadphase::perimeter(c.aabb)) + inheritanceCost;
+		};
+		const gFloat leftCost(descendCost(node.left));
+		const gFloat rightCost(descendCost(node.right));
+		if (cost < leftCost && cost < rightCost)
+			break;
+		index = leftCost < rightCost ? node.left : node.right;
+	}
+	const int sibling = index;
+	// Create a new parent for the sibling and the leaf.
+	const int oldParent = nodes_[sibling].parent;
+	const int newParent = _allocate_node();
+	nodes_[newParent].parent = oldParent;
+	nodes_[newParent].aabb = broadphase::combine(leafAABB, nodes_[sibling].aabb);
+	nodes_[newParent].height = nodes_[sibling].height + 1;
+	nodes_[newParent].left = sibling;
+	nodes_[newParent].right = leaf;
+	nodes_[sibling].parent = newParent;
+	nodes_[leaf].parent = newParent;
+	if (oldParent == NULL_NODE) {
+		root_ = newParent;
+	} else if (nodes_[oldParent].left == sibling) {
+		nodes_[oldParent].left = newParent;
+	} else {
+		nodes_[oldParent].right = newParent;
+	}
+	_refit(nodes_[leaf].parent);
+}
+
+void DynamicTreeCollisionMap::_remove_leaf(int leaf) {
+	if (leaf == root_) {
+		root_ = NULL_NODE;
+		return;
+	}
+	const int parent = nodes_[leaf].parent;
+	const int grandParent = nodes_[parent].parent;
+	const int sibling = nodes_[parent].left == leaf ? nodes_[parent].right : nodes_[parent].left;
+	_free_node(parent);
+	if (grandParent == NULL_NODE) {
+		root_ = sibling;
+		nodes_[sibling].parent = NULL_NODE;
+		return;
+	}
+	// Replace the parent with the sibling.
+	if (nodes_[grandParent].left == parent)
+		nodes_[grandParent].left = sibling;
+	else
+		nodes_[grandParent].right = sibling;
+	nodes_[sibling].parent = grandParent;
+	_refit(grandParent);
+}
+
+void DynamicTreeCollisionMap::_refit(int node) {
+	while (node != NULL_NODE) {
+		node = _balance(node);
+		Node& n = nodes_[node];
+		n.height = 1 + std::max(nodes_[n.left].height, nodes_[n.right].height);
+		n.aabb = broadphase::combine(nodes_[n.left].aabb, nodes_[n.right].aabb);
+		node = n.parent;
+	}
+}
+
+int DynamicTreeCollisionMap::_balance(int a) {
+	// Rotations are as in an AVL tree: promote the taller child of the taller child.
+	if (nodes_[a].isLeaf())
+		return a;
+	const int b = nodes_[a].left;
+	const int c = nodes_[a].right;
+	const int balance = nodes_[c].height - nodes_[b].height;
+	if (balance > 1)
+		std::swap(nodes_[a].left, nodes_[a].right); // Handle the right side being taller by mirroring.
+	else if (balance >= -1)
+		return a;
+	// The left child (now "tall") is promoted to replace a.
+	const int tall = nodes_[a].left;
+	const int shortChild = nodes_[a].right;
+	const int f = nodes_[tall].left;
+	const int g = nodes_[tall].right;
+	nodes_[tall].left = a;
+	nodes_[tall].parent = nodes_[a].parent;
+	nodes_[a].parent = tall;
+	if (nodes_[tall].parent == NULL_NODE)
+		root_ = tall;
+	else if (nodes_[nodes_[tall].parent].left == a)
+		nodes_[nodes_[tall].parent].left = tall;
+	else
+		nodes_[nodes_[tall].parent].right = tall;
+	// The shorter grandchild goes back under a, next to a's other child.
+	const bool isFTaller = nodes_[f].height > nodes_[g].height;
+	const int keep = isFTaller ? f : g;
+	const int give = isFTaller ? g : f;
+	nodes_[tall].right = keep;
+	nodes_[a].left = give;
+	nodes_[a].right = shortChild;
+	nodes_[give].parent = a;
+	nodes_[a].aabb = broadphase::combine(nodes_[give].aabb, nodes_[shortChild].aabb);
+	nodes_[a].height = 1 + std::max(nodes_[give].height, nodes_[shortChild].height);
+	nodes_[tall].aabb = broadphase::combine(nodes_[a].aabb, nodes_[keep].aabb);
+	nodes_[tall].height = 1 + std::max(nodes_[a].height, nodes_[keep].height);
+	return tall;
+}
+}
@@ -0,0 +1,77 @@
+#ifndef INCLUDE_GEOM_DYNAMIC_TREE_COLLISION_MAP_HPP
+#define INCLUDE_GEOM_DYNAMIC_TREE_COLLISION_MAP_HPP
+
+#include <cstddef>
+#include <unordered_map>
+#include <vector>
+
+#include "CollisionMap.hpp"
+#include "../units.hpp"
+#include "../primitives/Box2.hpp"
+
+// Bounding volume hierarchy of axis-aligned boxes, balanced incrementally as collidables are added and removed.
+// Leaves store "fat" boxes: a collidable's bounding box grown by a margin, so small movements don't require changing the tree.
+// The map does not own its collidables: they must outlive the map, or be removed from it first.
+// Queries keep no state in the map, so they can run concurrently while the map isn't being changed.
+namespace ctp {
+class DynamicTreeCollisionMap : public CollisionMap {
+public:
+	static const gFloat DEFAULT_MARGIN;
+
+	DynamicTreeCollisionMap() = default;
+	// Margin is how far to grow each collidable's bounding box on every side.
+	explicit DynamicTreeCollisionMap(gFloat margin) : margin_(margin) {}
+
+	using CollisionMap::getColliding;
+	const std::vector<Collidable*> getColliding(const Collidable& collider, Coord2 delta) const override;
+	const std::vector<Collidable*> getColliding(const Collidable& collider, Coord2 position, Coord2 delta) const override;
+	void getColliding(const Collidable& collider, Coord2 position, Coord2 delta, std::vector<Collidable*>& colliding) const override;
+	// Visits nodes nearest to the ray first, skipping any farther away than the closest hit found so far.
+	RaycastHit raycast(const Ray& ray, gFloat maxT) const override;
+
+	// Add a collidable to the map. NOOP if it is already in the map.
+	void insert(Collidable* collidable);
+	// Remove a collidable from the map. NOOP if it isn't in the map.
+	void remove(const Collidable* collidable);
+	// Update the collidable's place in the tree after it has moved or changed shape.
+	// Inserts the collidable if it isn't in the map.
+	// Returns true if the collidable was reinserted, or false if it is still inside its fat box.
+	bool update(Collidable* collidable);
+	void clear();
+
+	bool contains(const Collidable* collidable) const { return leaves_.find(collidable) != leaves_.end(); }
+	// Get the number of collidables in the map.
+	std::size_t size() const noexcept { return leaves_.size(); }
+	// Get the height of the tree. An empty tree has height 0, and a tree with only one collidable has height 1.
+	int height() const noexcept { return root_ == NULL_NODE ? 0 : nodes_[root_].height + 1; }
+	gFloat margin() const noexcept { return margin_; }
+
+private:
+	static constexpr int NULL_NODE = -1;
+	struct Node {
+		Box2<gFloat> aabb;               // Fat box for leaves, union of children for branches.
+		Collidable* collidable{nullptr}; // Only set for leaves.
+		int parent{NULL_NODE};           // Next free node, when in the free list.
+		int left{NULL_NODE};
+		int right{NULL_NODE};
+		int height{0};                   // Leaves have height 0. Free nodes have height -1.
+		bool isLeaf() const noexcept { return left == NULL_NODE; }
+	};
+
+	int _allocate_node();
+	void _free_node(int node);
+	void _insert_leaf(int leaf);
+	void _remove_leaf(int leaf);
+	// Perform a rotation if the subtree at the given node is unbalanced. Returns the new root of the subtree.
+	int _balance(int node);
+	// Refit boxes and heights from the given node to the root, rebalancing along the way.
+	void _refit(int node);
+
+	gFloat margin_{DEFAULT_MARGIN};
+	int root_{NULL_NODE};
+	int free_list_{NULL_NODE};
+	std::vector<Node> nodes_;
+	std::unordered_map<const Collidable*, int> leaves_;
+};
+}
+#endif // INCLUDE_GEOM_DYNAMIC_TREE_COLLISION_MAP_HPP
@@ -0,0 +1,167 @@
+#include "GridCollisionMap.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+#include "Collidable.hpp"
+#include "broadphase.hpp"
+#include "../debug_logger.hpp"
+#include "../units.hpp"
+#include "../math.hpp"
+
+namespace ctp {
+
+namespace {
+// Most cells a grid has along an axis: as many as a float counts exactly, so counts convert to int safely.
+constexpr int MAX_CELLS_PER_AXIS = 1 << 24;
+
+// Check the cell size before anything divides by it. A size that isn't positive and finite gives one cell for the bounds.
+gFloat _checked_cell_size(Rect bounds, gFloat cellSize) {
+	const bool isValid(cellSize > 0 && std::isfinite(cellSize));
+	DBG_CHECK(!isValid, "ERR", "GridCollisionMap cell size must be positive and finite. Given: " << cellSize);
+	return isValid ? cellSize : std::max({bounds.w, bounds.h, gFloat(1)});
+}
+
+// Get the number of cells that cover an extent, at least one.
+int _cell_count(gFloat extent, gFloat cellSize) noexcept {
+	const gFloat count(std::ceil(extent / cellSize));
+	if (!(count > 1)) // Also catches NaN.
+		return 1;
+	return count < static_cast<gFloat>(MAX_CELLS_PER_AXIS) ? static_cast<int>(count) : MAX_CELLS_PER_AXIS;
+}
+
+// Get the cell an offset from the grid's edge is in. Clamps in floating point before converting, so offsets that are far
+// outside of the grid, infinite, or NaN give an edge cell rather than overflowing.
+int _to_cell(gFloat offset, gFloat cellSize, int count) noexcept {
+	const gFloat cell(std::floor(offset / cellSize));
+	if (!(cell > 0)) // Also catches NaN.
+		return 0;
+	return cell < static_cast<gFloat>(count - 1) ? static_cast<int>(cell) : count - 1;
+}
+}
+
+GridCollisionMap::GridCollisionMap(Rect bounds, gFloat cellSize)
+	: bounds_(bounds)
+	, cell_size_(_checked_cell_size(bounds, cellSize))
+	, columns_(_cell_count(bounds.w, cell_size_))
+	, rows_(_cell_count(bounds.h, cell_size_))
+	, cells_(static_cast<std::size_t>(columns_) * rows_) {}
+
+const std::vector<Collidable*> GridCollisionMap::getColliding(const Collidable& collider, Coord2 delta) const {
+	return getColliding(collider, collider.getPosition(), delta);
+}
+
+const std::vector<Collidable*> GridCollisionMap::getColliding(const Collidable& collider, Coord2 position, Coord2 delta) const {
+	std::vector<Collidable*> colliding;
+	getColliding(collider, position, delta, colliding);
+	return colliding;
+}
+
+void GridCollisionMap::getColliding(const Collidable& collider, Coord2 position, Coord2 delta, std::vector<Collidable*>& colliding) const {
+	colliding.clear();
+	const Box2<int> range(_get_cells(broadphase::sweep(broadphase::getAABB(collider, position), delta)));
+	for (int y = range.top(); y <= range.bottom(); ++y) {
+		for (int x = range.left(); x <= range.right(); ++x) {
+			for (const std::size_t entry : _cell(x, y)) {
+				if (broadphase::isFirstSharedCell(x, y, entries_[entry].cells, range) && entries_[entry].collidable != &collider)
+					colliding.push_back(entries_[entry].collidable);
+			}
+		}
+	}
+}
+
+void GridCollisionMap::insert(Collidable* collidable) {
+	if (contains(collidable))
+		return;
+	std::size_t entry;
+	if (free_entries_.empty()) {
+		entry = entries_.size();
+		entries_.emplace_back();
+	} else {
+		entry = free_entries_.back();
+		free_entries_.pop_back();
+	}
+	entries_[entry].collidable = collidable;
+	entries_[entry].cells = _get_cells(*collidable);
+	indices_.emplace(collidable, entry);
+	_add_to_cells(entry, entries_[entry].cells);
+}
+
+void GridCollisionMap::remove(const Collidable* collidable) {
+	const auto it = indices_.find(collidable);
+	if (it == indices_.end())
+		return;
+	const std::size_t entry = it->second;
+	_remove_from_cells(entry, entries_[entry].cells);
+	entries_[entry].collidable = nullptr;
+	free_entries_.push_back(entry);
+	indices_.erase(it);
+}
+
+void GridCollisionMap::update(Collidable* collidable) {
+	const auto it = indices_.find(collidable);
+	if (it == indices_.end()) {
+		insert(collidable);
+		return;
+	}
+	const std::size_t entry = it->second;
+	const Box2<int> newCells(_get_cells(*collidable));
+	const Box2<int> oldCells(entries_[entry].cells);
+	if (newCells == oldCells)
+		return; // Still in the same cells.
+	// Only touch cells whose membership changed.
+	for (int y = oldCells.top(); y <= oldCells.bottom(); ++y) {
+		for (int x = oldCells.left(); x <= oldCells.right(); ++x) {
+			if (!math::isBetween(x, newCells.left(), newCells.right()) || !math::isBetween(y, newCells.top(), newCells.bottom()))
+				_remove_from_cell(_cell(x, y), entry);
+		}
+	}
+	for (int y = newCells.top(); y <= newCells.bottom(); ++y) {
+		for (int x = newCells.left(); x <= newCells.right(); ++x) {
+			if (!math::isBetween(x, oldCells.left(), oldCells.right()) || !math::isBetween(y, oldCells.top(), oldCells.bottom()))
+				_cell(x, y).push_back(entry);
+		}
+	}
+	entries_[entry].cells = newCells;
+}
+
+void GridCollisionMap::clear() {
+	for (auto& cell : cells_)
+		cell.clear();
+	entries_.clear();
+	free_entries_.clear();
+	indices_.clear();
+}
+
+Box2<int> GridCollisionMap::_get_cells(const Box2<gFloat>& aabb) const noexcept {
+	const int left   = _to_cell(aabb.left()   - bounds_.left(), cell_size_, columns_);
+	const int right  = _to_cell(aabb.right()  - bounds_.left(), cell_size_, columns_);
+	const int top    = _to_cell(aabb.top()    - bounds_.top(),  cell_size_, rows_);
+	const int bottom = _to_cell(aabb.bottom() - bounds_.top(),  cell_size_, rows_);
+	// Use w and h as the inclusive right/bottom cell offsets, so Box2's right() and bottom() give the last cell.
+	return Box2<int>(left, top, right - left, bottom - top);
+}
+
+Box2<int> GridCollisionMap::_get_cells(const Collidable& collidable) const {
+	return _get_cells(broadphase::getAABB(collidable));
+}
+
+void GridCollisionMap::_add_to_cells(std::size_t entry, const Box2<int>& cells) {
+	for (int y = cells.top(); y <= cells.bottom(); ++y)
+		for (int x = cells.left(); x <= cells.right(); ++x)
+			_cell(x, y).push_back(entry);
+}
+
+void GridCollisionMap::_remove_from_cells(std::size_t entry, const Box2<int>& cells) {
+	for (int y = cells.top(); y <= cells.bottom(); ++y) {
+		for (int x = cells.left(); x <= cells.right(); ++x)
+			_remove_from_cell(_cell(x, y), entry);
+	}
+}
+
+void GridCollisionMap::_remove_from_cell(std::vector<std::size_t>& cell, std::size_t entry) {
+	const auto it = std::find(cell.begin(), cell.end(), entry);
+	*it = cell.back(); // Order in a cell doesn't matter: swap and pop.
+	cell.pop_back();
+}
+}
@@ -0,0 +1,70 @@
+#ifndef INCLUDE_GEOM_GRID_COLLISION_MAP_HPP
+#define INCLUDE_GEOM_GRID_COLLISION_MAP_HPP
+
+#include <cstddef>
+#include <unordered_map>
+#include <vector>
+
+#include "CollisionMap.hpp"
+#include "../units.hpp"
+#include "../primitives/Box2.hpp"
+#include "../shapes/Rectangle.hpp"
+
+// Uniform grid of buckets over a bounded region of the world.
+// Collidables are added to every cell their world AABB touches. A query only takes a collidable from the first cell it shares
+// with it, so each is found once without any state per query, and queries can run concurrently.
+// Collidables outside of the bounds are clamped to the edge cells.
+// The map does not own its collidables: they must outlive the map, or be removed from it first.
+namespace ctp {
+class GridCollisionMap : public CollisionMap {
+public:
+	GridCollisionMap() = delete;
+	// Bounds is the region of the world to divide into square cells of the given size.
+	GridCollisionMap(Rect bounds, gFloat cellSize);
+
+	using CollisionMap::getColliding;
+	const std::vector<Collidable*> getColliding(const Collidable& collider, Coord2 delta) const override;
+	const std::vector<Collidable*> getColliding(const Collidable& collider, Coord2 position, Coord2 delta) const override;
+	void getColliding(const Collidable& collider, Coord2 position, Coord2 delta, std::vector<Collidable*>& colliding) const override;
+
+	// Add a collidable to the map. NOOP if it is already in the map.
+	void insert(Collidable* collidable);
+	// Remove a collidable from the map. NOOP if it isn't in the map.
+	void remove(const Collidable* collidable);
+	// Update which cells a collidable belongs to, after it has moved or changed shape.
+	// Inserts the collidable if it isn't in the map.
+	void update(Collidable* collidable);
+	void clear();
+
+	bool contains(const Collidable* collidable) const { return indices_.find(collidable) != indices_.end(); }
+	// Get the number of collidables in the map.
+	std::size_t size() const noexcept { return indices_.size(); }
+
+	const Rect& bounds() const noexcept { return bounds_; }
+	gFloat cellSize() const noexcept { return cell_size_; }
+
+private:
+	struct Entry {
+		Collidable* collidable{nullptr};
+		Box2<int> cells; // Inclusive range of cells the collidable is in.
+	};
+	// Get the inclusive range of cells covered by a world-space bounding box.
+	Box2<int> _get_cells(const Box2<gFloat>& aabb) const noexcept;
+	Box2<int> _get_cells(const Collidable& collidable) const;
+	void _add_to_cells(std::size_t entry, const Box2<int>& cells);
+	void _remove_from_cells(std::size_t entry, const Box2<int>& cells);
+	static void _remove_from_cell(std::vector<std::size_t>& cell, std::size_t entry);
+	std::vector<std::size_t>& _cell(int x, int y) noexcept { return cells_[y * columns_ + x]; }
+	const std::vector<std::size_t>& _cell(int x, int y) const noexcept { return cells_[y * columns_ + x]; }
+
+	Rect bounds_;
+	gFloat cell_size_;
+	int columns_;
+	int rows_;
+	std::vector<std::vector<std::size_t>> cells_; // Indices into entries_.
+	std::vector<Entry> entries_;
+	std::vector<std::size_t> free_entries_; // Removed entries available for reuse.
+	std::unordered_map<const Collidable*, std::size_t> indices_;
+};
+}
+#endif // INCLUDE_GEOM_GRID_COLLISION_MAP_HPP
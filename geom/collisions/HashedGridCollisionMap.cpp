@@ -0,0 +1,248 @@
+#include "HashedGridCollisionMap.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+
+#include "Collidable.hpp"
+#include "broadphase.hpp"
+#include "../debug_logger.hpp"
+#include "../units.hpp"
+#include "../math.hpp"
+
+namespace ctp {
+
+namespace {
+constexpr std::size_t INITIAL_SLOTS = 64;
+// Cell coordinates are clamped to this magnitude, so spans between them always fit in an int.
+constexpr int MAX_CELL = 1 << 24;
+
+// Get the cell a coordinate is in. Clamps in floating point before converting, so coordinates that are very far away,
+// infinite, or NaN give a cell at the edge of the range rather than overflowing.
+int _to_cell(gFloat coordinate, gFloat cellSize) noexcept {
+	const gFloat cell(std::floor(coordinate / cellSize));
+	if (std::isnan(cell))
+		return 0;
+	return static_cast<int>(std::clamp(cell, -static_cast<gFloat>(MAX_CELL), static_cast<gFloat>(MAX_CELL)));
+}
+
+inline bool _is_in(int x, int y, const Box2<int>& cells) noexcept {
+	return math::isBetween(x, cells.left(), cells.right()) && math::isBetween(y, cells.top(), cells.bottom());
+}
+}
+
+HashedGridCollisionMap::HashedGridCollisionMap(gFloat cellSize) : cell_size_(cellSize), slots_(INITIAL_SLOTS) {
+	DBG_CHECK(cellSize <= 0, "ERR", "HashedGridCollisionMap cell size must be positive. Given: " << cellSize);
+}
+
+const std::vector<Collidable*> HashedGridCollisionMap::getColliding(const Collidable& collider, Coord2 delta) const {
+	return getColliding(collider, collider.getPosition(), delta);
+}
+
+const std::vector<Collidable*> HashedGridCollisionMap::getColliding(const Collidable& collider, Coord2 position, Coord2 delta) const {
+	std::vector<Collidable*> colliding;
+	getColliding(collider, position, delta, colliding);
+	return colliding;
+}
+
+void HashedGridCollisionMap::getColliding(const Collidable& collider, Coord2 position, Coord2 delta, std::vector<Collidable*>& colliding) const {
+	colliding.clear();
+	if (cell_count_ == 0)
+		return;
+	const Box2<int> range(_get_cells(broadphase::sweep(broadphase::getAABB(collider, position), delta)));
+	const std::int64_t rangeCells((static_cast<std::int64_t>(range.w) + 1) * (static_cast<std::int64_t>(range.h) + 1));
+	if (rangeCells > static_cast<std::int64_t>(slots_.size())) {
+		// A long sweep covers more cells than the table has: scanning the table is cheaper than looking each one up.
+		for (const Slot& slot : slots_) {
+			if (!slot.isEmpty() && _is_in(slot.x, slot.y, range))
+				_collect(slot, range, collider, colliding);
+		}
+		return;
+	}
+	for (int y = range.top(); y <= range.bottom(); ++y) {
+		for (int x = range.left(); x <= range.right(); ++x) {
+			const Slot& slot = slots_[_find_slot(x, y)];
+			if (!slot.isEmpty())
+				_collect(slot, range, collider, colliding);
+		}
+	}
+}
+
+void HashedGridCollisionMap::insert(Collidable* collidable) {
+	if (contains(collidable))
+		return;
+	std::size_t entry;
+	if (free_entries_.empty()) {
+		entry = entries_.size();
+		entries_.emplace_back();
+	} else {
+		entry = free_entries_.back();
+		free_entries_.pop_back();
+	}
+	entries_[entry].collidable = collidable;
+	entries_[entry].cells = _get_cells(*collidable);
+	indices_.emplace(collidable, entry);
+	_add_to_cells(entry, entries_[entry].cells);
+}
+
+void HashedGridCollisionMap::remove(const Collidable* collidable) {
+	const auto it = indices_.find(collidable);
+	if (it == indices_.end())
+		return;
+	const std::size_t entry = it->second;
+	_remove_from_cells(entry, entries_[entry].cells);
+	entries_[entry].collidable = nullptr;
+	free_entries_.push_back(entry);
+	indices_.erase(it);
+}
+
+void HashedGridCollisionMap::update(Collidable* collidable) {
+	const auto it = indices_.find(collidable);
+	if (it == indices_.end()) {
+		insert(collidable);
+		return;
+	}
+	const std::size_t entry = it->second;
+	const Box2<int> newCells(_get_cells(*collidable));
+	const Box2<int> oldCells(entries_[entry].cells);
+	if (newCells == oldCells)
+		return; // Still in the same cells.
+	// Only touch cells whose membership changed.
+	for (int y = oldCells.top(); y <= oldCells.bottom(); ++y) {
+		for (int x = oldCells.left(); x <= oldCells.right(); ++x) {
+			if (!_is_in(x, y, newCells))
+				_remove_from_cell(x, y, entry);
+		}
+	}
+	for (int y = newCells.top(); y <= newCells.bottom(); ++y) {
+		for (int x = newCells.left(); x <= newCells.right(); ++x) {
+			if (!_is_in(x, y, oldCells))
+				_add_to_cell(x, y, entry);
+		}
+	}
+	entries_[entry].cells = newCells;
+}
+
+void HashedGridCollisionMap::clear() {
+	std::fill(slots_.begin(), slots_.end(), Slot());
+	cell_count_ = 0;
+	links_.clear();
+	free_links_ = NULL_LINK;
+	entries_.clear();
+	free_entries_.clear();
+	indices_.clear();
+}
+
+Box2<int> HashedGridCollisionMap::_get_cells(const Box2<gFloat>& aabb) const noexcept {
+	const int left   = _to_cell(aabb.left(),   cell_size_);
+	const int right  = _to_cell(aabb.right(),  cell_size_);
+	const int top    = _to_cell(aabb.top(),    cell_size_);
+	const int bottom = _to_cell(aabb.bottom(), cell_size_);
+	// Use w and h as the inclusive right/bottom cell offsets, so Box2's right() and bottom() give the last cell.
+	return Box2<int>(left, top, right - left, bottom - top);
+}
+
+Box2<int> HashedGridCollisionMap::_get_cells(const Collidable& collidable) const {
+	return _get_cells(broadphase::getAABB(collidable));
+}
+
+std::size_t HashedGridCollisionMap::_home_slot(int x, int y) const noexcept {
+	// Fibonacci hashing of both coordinates packed together. The table size is a power of two, so mask the high bits.
+	const std::uint64_t key((static_cast<std::uint64_t>(static_cast<std::uint32_t>(x)) << 32) | static_cast<std::uint32_t>(y));
+	return static_cast<std::size_t>((key * 0x9E3779B97F4A7C15ull) >> 32) & (slots_.size() - 1);
+}
+
+std::size_t HashedGridCollisionMap::_find_slot(int x, int y) const noexcept {
+	const std::size_t mask(slots_.size() - 1);
+	std::size_t slot(_home_slot(x, y));
+	// The table is never full, so probing always ends.
+	while (!slots_[slot].isEmpty() && (slots_[slot].x != x || slots_[slot].y != y))
+		slot = (slot + 1) & mask;
+	return slot;
+}
+
+void HashedGridCollisionMap::_add_to_cells(std::size_t entry, const Box2<int>& cells) {
+	for (int y = cells.top(); y <= cells.bottom(); ++y)
+		for (int x = cells.left(); x <= cells.right(); ++x)
+			_add_to_cell(x, y, entry);
+}
+
+void HashedGridCollisionMap::_remove_from_cells(std::size_t entry, const Box2<int>& cells) {
+	for (int y = cells.top(); y <= cells.bottom(); ++y) {
+		for (int x = cells.left(); x <= cells.right(); ++x)
+			_remove_from_cell(x, y, entry);
+	}
+}
+
+void HashedGridCollisionMap::_add_to_cell(int x, int y, std::size_t entry) {
+	std::size_t index(_find_slot(x, y));
+	// Only a new cell can push the load factor over one half, so probe sequences stay short.
+	if (slots_[index].isEmpty() && 2 * (cell_count_ + 1) > slots_.size()) {
+		_grow();
+		index = _find_slot(x, y);
+	}
+	int link;
+	if (free_links_ == NULL_LINK) {
+		link = static_cast<int>(links_.size());
+		links_.emplace_back();
+	} else {
+		link = free_links_;
+		free_links_ = links_[link].next;
+	}
+	Slot& slot = slots_[index];
+	if (slot.isEmpty()) {
+		slot.x = x;
+		slot.y = y;
+		++cell_count_;
+	}
+	links_[link].entry = entry;
+	links_[link].next = slot.head;
+	slot.head = link;
+}
+
+void HashedGridCollisionMap::_remove_from_cell(int x, int y, std::size_t entry) {
+	const std::size_t slot(_find_slot(x, y));
+	int* link = &slots_[slot].head;
+	while (links_[*link].entry != entry)
+		link = &links_[*link].next;
+	const int removed = *link;
+	*link = links_[removed].next;
+	links_[removed].next = free_links_;
+	free_links_ = removed;
+	if (slots_[slot].isEmpty()) {
+		--cell_count_;
+		_erase_slot(slot);
+	}
+}
+
+void HashedGridCollisionMap::_erase_slot(std::size_t slot) noexcept {
+	const std::size_t mask(slots_.size() - 1);
+	std::size_t hole(slot);
+	for (std::size_t next = (hole + 1) & mask; !slots_[next].isEmpty(); next = (next + 1) & mask) {
+		// A slot can fill the hole if its home isn't cyclically between the hole and itself.
+		const std::size_t home(_home_slot(slots_[next].x, slots_[next].y));
+		if (((next - home) & mask) >= ((next - hole) & mask)) {
+			slots_[hole] = slots_[next];
+			hole = next;
+		}
+	}
+	slots_[hole] = Slot();
+}
+
+void HashedGridCollisionMap::_grow() {
+	std::vector<Slot> old(slots_.size() * 2);
+	old.swap(slots_);
+	for (const Slot& slot : old) {
+		if (!slot.isEmpty())
+			slots_[_find_slot(slot.x, slot.y)] = slot;
+	}
+}
+
+void HashedGridCollisionMap::_collect(const Slot& slot, const Box2<int>& range, const Collidable& collider, std::vector<Collidable*>& colliding) const {
+	for (int link = slot.head; link != NULL_LINK; link = links_[link].next) {
+		const std::size_t entry(links_[link].entry);
+		if (broadphase::isFirstSharedCell(slot.x, slot.y, entries_[entry].cells, range) && entries_[entry].collidable != &collider)
+			colliding.push_back(entries_[entry].collidable);
+	}
+}
+}
@@ -0,0 +1,92 @@
+#ifndef INCLUDE_GEOM_HASHED_GRID_COLLISION_MAP_HPP
+#define INCLUDE_GEOM_HASHED_GRID_COLLISION_MAP_HPP
+
+#include <cstddef>
+#include <unordered_map>
+#include <vector>
+
+#include "CollisionMap.hpp"
+#include "../units.hpp"
+#include "../primitives/Box2.hpp"
+
+// Unbounded uniform grid that only stores the cells collidables are in.
+// Cells are found by their integer coordinates in an open addressing hash table. A cell is a linked list of links from a
+// shared pool, so no cell allocates memory of its own, and empty space costs nothing.
+// Collidables are added to every cell their world AABB touches. A query only takes a collidable from the first cell it shares
+// with it, so each is found once without any state per query, and queries can run concurrently.
+// The map does not own its collidables: they must outlive the map, or be removed from it first.
+namespace ctp {
+class HashedGridCollisionMap : public CollisionMap {
+public:
+	HashedGridCollisionMap() = delete;
+	// Divide the world into square cells of the given size.
+	explicit HashedGridCollisionMap(gFloat cellSize);
+
+	using CollisionMap::getColliding;
+	const std::vector<Collidable*> getColliding(const Collidable& collider, Coord2 delta) const override;
+	const std::vector<Collidable*> getColliding(const Collidable& collider, Coord2 position, Coord2 delta) const override;
+	void getColliding(const Collidable& collider, Coord2 position, Coord2 delta, std::vector<Collidable*>& colliding) const override;
+
+	// Add a collidable to the map. NOOP if it is already in the map.
+	void insert(Collidable* collidable);
+	// Remove a collidable from the map. NOOP if it isn't in the map.
+	void remove(const Collidable* collidable);
+	// Update which cells a collidable belongs to, after it has moved or changed shape.
+	// Inserts the collidable if it isn't in the map.
+	void update(Collidable* collidable);
+	void clear();
+
+	bool contains(const Collidable* collidable) const { return indices_.find(collidable) != indices_.end(); }
+	// Get the number of collidables in the map.
+	std::size_t size() const noexcept { return indices_.size(); }
+	// Get the number of cells that have at least one collidable in them.
+	std::size_t cellCount() const noexcept { return cell_count_; }
+
+	gFloat cellSize() const noexcept { return cell_size_; }
+
+private:
+	static constexpr int NULL_LINK = -1;
+	struct Entry {
+		Collidable* collidable{nullptr};
+		Box2<int> cells; // Inclusive range of cells the collidable is in.
+	};
+	// One collidable's membership in one cell.
+	struct Link {
+		std::size_t entry{0};
+		int next{NULL_LINK}; // Next link in the cell, or in the free list.
+	};
+	// A cell in the hash table. Slots without links are empty.
+	struct Slot {
+		int x{0};
+		int y{0};
+		int head{NULL_LINK};
+		bool isEmpty() const noexcept { return head == NULL_LINK; }
+	};
+	// Get the inclusive range of cells covered by a world-space bounding box.
+	Box2<int> _get_cells(const Box2<gFloat>& aabb) const noexcept;
+	Box2<int> _get_cells(const Collidable& collidable) const;
+	std::size_t _home_slot(int x, int y) const noexcept;
+	// Get the slot of a cell, or the empty slot it would go in.
+	std::size_t _find_slot(int x, int y) const noexcept;
+	void _add_to_cells(std::size_t entry, const Box2<int>& cells);
+	void _remove_from_cells(std::size_t entry, const Box2<int>& cells);
+	void _add_to_cell(int x, int y, std::size_t entry);
+	void _remove_from_cell(int x, int y, std::size_t entry);
+	// Empty a slot, shifting back any slots that probed past it so lookups don't stop early.
+	void _erase_slot(std::size_t slot) noexcept;
+	// Double the hash table's capacity.
+	void _grow();
+	// Collect the collidables in a cell that it's the first cell of range for.
+	void _collect(const Slot& slot, const Box2<int>& range, const Collidable& collider, std::vector<Collidable*>& colliding) const;
+
+	gFloat cell_size_;
+	std::vector<Slot> slots_; // Capacity is always a power of two.
+	std::size_t cell_count_{0};
+	std::vector<Link> links_;
+	int free_links_{NULL_LINK};
+	std::vector<Entry> entries_;
+	std::vector<std::size_t> free_entries_; // Removed entries available for reuse.
+	std::unordered_map<const Collidable*, std::size_t> indices_;
+};
+}
+#endif // INCLUDE_GEOM_HASHED_GRID_COLLISION_MAP_HPP
@@ -0,0 +1,170 @@
+#include "LooseQuadtreeCollisionMap.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+#include "Collidable.hpp"
+#include "broadphase.hpp"
+#include "../debug_logger.hpp"
+#include "../units.hpp"
+
+namespace ctp {
+
+const int LooseQuadtreeCollisionMap::DEFAULT_MAX_DEPTH = 8;
+const gFloat LooseQuadtreeCollisionMap::LOOSENESS = 2.0f;
+
+namespace {
+// Get a node's loose bounds: its bounds grown around its center.
+inline broadphase::AABB _loosen(const broadphase::AABB& bounds) noexcept {
+	return broadphase::fatten(bounds, bounds.w * (LooseQuadtreeCollisionMap::LOOSENESS - 1) * 0.5f);
+}
+}
+
+LooseQuadtreeCollisionMap::LooseQuadtreeCollisionMap(Rect bounds, int maxDepth, gFloat minSize) : max_depth_(maxDepth) {
+	DBG_CHECK(maxDepth < 0, "ERR", "LooseQuadtreeCollisionMap max depth can't be negative. Given: " << maxDepth);
+	// Nodes are square, so the root covers the larger dimension.
+	const gFloat size(std::max(bounds.w, bounds.h));
+	if (minSize > 0 && size > minSize)
+		max_depth_ = std::min(max_depth_, static_cast<int>(std::log2(size / minSize)));
+	else if (minSize > 0)
+		max_depth_ = 0;
+	nodes_.emplace_back();
+	nodes_[0].bounds = Box2<gFloat>(bounds.x, bounds.y, size, size);
+}
+
+const std::vector<Collidable*> LooseQuadtreeCollisionMap::getColliding(const Collidable& collider, Coord2 delta) const {
+	return getColliding(collider, collider.getPosition(), delta);
+}
+
+const std::vector<Collidable*> LooseQuadtreeCollisionMap::getColliding(const Collidable& collider, Coord2 position, Coord2 delta) const {
+	std::vector<Collidable*> colliding;
+	getColliding(collider, position, delta, colliding);
+	return colliding;
+}
+
+void LooseQuadtreeCollisionMap::getColliding(const Collidable& collider, Coord2 position, Coord2 delta, std::vector<Collidable*>& colliding) const {
+	colliding.clear();
+	const broadphase::AABB query(broadphase::sweep(broadphase::getAABB(collider, position), delta));
+	broadphase::NodeStack stack;
+	stack.push_back(0);
+	while (!stack.empty()) {
+		const Node& node = nodes_[stack.back()];
+		stack.pop_back();
+		// The root also holds collidables outside of the bounds, so it is always searched.
+		if (node.depth > 0 && !broadphase::overlaps(_loosen(node.bounds), query))
+			continue;
+		for (const std::size_t entry : node.entries) {
+			if (entries_[entry].collidable != &collider && broadphase::overlaps(entries_[entry].aabb, query))
+				colliding.push_back(entries_[entry].collidable);
+		}
+		for (const int child : node.children) {
+			if (child != NULL_NODE)
+				stack.push_back(child);
+		}
+	}
+}
+
+void LooseQuadtreeCollisionMap::build(const std::vector<Collidable*>& collidables) {
+	clear();
+	entries_.reserve(collidables.size());
+	indices_.reserve(collidables.size());
+	for (Collidable* collidable : collidables)
+		insert(collidable);
+}
+
+void LooseQuadtreeCollisionMap::insert(Collidable* collidable) {
+	if (contains(collidable))
+		return;
+	std::size_t entry;
+	if (free_entries_.empty()) {
+		entry = entries_.size();
+		entries_.emplace_back();
+	} else {
+		entry = free_entries_.back();
+		free_entries_.pop_back();
+	}
+	entries_[entry].collidable = collidable;
+	entries_[entry].aabb = broadphase::getAABB(*collidable);
+	indices_.emplace(collidable, entry);
+	_add_to_node(entry, _find_node(entries_[entry].aabb));
+}
+
+void LooseQuadtreeCollisionMap::remove(const Collidable* collidable) {
+	const auto it = indices_.find(collidable);
+	if (it == indices_.end())
+		return;
+	_remove_from_node(it->second);
+	entries_[it->second].collidable = nullptr;
+	free_entries_.push_back(it->second);
+	indices_.erase(it);
+}
+
+void LooseQuadtreeCollisionMap::update(Collidable* collidable) {
+	const auto it = indices_.find(collidable);
+	if (it == indices_.end()) {
+		insert(collidable);
+		return;
+	}
+	Entry& entry = entries_[it->second];
+	entry.aabb = broadphase::getAABB(*collidable);
+	const int node = _find_node(entry.aabb);
+	if (node == entry.node)
+		return; // Still fits in the same node.
+	_remove_from_node(it->second);
+	_add_to_node(it->second, node);
+}
+
+void LooseQuadtreeCollisionMap::clear() {
+	nodes_.resize(1);
+	nodes_[0].children.fill(NULL_NODE);
+	nodes_[0].entries.clear();
+	entries_.clear();
+	free_entries_.clear();
+	indices_.clear();
+}
+
+int LooseQuadtreeCollisionMap::getDepth(const Collidable* collidable) const {
+	const auto it = indices_.find(collidable);
+	return it == indices_.end() ? -1 : nodes_[entries_[it->second].node].depth;
+}
+
+int LooseQuadtreeCollisionMap::_find_node(const Box2<gFloat>& aabb) {
+	const Coord2 center(aabb.x + aabb.w * 0.5f, aabb.y + aabb.h * 0.5f);
+	const gFloat size(std::max(aabb.w, aabb.h));
+	const Box2<gFloat>& rootBounds(nodes_[0].bounds);
+	if (center.x < rootBounds.left() || center.x >= rootBounds.right() || center.y < rootBounds.top() || center.y >= rootBounds.bottom())
+		return 0; // Outside of the tree.
+	int node = 0;
+	while (nodes_[node].depth < max_depth_) {
+		const Box2<gFloat> bounds(nodes_[node].bounds);
+		const gFloat childSize(bounds.w * 0.5f);
+		if (size > childSize * (LOOSENESS - 1))
+			break; // Too big for the loose bounds of a child.
+		const bool isRight(center.x >= bounds.x + childSize);
+		const bool isBottom(center.y >= bounds.y + childSize);
+		const std::size_t quadrant = (isBottom ? 2 : 0) + (isRight ? 1 : 0);
+		if (nodes_[node].children[quadrant] == NULL_NODE) {
+			const int child = static_cast<int>(nodes_.size());
+			nodes_.emplace_back(); // Invalidates references to nodes.
+			nodes_[child].bounds = Box2<gFloat>(bounds.x + (isRight ? childSize : 0), bounds.y + (isBottom ? childSize : 0), childSize, childSize);
+			nodes_[child].depth = nodes_[node].depth + 1;
+			nodes_[node].children[quadrant] = child;
+		}
+		node = nodes_[node].children[quadrant];
+	}
+	return node;
+}
+
+void LooseQuadtreeCollisionMap::_add_to_node(std::size_t entry, int node) {
+	nodes_[node].entries.push_back(entry);
+	entries_[entry].node = node;
+}
+
+void LooseQuadtreeCollisionMap::_remove_from_node(std::size_t entry) {
+	auto& nodeEntries = nodes_[entries_[entry].node].entries;
+	const auto it = std::find(nodeEntries.begin(), nodeEntries.end(), entry);
+	*it = nodeEntries.back(); // Order in a node doesn't matter: swap and pop.
+	nodeEntries.pop_back();
+	entries_[entry].node = NULL_NODE;
+}
+}
@@ -0,0 +1,80 @@
+#ifndef INCLUDE_GEOM_LOOSE_QUADTREE_COLLISION_MAP_HPP
+#define INCLUDE_GEOM_LOOSE_QUADTREE_COLLISION_MAP_HPP
+
+#include <array>
+#include <cstddef>
+#include <unordered_map>
+#include <vector>
+
+#include "CollisionMap.hpp"
+#include "../units.hpp"
+#include "../primitives/Box2.hpp"
+#include "../shapes/Rectangle.hpp"
+
+// Quadtree whose nodes' bounds are loosened (grown around their centers), so every collidable fits in exactly one node.
+// Collidables are placed by the center and size of their bounding box: the deepest node that is big enough for the box,
+// and contains its center. Inserting and removing never splits a collidable across nodes, and is O(depth).
+// Nodes are created as they are needed. Collidables whose centers are outside of the bounds are kept in the root.
+// The map does not own its collidables: they must outlive the map, or be removed from it first.
+// Queries keep no state in the map, so they can run concurrently while the map isn't being changed.
+namespace ctp {
+class LooseQuadtreeCollisionMap : public CollisionMap {
+public:
+	static const int DEFAULT_MAX_DEPTH;
+	// How much bigger a node's loose bounds are than its regular bounds.
+	static const gFloat LOOSENESS;
+
+	LooseQuadtreeCollisionMap() = delete;
+	// Bounds is the region of the world to subdivide. Nodes aren't subdivided past maxDepth, or to be smaller than minSize.
+	LooseQuadtreeCollisionMap(Rect bounds, int maxDepth = DEFAULT_MAX_DEPTH, gFloat minSize = 0);
+
+	using CollisionMap::getColliding;
+	const std::vector<Collidable*> getColliding(const Collidable& collider, Coord2 delta) const override;
+	const std::vector<Collidable*> getColliding(const Collidable& collider, Coord2 position, Coord2 delta) const override;
+	void getColliding(const Collidable& collider, Coord2 position, Coord2 delta, std::vector<Collidable*>& colliding) const override;
+
+	// Replace the contents of the map with the given collidables.
+	void build(const std::vector<Collidable*>& collidables);
+	// Add a collidable to the map. NOOP if it is already in the map.
+	void insert(Collidable* collidable);
+	// Remove a collidable from the map. NOOP if it isn't in the map.
+	void remove(const Collidable* collidable);
+	// Update which node a collidable belongs to, after it has moved or changed shape.
+	// Inserts the collidable if it isn't in the map.
+	void update(Collidable* collidable);
+	void clear();
+
+	bool contains(const Collidable* collidable) const { return indices_.find(collidable) != indices_.end(); }
+	// Get the number of collidables in the map.
+	std::size_t size() const noexcept { return indices_.size(); }
+	// Get the depth of the node a collidable is in (root is depth 0), or -1 if it isn't in the map.
+	int getDepth(const Collidable* collidable) const;
+
+	int maxDepth() const noexcept { return max_depth_; }
+
+private:
+	static constexpr int NULL_NODE = -1;
+	struct Node {
+		Box2<gFloat> bounds; // Regular (tight) bounds of the node.
+		int depth{0};
+		std::array<int, 4> children{{NULL_NODE, NULL_NODE, NULL_NODE, NULL_NODE}};
+		std::vector<std::size_t> entries; // Indices into entries_.
+	};
+	struct Entry {
+		Collidable* collidable{nullptr};
+		Box2<gFloat> aabb;
+		int node{NULL_NODE};
+	};
+	// Find (creating as needed) the node for a bounding box.
+	int _find_node(const Box2<gFloat>& aabb);
+	void _add_to_node(std::size_t entry, int node);
+	void _remove_from_node(std::size_t entry);
+
+	int max_depth_;
+	std::vector<Node> nodes_; // Root is the first node.
+	std::vector<Entry> entries_;
+	std::vector<std::size_t> free_entries_; // Removed entries available for reuse.
+	std::unordered_map<const Collidable*, std::size_t> indices_;
+};
+}
+#endif // INCLUDE_GEOM_LOOSE_QUADTREE_COLLISION_MAP_HPP
@@ -60,7 +60,7 @@ CollisionResult Movable::_find_closest_collision(const CollisionMap& collisionMa
 	gFloat interval(1.0f), testInterval;
 	info.isCollision = false;
 	const Coord2 delta(info.currentDir * info.remainingDist);
-	for (const auto& obj : collisionMap.getColliding(*this, delta)) {
+	for (const auto& obj : _get_colliding(collisionMap, info.currentPosition, delta)) {
 		switch (collides(info.collider, info.currentPosition, delta, obj->getCollider(), obj->getPosition(), testNorm, testInterval)) {
 		case CollisionResult::Sweep:
 			info.isCollision = true;
@@ -92,6 +92,12 @@ CollisionResult Movable::_find_closest_collision(const CollisionMap& collisionMa
 		info.moveDist = 0;
 	return CollisionResult::Sweep;
 }
+
+const std::vector<Collidable*>& Movable::_get_colliding(const CollisionMap& collisionMap, Coord2 position, Coord2 delta) const {
+	collisionMap.getColliding(*this, position, delta, colliding_);
+	return colliding_;
+}
+
 bool Movable::_move(CollisionInfo& info, const CollisionMap& collisionMap) {
 	if (_find_closest_collision(collisionMap, info) == CollisionResult::MinimumTranslationVector) {
 		_resolve_collision(info, collisionMap);
@@ -178,7 +184,7 @@ void Movable::_move_MTV(CollisionInfo& info, Coord2 delta, const CollisionMap& c
 		bool resolved = true;
 		gFloat biggestDist = 0;
 		Coord2 biggestDistNorm;
-		for (const auto& obj : collisionMap.getColliding(*this)) {
+		for (const auto& obj : _get_colliding(collisionMap, info.currentPosition, Coord2(0, 0))) {
 			if (overlaps(info.collider, info.currentPosition, obj->getCollider(), obj->getPosition(), info.normal, info.moveDist)) {
 				resolved = false;
 				info.collidable = obj;
@@ -208,7 +214,7 @@ void Movable::_resolve_collision(CollisionInfo& info, const CollisionMap& collis
 	for (std::size_t i = 1; i < MTV_RESOLUTION_MAX_ATTAMTPS; ++i) {
 		positions.push_back(info.currentPosition);
 		bool resolved = true;
-		for (const auto& obj : collisionMap.getColliding(*this)) {
+		for (const auto& obj : _get_colliding(collisionMap, info.currentPosition, Coord2(0, 0))) {
 			if (overlaps(info.collider, info.currentPosition, obj->getCollider(), obj->getPosition(), info.normal, info.moveDist)) {
 				resolved = false;
 				break;
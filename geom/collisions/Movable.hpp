@@ -1,6 +1,8 @@
 #ifndef INCLUDE_GEOM_MOVABLE_HPP
 #define INCLUDE_GEOM_MOVABLE_HPP
 
+#include <vector>
+
 #include "Collidable.hpp"
 #include "collisions.hpp"
 #include "../units.hpp"
@@ -56,6 +58,7 @@ protected:
 	// Default implementation simply returns true, to continue the algorithm.
 	// Is called after moving to the collision position, prior to calculating a new direction to move in.
 	// Return true if the algorithm should continue as normal, false if it should stop.
+	// Must not start another move of this Movable: the current move is still iterating over its collision query.
 	virtual bool onCollision(CollisionInfo& info);
 
 private:
@@ -69,6 +72,10 @@ private:
 	void _move_MTV(CollisionInfo& info, Coord2 delta, const CollisionMap& collisionMap);
 	// Attempt to fix currently-overlaping collisions.
 	void _resolve_collision(CollisionInfo& info, const CollisionMap& collisionMap);
+	// Query the collision map into colliding_, so repeated queries while moving reuse its memory.
+	const std::vector<Collidable*>& _get_colliding(const CollisionMap& collisionMap, Coord2 position, Coord2 delta) const;
+
+	mutable std::vector<Collidable*> colliding_;
 };
 }
 #endif // INCLUDE_GEOM_MOVABLE_HPP
@@ -0,0 +1,351 @@
+#include "StaticBVHCollisionMap.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <future>
+#include <numeric>
+#include <thread>
+#include <utility>
+
+#include "Collidable.hpp"
+#include "broadphase.hpp"
+#include "../debug_logger.hpp"
+#include "../units.hpp"
+#include "../intersections/isect_ray_shape_container.hpp"
+#include "../primitives/Ray.hpp"
+#include "../shapes/ShapeContainer.hpp"
+
+namespace ctp {
+
+const std::size_t StaticBVHCollisionMap::PARALLEL_BUILD_THRESHOLD = 100000;
+const int StaticBVHCollisionMap::MAX_LEAF_SIZE = 4;
+
+namespace {
+// Number of buckets centers are sorted into when searching for the best split.
+constexpr int BIN_COUNT = 16;
+// Most rays traversed together by a batched raycast. Which rays in a packet are still active is kept in a bit mask.
+constexpr int PACKET_SIZE = 32;
+using PacketMask = std::uint32_t;
+
+inline gFloat _axis_value(Coord2 point, bool isX) noexcept {
+	return isX ? point.x : point.y;
+}
+}
+
+StaticBVHCollisionMap::StaticBVHCollisionMap(const std::vector<Collidable*>& collidables, unsigned int threads) {
+	entries_.reserve(collidables.size());
+	for (Collidable* collidable : collidables) {
+		if (!collidable)
+			continue;
+		const broadphase::AABB aabb(broadphase::getAABB(*collidable));
+		entries_.push_back(Entry{collidable, aabb, Coord2(aabb.x + aabb.w * 0.5f, aabb.y + aabb.h * 0.5f)});
+	}
+	if (entries_.empty())
+		return;
+	if (threads == 0)
+		threads = std::max(1u, std::thread::hardware_concurrency());
+	if (entries_.size() < PARALLEL_BUILD_THRESHOLD)
+		threads = 1;
+	// A binary tree with leaves of at least one entry has fewer than twice as many nodes as entries.
+	nodes_.reserve(2 * entries_.size());
+	_build(0, entries_.size(), nodes_, threads);
+}
+
+const std::vector<Collidable*> StaticBVHCollisionMap::getColliding(const Collidable& collider, Coord2 delta) const {
+	return getColliding(collider, collider.getPosition(), delta);
+}
+
+const std::vector<Collidable*> StaticBVHCollisionMap::getColliding(const Collidable& collider, Coord2 position, Coord2 delta) const {
+	std::vector<Collidable*> colliding;
+	getColliding(collider, position, delta, colliding);
+	return colliding;
+}
+
+void StaticBVHCollisionMap::getColliding(const Collidable& collider, Coord2 position, Coord2 delta, std::vector<Collidable*>& colliding) const {
+	colliding.clear();
+	if (nodes_.empty())
+		return;
+	const broadphase::AABB query(broadphase::sweep(broadphase::getAABB(collider, position), delta));
+	broadphase::NodeStack stack;
+	int index = 0;
+	while (true) {
+		const Node& node = nodes_[index];
+		if (broadphase::overlaps(node.aabb, query)) {
+			if (!node.isLeaf()) {
+				// Visit the left child next: it directly follows its parent.
+				stack.push_back(node.offset);
+				++index;
+				continue;
+			}
+			for (int i = node.offset, end = node.offset + node.count; i < end; ++i) {
+				const Entry& entry = entries_[i];
+				if (entry.collidable != &collider && broadphase::overlaps(entry.aabb, query))
+					colliding.push_back(entry.collidable);
+			}
+		}
+		if (stack.empty())
+			break;
+		index = stack.back();
+		stack.pop_back();
+	}
+}
+
+RaycastHit StaticBVHCollisionMap::raycast(const Ray& ray, gFloat maxT) const {
+	RaycastHit hit;
+	const Coord2 inverseDir(broadphase::getInverseDir(ray));
+	gFloat enter, t;
+	Coord2 normal;
+	broadphase::RayNodeStack stack;
+	if (!nodes_.empty() && broadphase::raycast(ray, inverseDir, nodes_[0].aabb, maxT, enter))
+		stack.push_back({0, enter});
+	while (!stack.empty()) {
+		const auto [index, nodeEnter] = stack.back();
+		stack.pop_back();
+		if (nodeEnter > maxT)
+			continue; // A closer hit was found after this node was added.
+		const Node& node = nodes_[index];
+		if (node.isLeaf()) {
+			for (int i = node.offset, end = node.offset + node.count; i < end; ++i) {
+				const Entry& entry = entries_[i];
+				if (!broadphase::raycast(ray, inverseDir, entry.aabb, maxT, enter))
+					continue;
+				if (intersects(ray, entry.collidable->getCollider(), entry.collidable->getPosition(), t, normal) && t <= maxT) {
+					maxT = t;
+					hit.collidable = entry.collidable;
+					hit.t = t;
+					hit.normal = normal;
+				}
+			}
+			continue;
+		}
+		// Add the nearer child last, so it's visited first.
+		const int left(index + 1), right(node.offset);
+		gFloat leftEnter, rightEnter;
+		const bool hitsLeft(broadphase::raycast(ray, inverseDir, nodes_[left].aabb, maxT, leftEnter));
+		const bool hitsRight(broadphase::raycast(ray, inverseDir, nodes_[right].aabb, maxT, rightEnter));
+		if (hitsLeft && hitsRight) {
+			if (leftEnter < rightEnter) {
+				stack.push_back({right, rightEnter});
+				stack.push_back({left, leftEnter});
+			} else {
+				stack.push_back({left, leftEnter});
+				stack.push_back({right, rightEnter});
+			}
+		} else if (hitsLeft) {
+			stack.push_back({left, leftEnter});
+		} else if (hitsRight) {
+			stack.push_back({right, rightEnter});
+		}
+	}
+	return hit;
+}
+
+void StaticBVHCollisionMap::raycast(const std::vector<Ray>& rays, const std::vector<gFloat>& maxTs, std::vector<RaycastHit>& hits) const {
+	DBG_CHECK(rays.size() != maxTs.size(), "ERR", "Batched raycast needs a maximum distance for each ray. Rays: " << rays.size() << " Distances: " << maxTs.size());
+	hits.assign(rays.size(), RaycastHit());
+	if (nodes_.empty())
+		return;
+	// Rays without a maximum distance are never cast, so a shorter list of distances can't be read past its end.
+	const std::size_t castCount(std::min(rays.size(), maxTs.size()));
+	// Group rays that share an origin and head in similar directions, so packets visit the same nodes.
+	std::vector<gFloat> angles(castCount);
+	for (std::size_t i = 0; i < castCount; ++i)
+		angles[i] = std::atan2(rays[i].dir.y, rays[i].dir.x);
+	std::vector<std::size_t> order(castCount);
+	std::iota(order.begin(), order.end(), 0);
+	std::sort(order.begin(), order.end(), [&rays, &angles](std::size_t a, std::size_t b) {
+		if (rays[a].origin.x != rays[b].origin.x)
+			return rays[a].origin.x < rays[b].origin.x;
+		if (rays[a].origin.y != rays[b].origin.y)
+			return rays[a].origin.y < rays[b].origin.y;
+		return angles[a] < angles[b];
+	});
+
+	std::array<Coord2, PACKET_SIZE> inverseDirs;
+	std::array<gFloat, PACKET_SIZE> packetMaxTs;
+	std::vector<std::pair<int, PacketMask>> stack;
+	gFloat enter, t;
+	Coord2 normal;
+	for (std::size_t first = 0; first < order.size(); first += PACKET_SIZE) {
+		const int count(static_cast<int>(std::min<std::size_t>(PACKET_SIZE, order.size() - first)));
+		const std::size_t* const packet(&order[first]);
+		Coord2 origin, dir; // Averages, for ordering children front to back.
+		for (int i = 0; i < count; ++i) {
+			const Ray& ray(rays[packet[i]]);
+			inverseDirs[i] = broadphase::getInverseDir(ray);
+			packetMaxTs[i] = maxTs[packet[i]];
+			origin += ray.origin;
+			dir += ray.dir;
+		}
+		origin /= static_cast<gFloat>(count);
+
+		stack.clear();
+		stack.emplace_back(0, count == PACKET_SIZE ? ~PacketMask(0) : (PacketMask(1) << count) - 1);
+		while (!stack.empty()) {
+			const auto [index, parentMask] = stack.back();
+			stack.pop_back();
+			const Node& node = nodes_[index];
+			// Only rays that reached the parent can reach its children.
+			PacketMask mask(0);
+			for (int i = 0; i < count; ++i) {
+				if (((parentMask >> i) & 1) && broadphase::raycast(rays[packet[i]], inverseDirs[i], node.aabb, packetMaxTs[i], enter))
+					mask |= PacketMask(1) << i;
+			}
+			if (mask == 0)
+				continue;
+			if (!node.isLeaf()) {
+				// Add the child nearer along the packet's average direction last, so it's visited first.
+				const int left(index + 1), right(node.offset);
+				const auto distance = [this, origin, dir](int child) {
+					const Box2<gFloat>& box(nodes_[child].aabb);
+					return dir.dot(Coord2(box.x + box.w * 0.5f, box.y + box.h * 0.5f) - origin);
+				};
+				const bool isLeftNearer(distance(left) < distance(right));
+				stack.emplace_back(isLeftNearer ? right : left, mask);
+				stack.emplace_back(isLeftNearer ? left : right, mask);
+				continue;
+			}
+			for (int i = 0; i < count; ++i) {
+				if (!((mask >> i) & 1))
+					continue;
+				const Ray& ray(rays[packet[i]]);
+				RaycastHit& hit(hits[packet[i]]);
+				for (int e = node.offset, end = node.offset + node.count; e < end; ++e) {
+					const Entry& entry = entries_[e];
+					if (!broadphase::raycast(ray, inverseDirs[i], entry.aabb, packetMaxTs[i], enter))
+						continue;
+					if (intersects(ray, entry.collidable->getCollider(), entry.collidable->getPosition(), t, normal) && t <= packetMaxTs[i]) {
+						packetMaxTs[i] = t;
+						hit.collidable = entry.collidable;
+						hit.t = t;
+						hit.normal = normal;
+					}
+				}
+			}
+		}
+	}
+}
+
+int StaticBVHCollisionMap::height() const noexcept {
+	if (nodes_.empty())
+		return 0;
+	int height = 0;
+	std::vector<std::pair<int, int>> stack{{0, 1}};
+	while (!stack.empty()) {
+		const auto [index, depth] = stack.back();
+		stack.pop_back();
+		height = std::max(height, depth);
+		if (!nodes_[index].isLeaf()) {
+			stack.emplace_back(index + 1, depth + 1);
+			stack.emplace_back(nodes_[index].offset, depth + 1);
+		}
+	}
+	return height;
+}
+
+void StaticBVHCollisionMap::_build(std::size_t first, std::size_t last, std::vector<Node>& nodes, unsigned int threads) {
+	const std::size_t node = nodes.size();
+	nodes.emplace_back(); // Invalidates references to nodes.
+	broadphase::AABB bounds(entries_[first].aabb);
+	for (std::size_t i = first + 1; i < last; ++i)
+		bounds = broadphase::combine(bounds, entries_[i].aabb);
+	nodes[node].aabb = bounds;
+	if (last - first <= static_cast<std::size_t>(MAX_LEAF_SIZE)) {
+		nodes[node].offset = static_cast<int>(first);
+		nodes[node].count = static_cast<int>(last - first);
+		return;
+	}
+	const std::size_t middle = _partition(first, last);
+	if (threads > 1) {
+		// The two halves cover separate entries, so they can be built at once. The right half is built
+		// into its own array, which is appended after the left half to keep the depth-first order.
+		auto right = std::async(std::launch::async, [this, middle, last, threads]() {
+			std::vector<Node> rightNodes;
+			rightNodes.reserve(2 * (last - middle));
+			_build(middle, last, rightNodes, threads / 2);
+			return rightNodes;
+		});
+		_build(first, middle, nodes, threads - threads / 2);
+		const std::vector<Node> rightNodes(right.get());
+		const int rightStart = static_cast<int>(nodes.size());
+		nodes[node].offset = rightStart;
+		for (Node n : rightNodes) {
+			if (!n.isLeaf())
+				n.offset += rightStart;
+			nodes.push_back(n);
+		}
+		return;
+	}
+	_build(first, middle, nodes, 1);
+	nodes[node].offset = static_cast<int>(nodes.size());
+	_build(middle, last, nodes, 1);
+}
+
+std::size_t StaticBVHCollisionMap::_partition(std::size_t first, std::size_t last) {
+	// Split along the axis the centers are most spread out on.
+	Coord2 minCenter(entries_[first].center), maxCenter(entries_[first].center);
+	for (std::size_t i = first + 1; i < last; ++i) {
+		minCenter = Coord2(std::min(minCenter.x, entries_[i].center.x), std::min(minCenter.y, entries_[i].center.y));
+		maxCenter = Coord2(std::max(maxCenter.x, entries_[i].center.x), std::max(maxCenter.y, entries_[i].center.y));
+	}
+	const bool isX(maxCenter.x - minCenter.x >= maxCenter.y - minCenter.y);
+	const gFloat min(_axis_value(minCenter, isX));
+	const gFloat extent(_axis_value(maxCenter, isX) - min);
+	const std::size_t median = first + (last - first) / 2;
+	const auto splitAtMedian = [this, first, median, last, isX]() {
+		std::nth_element(entries_.begin() + first, entries_.begin() + median, entries_.begin() + last,
+			[isX](const Entry& a, const Entry& b) { return _axis_value(a.center, isX) < _axis_value(b.center, isX); });
+		return median;
+	};
+	if (extent <= 0)
+		return splitAtMedian(); // All centers are in the same place: any split is as good as another.
+
+	// Sort centers into evenly spaced bins, then find the split between bins with the lowest cost.
+	const gFloat scale(BIN_COUNT / extent);
+	const auto getBin = [scale, min, isX](const Entry& e) {
+		return std::min(BIN_COUNT - 1, static_cast<int>((_axis_value(e.center, isX) - min) * scale));
+	};
+	std::array<std::size_t, BIN_COUNT> counts{};
+	std::array<broadphase::AABB, BIN_COUNT> boxes;
+	for (std::size_t i = first; i < last; ++i) {
+		const int bin = getBin(entries_[i]);
+		boxes[bin] = counts[bin] == 0 ? entries_[i].aabb : broadphase::combine(boxes[bin], entries_[i].aabb);
+		++counts[bin];
+	}
+	// Cost of everything right of each split, swept from the right.
+	std::array<gFloat, BIN_COUNT> rightCosts{};
+	std::size_t rightCount(0);
+	broadphase::AABB rightBox;
+	for (int bin = BIN_COUNT - 1; bin > 0; --bin) {
+		if (counts[bin] > 0) {
+			rightBox = rightCount == 0 ? boxes[bin] : broadphase::combine(rightBox, boxes[bin]);
+			rightCount += counts[bin];
+		}
+		rightCosts[bin - 1] = rightCount * broadphase::perimeter(rightBox);
+	}
+	int bestSplit(-1); // Split after this bin.
+	gFloat bestCost(0);
+	std::size_t leftCount(0);
+	broadphase::AABB leftBox;
+	for (int bin = 0; bin < BIN_COUNT - 1; ++bin) {
+		if (counts[bin] > 0) {
+			leftBox = leftCount == 0 ? boxes[bin] : broadphase::combine(leftBox, boxes[bin]);
+			leftCount += counts[bin];
+		}
+		if (leftCount == 0 || leftCount == last - first)
+			continue;
+		const gFloat cost(leftCount * broadphase::perimeter(leftBox) + rightCosts[bin]);
+		if (bestSplit < 0 || cost < bestCost) {
+			bestSplit = bin;
+			bestCost = cost;
+		}
+	}
+	if (bestSplit < 0)
+		return splitAtMedian();
+	const auto middle = std::partition(entries_.begin() + first, entries_.begin() + last,
+		[&getBin, bestSplit](const Entry& e) { return getBin(e) <= bestSplit; });
+	return static_cast<std::size_t>(middle - entries_.begin());
+}
+}
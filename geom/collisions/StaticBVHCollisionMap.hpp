@@ -0,0 +1,70 @@
+#ifndef INCLUDE_GEOM_STATIC_BVH_COLLISION_MAP_HPP
+#define INCLUDE_GEOM_STATIC_BVH_COLLISION_MAP_HPP
+
+#include <cstddef>
+#include <vector>
+
+#include "CollisionMap.hpp"
+#include "../units.hpp"
+#include "../primitives/Box2.hpp"
+
+// Immutable bounding volume hierarchy for collidables that never move, such as level geometry.
+// Built once with a binned surface area heuristic, and stored as a flat depth-first array of nodes:
+// a branch's left child directly follows it, so traversal walks forward through memory.
+// Large maps are built on several threads. Queries keep no state in the map, so they can run concurrently.
+// The map does not own its collidables: they must outlive the map, and must not move while in it.
+namespace ctp {
+class StaticBVHCollisionMap : public CollisionMap {
+public:
+	// Maps with at least this many collidables are built on multiple threads.
+	static const std::size_t PARALLEL_BUILD_THRESHOLD;
+	// Most collidables to put in one leaf.
+	static const int MAX_LEAF_SIZE;
+
+	StaticBVHCollisionMap() = default;
+	// Build the map from the given collidables.
+	// Threads is how many threads to build with when the map is large. 0 uses the hardware's concurrency.
+	explicit StaticBVHCollisionMap(const std::vector<Collidable*>& collidables, unsigned int threads = 0);
+
+	using CollisionMap::getColliding;
+	const std::vector<Collidable*> getColliding(const Collidable& collider, Coord2 delta) const override;
+	const std::vector<Collidable*> getColliding(const Collidable& collider, Coord2 position, Coord2 delta) const override;
+	void getColliding(const Collidable& collider, Coord2 position, Coord2 delta, std::vector<Collidable*>& colliding) const override;
+	// Visits nodes nearest to the ray first, skipping any farther away than the closest hit found so far.
+	RaycastHit raycast(const Ray& ray, gFloat maxT) const override;
+	// Raycast many rays at once, each with its own maximum distance. Hits are filled with each ray's closest hit, in the same order.
+	// Rays past the end of maxTs have no maximum distance, so they aren't cast and get no hit.
+	// Similar rays are grouped into packets that share one traversal of the tree, which is much faster than casting
+	// them one at a time when rays come from a few origins, such as fans of rays for sight or lighting.
+	void raycast(const std::vector<Ray>& rays, const std::vector<gFloat>& maxTs, std::vector<RaycastHit>& hits) const;
+
+	// Get the number of collidables in the map.
+	std::size_t size() const noexcept { return entries_.size(); }
+	bool empty() const noexcept { return entries_.empty(); }
+	std::size_t nodeCount() const noexcept { return nodes_.size(); }
+	// Get the height of the tree. An empty tree has height 0, and a tree with a single leaf has height 1.
+	int height() const noexcept;
+
+private:
+	struct Node {
+		Box2<gFloat> aabb;
+		int offset{0}; // First entry for leaves, index of the right child for branches.
+		int count{0};  // Number of entries for leaves, 0 for branches.
+		bool isLeaf() const noexcept { return count > 0; }
+	};
+	struct Entry {
+		Collidable* collidable{nullptr};
+		Box2<gFloat> aabb;
+		Coord2 center;
+	};
+	// Build the subtree over entries [first, last), appending its nodes to the given array depth-first.
+	// Right subtrees are built on a new thread while more than one thread is given.
+	void _build(std::size_t first, std::size_t last, std::vector<Node>& nodes, unsigned int threads);
+	// Reorder entries [first, last) into two groups by the best binned split. Returns the start of the second group.
+	std::size_t _partition(std::size_t first, std::size_t last);
+
+	std::vector<Node> nodes_; // Root is the first node.
+	std::vector<Entry> entries_;
+};
+}
+#endif // INCLUDE_GEOM_STATIC_BVH_COLLISION_MAP_HPP
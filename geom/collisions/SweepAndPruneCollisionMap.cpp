@@ -0,0 +1,149 @@
+#include "SweepAndPruneCollisionMap.hpp"
+
+#include <algorithm>
+
+#include "Collidable.hpp"
+#include "broadphase.hpp"
+#include "../units.hpp"
+
+namespace ctp {
+
+const std::vector<Collidable*> SweepAndPruneCollisionMap::getColliding(const Collidable& collider, Coord2 delta) const {
+	return getColliding(collider, collider.getPosition(), delta);
+}
+
+const std::vector<Collidable*> SweepAndPruneCollisionMap::getColliding(const Collidable& collider, Coord2 position, Coord2 delta) const {
+	std::vector<Collidable*> colliding;
+	getColliding(collider, position, delta, colliding);
+	return colliding;
+}
+
+void SweepAndPruneCollisionMap::getColliding(const Collidable& collider, Coord2 position, Coord2 delta, std::vector<Collidable*>& colliding) const {
+	colliding.clear();
+	const broadphase::AABB query(broadphase::sweep(broadphase::getAABB(collider, position), delta));
+	const gFloat queryMin(_min(query)), queryMax(_max(query));
+	const auto sortedEnd = entries_.begin() + sorted_size_;
+	// Any box that overlaps the query must start within max_width_ before it.
+	auto it = std::lower_bound(entries_.begin(), sortedEnd, queryMin - max_width_,
+		[this](const Entry& e, gFloat value) { return _min(e.aabb) < value; });
+	for (; it != sortedEnd && _min(it->aabb) <= queryMax; ++it) {
+		if (it->collidable && it->collidable != &collider && broadphase::overlaps(it->aabb, query))
+			colliding.push_back(it->collidable);
+	}
+	for (it = sortedEnd; it != entries_.end(); ++it) { // Not sorted in yet.
+		if (it->collidable != &collider && broadphase::overlaps(it->aabb, query))
+			colliding.push_back(it->collidable);
+	}
+}
+
+std::vector<std::pair<Collidable*, Collidable*>> SweepAndPruneCollisionMap::getOverlappingPairs() const {
+	std::vector<std::pair<Collidable*, Collidable*>> pairs;
+	broadphase::sweepSorted(entries_.begin(), entries_.begin() + sorted_size_, axis_, _get_aabb,
+		[&pairs](const Entry& a, const Entry& b) { pairs.emplace_back(a.collidable, b.collidable); });
+	// Test collidables that aren't sorted in yet against every other.
+	for (std::size_t i = sorted_size_, size = entries_.size(); i < size; ++i) {
+		for (std::size_t k = 0; k < i; ++k) {
+			if (entries_[k].collidable && broadphase::overlaps(entries_[i].aabb, entries_[k].aabb))
+				pairs.emplace_back(entries_[k].collidable, entries_[i].collidable);
+		}
+	}
+	return pairs;
+}
+
+void SweepAndPruneCollisionMap::insert(Collidable* collidable) {
+	if (!indices_.emplace(collidable, entries_.size()).second)
+		return; // Already in the map.
+	const broadphase::AABB aabb(broadphase::getAABB(*collidable));
+	max_width_ = std::max(max_width_, _width(aabb));
+	entries_.push_back(Entry{collidable, aabb});
+}
+
+void SweepAndPruneCollisionMap::remove(const Collidable* collidable) {
+	const auto it = indices_.find(collidable);
+	if (it == indices_.end())
+		return;
+	const std::size_t index(it->second);
+	indices_.erase(it);
+	if (index < sorted_size_) { // Leave a gap, so the sorted entries stay in order.
+		entries_[index].collidable = nullptr;
+		++num_removed_;
+		return;
+	}
+	// Entries that aren't sorted in yet are in no order: swap the last one into its place.
+	if (index + 1 != entries_.size()) {
+		entries_[index] = entries_.back();
+		indices_[entries_[index].collidable] = index;
+	}
+	entries_.pop_back();
+}
+
+void SweepAndPruneCollisionMap::update() {
+	for (auto& entry : entries_) {
+		if (entry.collidable)
+			entry.aabb = broadphase::getAABB(*entry.collidable);
+	}
+	if (choose_axis_) {
+		const Axis best = broadphase::chooseAxis(entries_.begin(), entries_.end(), _get_aabb, axis_);
+		if (best != axis_) {
+			// The order on the other axis is unrelated, so everything is sorted in from scratch.
+			axis_ = best;
+			entries_.erase(std::remove_if(entries_.begin(), entries_.end(), [](const Entry& e) { return e.collidable == nullptr; }), entries_.end());
+			sorted_size_ = 0;
+			num_removed_ = 0;
+		}
+	}
+	_insertion_sort();
+	_merge_changes();
+	max_width_ = 0;
+	for (const auto& entry : entries_)
+		max_width_ = std::max(max_width_, _width(entry.aabb));
+}
+
+void SweepAndPruneCollisionMap::clear() {
+	entries_.clear();
+	indices_.clear();
+	sorted_size_ = 0;
+	num_removed_ = 0;
+	max_width_ = 0;
+}
+
+bool SweepAndPruneCollisionMap::contains(const Collidable* collidable) const {
+	return indices_.find(collidable) != indices_.end();
+}
+
+void SweepAndPruneCollisionMap::_insertion_sort() {
+	for (std::size_t i = 1; i < sorted_size_; ++i) {
+		const gFloat min(_min(entries_[i].aabb));
+		if (_min(entries_[i - 1].aabb) <= min)
+			continue; // Already in place: the common case when little has moved.
+		const Entry entry(entries_[i]);
+		std::size_t k = i;
+		for (; k > 0 && _min(entries_[k - 1].aabb) > min; --k) {
+			entries_[k] = entries_[k - 1];
+			if (entries_[k].collidable)
+				indices_[entries_[k].collidable] = k;
+		}
+		entries_[k] = entry;
+		if (entry.collidable)
+			indices_[entry.collidable] = k;
+	}
+}
+
+void SweepAndPruneCollisionMap::_merge_changes() {
+	if (num_removed_ == 0 && sorted_size_ == entries_.size())
+		return;
+	const auto isRemoved = [](const Entry& e) { return e.collidable == nullptr; };
+	const auto sortedEnd = std::remove_if(entries_.begin(), entries_.begin() + sorted_size_, isRemoved);
+	entries_.erase(sortedEnd, entries_.begin() + sorted_size_);
+	sorted_size_ -= num_removed_;
+	num_removed_ = 0;
+	// Sort the new entries on their own, then merge the two sorted runs.
+	const auto byMin = [this](const Entry& a, const Entry& b) { return _min(a.aabb) < _min(b.aabb); };
+	const auto newBegin = entries_.begin() + sorted_size_;
+	std::sort(newBegin, entries_.end(), byMin);
+	std::inplace_merge(entries_.begin(), newBegin, entries_.end(), byMin);
+	sorted_size_ = entries_.size();
+	for (std::size_t i = 0; i < entries_.size(); ++i)
+		indices_[entries_[i].collidable] = i;
+}
+}
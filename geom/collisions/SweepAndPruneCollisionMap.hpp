@@ -0,0 +1,77 @@
+#ifndef INCLUDE_GEOM_SWEEP_AND_PRUNE_COLLISION_MAP_HPP
+#define INCLUDE_GEOM_SWEEP_AND_PRUNE_COLLISION_MAP_HPP
+
+#include <cstddef>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "CollisionMap.hpp"
+#include "broadphase.hpp"
+#include "../units.hpp"
+#include "../primitives/Box2.hpp"
+
+// Sort and sweep: collidables' bounding boxes are kept sorted by their minimum endpoint along one axis.
+// Bounding boxes are cached, and refreshed by calling update() once per frame. Since objects usually move only a little
+// each frame, the list stays nearly sorted and is re-sorted with insertion sort in close to linear time.
+// Works best with many similar-sized objects: queries also scan back by the widest box in the map.
+// Inserting and removing collidables takes constant time. Inserted collidables are checked one by one until the next update()
+// sorts them in, and removed ones leave a gap in the sorted list until then.
+// The map does not own its collidables: they must outlive the map, or be removed from it first.
+namespace ctp {
+class SweepAndPruneCollisionMap : public CollisionMap {
+public:
+	using Axis = broadphase::Axis;
+
+	SweepAndPruneCollisionMap() = default;
+	// If chooseAxis is true, update() sorts along whichever axis the collidables are most spread out on.
+	explicit SweepAndPruneCollisionMap(bool chooseAxis) : choose_axis_(chooseAxis) {}
+
+	using CollisionMap::getColliding;
+	const std::vector<Collidable*> getColliding(const Collidable& collider, Coord2 delta) const override;
+	const std::vector<Collidable*> getColliding(const Collidable& collider, Coord2 position, Coord2 delta) const override;
+	void getColliding(const Collidable& collider, Coord2 position, Coord2 delta, std::vector<Collidable*>& colliding) const override;
+
+	// Find all pairs of collidables in the map whose bounding boxes overlap, as of the last update.
+	std::vector<std::pair<Collidable*, Collidable*>> getOverlappingPairs() const;
+
+	// Add a collidable to the map. NOOP if it is already in the map.
+	void insert(Collidable* collidable);
+	// Remove a collidable from the map. NOOP if it isn't in the map.
+	void remove(const Collidable* collidable);
+	// Refresh the bounding boxes of all collidables, and re-sort them.
+	void update();
+	void clear();
+
+	bool contains(const Collidable* collidable) const;
+	// Get the number of collidables in the map.
+	std::size_t size() const noexcept { return indices_.size(); }
+	// Get the axis currently sorted along.
+	Axis axis() const noexcept { return axis_; }
+
+private:
+	struct Entry {
+		Collidable* collidable{nullptr}; // Null if removed since the last update.
+		Box2<gFloat> aabb; // World bounding box as of the last update.
+	};
+	gFloat _min(const Box2<gFloat>& aabb) const noexcept { return broadphase::minOn(aabb, axis_); }
+	gFloat _max(const Box2<gFloat>& aabb) const noexcept { return broadphase::maxOn(aabb, axis_); }
+	gFloat _width(const Box2<gFloat>& aabb) const noexcept { return broadphase::widthOn(aabb, axis_); }
+	// Get an entry's bounding box, or null for the gap left by a removed collidable.
+	static const Box2<gFloat>* _get_aabb(const Entry& e) noexcept { return e.collidable ? &e.aabb : nullptr; }
+	// Re-sort the sorted entries with insertion sort, keeping their indices up to date.
+	void _insertion_sort();
+	// Drop the gaps left by removed collidables, and sort in those inserted since the last update.
+	void _merge_changes();
+
+	// Entries before sorted_size_ are sorted by minimum endpoint on the current axis. The rest were inserted since the last update.
+	std::vector<Entry> entries_;
+	std::unordered_map<const Collidable*, std::size_t> indices_; // Index of each collidable's entry.
+	std::size_t sorted_size_{0};
+	std::size_t num_removed_{0};        // Gaps in the sorted entries.
+	gFloat max_width_{0};        // Widest bounding box on the current axis.
+	Axis axis_{Axis::X};
+	bool choose_axis_{false};
+};
+}
+#endif // INCLUDE_GEOM_SWEEP_AND_PRUNE_COLLISION_MAP_HPP
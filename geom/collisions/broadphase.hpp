@@ -0,0 +1,161 @@
+#ifndef INCLUDE_GEOM_BROADPHASE_HPP
+#define INCLUDE_GEOM_BROADPHASE_HPP
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+
+#include "Collidable.hpp"
+#include "../small_vector.hpp"
+#include "../units.hpp"
+#include "../primitives/Box2.hpp"
+#include "../primitives/Ray.hpp"
+#include "../shapes/ShapeContainer.hpp"
+
+// Bounding box helpers shared by the CollisionMap implementations.
+// Unlike overlaps(Rect, Rect), boxes that touch are considered overlapping: it's up to the narrowphase to reject them.
+namespace ctp::broadphase {
+// Plain bounding box.
+using AABB = Box2<gFloat>;
+
+// Get the world-space bounding box of a collidable at a given position.
+inline AABB getAABB(const Collidable& collidable, Coord2 position) {
+	return ctp::getAABB(collidable.getCollider()) + position;
+}
+// Get the world-space bounding box of a collidable.
+inline AABB getAABB(const Collidable& collidable) {
+	return getAABB(collidable, collidable.getPosition());
+}
+// Expand a bounding box to cover its movement along delta.
+constexpr AABB sweep(const AABB& aabb, Coord2 delta) noexcept {
+	return AABB(std::min(aabb.x, aabb.x + delta.x), std::min(aabb.y, aabb.y + delta.y),
+		aabb.w + (delta.x < 0 ? -delta.x : delta.x), aabb.h + (delta.y < 0 ? -delta.y : delta.y));
+}
+// Get the smallest box containing both boxes.
+constexpr AABB combine(const AABB& a, const AABB& b) noexcept {
+	const gFloat left(std::min(a.left(), b.left())), top(std::min(a.top(), b.top()));
+	return AABB(left, top, std::max(a.right(), b.right()) - left, std::max(a.bottom(), b.bottom()) - top);
+}
+// Grow a box by margin on every side.
+constexpr AABB fatten(const AABB& aabb, gFloat margin) noexcept {
+	return AABB(aabb.x - margin, aabb.y - margin, aabb.w + 2 * margin, aabb.h + 2 * margin);
+}
+// Test if two boxes overlap or touch.
+constexpr bool overlaps(const AABB& a, const AABB& b) noexcept {
+	return a.left() <= b.right() && a.right() >= b.left() && a.top() <= b.bottom() && a.bottom() >= b.top();
+}
+// Test if the first box is entirely inside the second box.
+constexpr bool contains(const AABB& outer, const AABB& inner) noexcept {
+	return inner.isInside(outer);
+}
+// Get the reciprocal of a ray's direction, for testing the ray against many boxes.
+inline Coord2 getInverseDir(const Ray& ray) noexcept {
+	return Coord2(ray.dir.x == 0 ? 0 : 1 / ray.dir.x, ray.dir.y == 0 ? 0 : 1 / ray.dir.y);
+}
+// Find how far along a ray it enters a box, if it does so within [0, maxT]. A ray that starts inside the box enters at 0.
+inline bool raycast(const Ray& ray, Coord2 inverseDir, const AABB& aabb, gFloat maxT, gFloat& out_t) noexcept {
+	gFloat enter(0), exit(maxT);
+	// Narrow the interval the ray is inside the box on each axis. A ray parallel to an axis is either always or never inside it.
+	if (ray.dir.x == 0) {
+		if (ray.origin.x < aabb.left() || ray.origin.x > aabb.right())
+			return false;
+	} else {
+		const gFloat t1((aabb.left() - ray.origin.x) * inverseDir.x), t2((aabb.right() - ray.origin.x) * inverseDir.x);
+		enter = std::max(enter, std::min(t1, t2));
+		exit = std::min(exit, std::max(t1, t2));
+	}
+	if (ray.dir.y == 0) {
+		if (ray.origin.y < aabb.top() || ray.origin.y > aabb.bottom())
+			return false;
+	} else {
+		const gFloat t1((aabb.top() - ray.origin.y) * inverseDir.y), t2((aabb.bottom() - ray.origin.y) * inverseDir.y);
+		enter = std::max(enter, std::min(t1, t2));
+		exit = std::min(exit, std::max(t1, t2));
+	}
+	if (enter > exit)
+		return false;
+	out_t = enter;
+	return true;
+}
+// Stacks of nodes for walking a tree. Queries keep them locally, so concurrent const queries share nothing, and they only use
+// the heap for trees too deep for the inline storage.
+using NodeStack = SmallVector<int, 64>;
+// A node a ray reaches, and how far along the ray it enters the node.
+struct RayNode {
+	int index;
+	gFloat enter;
+};
+using RayNodeStack = SmallVector<RayNode, 64>;
+// Check if a cell is the first (top-left) cell shared by an object's inclusive range of cells and a query's.
+// A query that visits each of its cells once finds an object that spans several of them exactly once by only taking it at this
+// cell, without keeping any state between queries.
+constexpr bool isFirstSharedCell(int x, int y, const Box2<int>& cells, const Box2<int>& range) noexcept {
+	return x == std::max(cells.left(), range.left()) && y == std::max(cells.top(), range.top());
+}
+// Surface area heuristic cost for a box. In 2D this is the perimeter.
+constexpr gFloat perimeter(const AABB& aabb) noexcept {
+	return 2 * (aabb.w + aabb.h);
+}
+
+// Sort and sweep ------------------------------------------------------
+// Boxes sorted by their minimum endpoint on an axis only need to be tested against those that start before they end.
+// These take a range of items and a function giving each item's box, or null to skip it.
+
+// An axis to sort boxes along.
+enum class Axis {
+	X,
+	Y
+};
+constexpr gFloat minOn(const AABB& aabb, Axis axis) noexcept { return axis == Axis::X ? aabb.left() : aabb.top(); }
+constexpr gFloat maxOn(const AABB& aabb, Axis axis) noexcept { return axis == Axis::X ? aabb.right() : aabb.bottom(); }
+constexpr gFloat widthOn(const AABB& aabb, Axis axis) noexcept { return axis == Axis::X ? aabb.w : aabb.h; }
+
+// Find which axis boxes are most spread out on, by the variance of their centers. Gives fallback for fewer than two boxes.
+template <typename It, typename GetAABB>
+Axis chooseAxis(It first, It last, GetAABB getAABB, Axis fallback) {
+	const auto center = [](const AABB& aabb) { return Coord2(aabb.x + aabb.w * 0.5f, aabb.y + aabb.h * 0.5f); };
+	Coord2 mean;
+	std::size_t count(0);
+	for (It it = first; it != last; ++it) {
+		if (const AABB* aabb = getAABB(*it)) {
+			mean += center(*aabb);
+			++count;
+		}
+	}
+	if (count < 2)
+		return fallback;
+	mean /= static_cast<gFloat>(count);
+	gFloat varianceX(0), varianceY(0); // Unnormalized: only used for comparison.
+	for (It it = first; it != last; ++it) {
+		if (const AABB* aabb = getAABB(*it)) {
+			const Coord2 diff(center(*aabb) - mean);
+			varianceX += diff.x * diff.x;
+			varianceY += diff.y * diff.y;
+		}
+	}
+	return varianceY > varianceX ? Axis::Y : Axis::X;
+}
+
+// Sweep along items sorted by their boxes' minimum on an axis, calling onPair(a, b) for each pair of items whose boxes overlap,
+// with a before b.
+template <typename It, typename GetAABB, typename OnPair>
+void sweepSorted(It first, It last, Axis axis, GetAABB getAABB, OnPair onPair) {
+	for (It i = first; i != last; ++i) {
+		const AABB* a(getAABB(*i));
+		if (!a)
+			continue;
+		const gFloat end(maxOn(*a, axis));
+		It k = i;
+		for (++k; k != last; ++k) {
+			const AABB* b(getAABB(*k));
+			if (!b)
+				continue;
+			if (minOn(*b, axis) > end)
+				break; // No later box can start before this one ends.
+			if (overlaps(*a, *b))
+				onPair(*i, *k);
+		}
+	}
+}
+}
+#endif // INCLUDE_GEOM_BROADPHASE_HPP
@@ -1,13 +1,13 @@
 #include "collisions.hpp"
 
+#include <type_traits>
+#include <utility>
 #include <vector>
 
 #include "../units.hpp"
 #include "../constants.hpp"
-#include "../debug_logger.hpp"
 #include "../math.hpp"
 #include "../shapes/ShapeContainer.hpp"
-#include "../shapes/Shape.hpp"
 #include "../shapes/Rectangle.hpp"
 #include "../shapes/Polygon.hpp"
 #include "../shapes/Circle.hpp"
@@ -15,7 +15,10 @@
 #include "../primitives/Ray.hpp"
 #include "../primitives/Projection.hpp"
 #include "../intersections/sat.hpp"
+#include "../intersections/shape_pairs.hpp"
 #include "../intersections/overlaps.hpp"
+#include "../intersections/gjk.hpp"
+#include "../intersections/SeparatingAxisCache.hpp"
 
 namespace ctp {
 namespace {
@@ -104,7 +107,7 @@ inline CollisionResult _collides_with_edge(const Coord2 circlePos, Coord2 pointO
 	return CollisionResult::Sweep;
 }
 // Perform a sweep test by expanding the polygon by the circle's radius, and testing if the line segment made from the circle's motion collides with the polygon.
-inline CollisionResult _circle_poly_sweep(const Circle& circle, const Polygon& poly, Coord2 offset, Coord2 delta, Coord2& out_norm, gFloat& out_t) {
+inline CollisionResult _circle_poly_sweep(const Circle& circle, const PolygonView& poly, Coord2 offset, Coord2 delta, Coord2& out_norm, gFloat& out_t) {
 	const int polySize = static_cast<int>(poly.size());
 	const Coord2 circlePos = circle.center + offset;
 	const gFloat radiusEps = circle.radius - constants::EPSILON; // Radius with eps subtracted. TODO: Get proper epsilon here.
@@ -147,55 +150,104 @@ inline CollisionResult _circle_poly_sweep(const Circle& circle, const Polygon& p
 	const Coord2 testVert(verticesInfo.last_index > 0 ? poly[verticesInfo.last_index - 1] : poly[polySize - 1]);
 	return _collides_with_vertex(circlePos, testVert, deltaDir, deltaMag2, deltaMag, radiusEps, out_norm, out_t);
 }
-} // namespace
+// Narrow the times [io_enter, io_exit] that a moving point is between two parallel sides, on one axis.
+// lowNorm is the normal of the side at low, and io_norm is set to the normal of the side entered at io_enter.
+// Returns false if the point is never between the sides during those times.
+inline bool _clip_to_sides(gFloat pos, gFloat delta, gFloat low, gFloat high, Coord2 lowNorm, gFloat& io_enter, gFloat& io_exit, Coord2& io_norm) {
+	if (delta == 0)
+		return pos >= low && pos <= high;
+	gFloat lowTime((low - pos) / delta), highTime((high - pos) / delta);
+	Coord2 enterNorm(lowNorm);
+	if (lowTime > highTime) { // Moving towards the low side.
+		std::swap(lowTime, highTime);
+		enterNorm = -lowNorm;
+	}
+	if (lowTime > io_enter) {
+		io_enter = lowTime;
+		io_norm = enterNorm;
+	}
+	if (highTime < io_exit)
+		io_exit = highTime;
+	return io_enter <= io_exit;
+}
+// Perform a sweep test by treating the circle's center as moving into the rectangle grown by the circle's radius, which has rounded corners.
+// Unlike the general polygon sweep, this works directly on the rectangle's sides, so it needs no polygon or edge normals.
+inline CollisionResult _circle_rect_sweep(const Circle& circle, const Rect& rect, Coord2 offset, Coord2 delta, Coord2& out_norm, gFloat& out_t) {
+	const Coord2 circlePos = circle.center + offset;
+	const gFloat radiusEps = circle.radius - constants::EPSILON; // Radius with eps subtracted, as with polygons.
+	// Find when the center is inside the grown rectangle's bounding box.
+	gFloat enterTime(0), exitTime(MaxTime);
+	Coord2 enterNorm;
+	if (!_clip_to_sides(circlePos.x, delta.x, rect.left() - radiusEps, rect.right() + radiusEps, Coord2(-1, 0), enterTime, exitTime, enterNorm) ||
+		!_clip_to_sides(circlePos.y, delta.y, rect.top() - radiusEps, rect.bottom() + radiusEps, Coord2(0, -1), enterTime, exitTime, enterNorm))
+		return CollisionResult::None;
+	const Coord2 enterPos(circlePos + delta * enterTime);
+	const bool isBesideX(enterPos.x < rect.left() || enterPos.x > rect.right());
+	const bool isBesideY(enterPos.y < rect.top() || enterPos.y > rect.bottom());
+	if (!isBesideX || !isBesideY) { // Entered the box through one of the grown rectangle's sides.
+		if (enterNorm.isZero())
+			return CollisionResult::None; // Started inside the grown rectangle, which means they overlap by less than the radius epsilon.
+		out_norm = enterNorm;
+		out_t = enterTime;
+		return CollisionResult::Sweep;
+	}
+	// Entered (or started in) the box by one of its corners, outside the grown rectangle. The center can only reach the rounded corner there.
+	const Coord2 corner(enterPos.x < rect.left() ? rect.left() : rect.right(), enterPos.y < rect.top() ? rect.top() : rect.bottom());
+	const gFloat deltaMag2 = delta.magnitude2();
+	const gFloat deltaMag = std::sqrt(deltaMag2);
+	return _collides_with_vertex(circlePos, corner, delta / deltaMag, deltaMag2, deltaMag, radiusEps, out_norm, out_t);
+}
 
-inline CollisionResult _circle_poly(const Circle& circle, const Polygon& poly, Coord2 offset, Coord2 delta, Coord2& out_norm, gFloat& out_t) {
-	// Do bounds test, and full MinimumTranslationVector test if that passes.
+inline CollisionResult _circle_poly(const Circle& circle, const PolygonView& poly, Coord2 offset, Coord2 delta, Coord2& out_norm, gFloat& out_t) {
+	// Do bounds test, and find the MinimumTranslationVector from the polygon's closest feature if that passes.
 	if (overlaps(circle.getAABB() + offset, poly.getAABB()) && overlaps(circle, offset, poly, Coord2(0, 0), out_norm, out_t))
 		return CollisionResult::MinimumTranslationVector;
 	return _circle_poly_sweep(circle, poly, offset, delta, out_norm, out_t);
 }
 inline CollisionResult _circle_rect(const Circle& circle, const Rect& rect, Coord2 offset, Coord2 delta, Coord2& out_norm, gFloat& out_t) {
 	// Do bounds test, and full MinimumTranslationVector test if that passes.
-	if (overlaps(circle.getAABB() + offset, rect) && overlaps(circle, offset, rect, Coord2(0, 0), out_norm, out_t))
+	if (overlaps(circle.getAABB() + offset, rect) && sat::overlaps(circle, offset, rect, Coord2(0, 0), out_norm, out_t))
 		return CollisionResult::MinimumTranslationVector;
-	return _circle_poly_sweep(circle, rect.toPoly(), offset, delta, out_norm, out_t);
+	return _circle_rect_sweep(circle, rect, offset, delta, out_norm, out_t);
 }
-inline CollisionResult _handle_circle_collisions(const Circle& circle, ConstShapeRef other, Coord2 offset, Coord2 delta, Coord2& out_norm, gFloat& out_t) {
-	switch (other.type()) {
-		case ShapeType::Rectangle:
-			return _circle_rect(circle, other.rect(), offset, delta, out_norm, out_t);
-		case ShapeType::Polygon:
-			return _circle_poly(circle, other.poly(), offset, delta, out_norm, out_t);
-		case ShapeType::Circle:
-			return _circle_circle(circle, other.circle(), offset, delta, out_norm, out_t);
-	}
-	DBG_ERR("Unhandled shape type for circle collision. Ignoring.");
-	return CollisionResult::None;
+template <typename Other>
+inline CollisionResult _handle_circle_collisions(const Circle& circle, const Other& other, Coord2 offset, Coord2 delta, Coord2& out_norm, gFloat& out_t) {
+	if constexpr (std::is_same_v<Other, Rect>)
+		return _circle_rect(circle, other, offset, delta, out_norm, out_t);
+	else if constexpr (std::is_same_v<Other, PolygonView>)
+		return _circle_poly(circle, other, offset, delta, out_norm, out_t);
+	else
+		return _circle_circle(circle, other, offset, delta, out_norm, out_t);
 }
+} // namespace
 
+namespace { // Hybrid SAT sweep tests.
 // Tests the axes of one polygon against the other using SAT. Checks if they are currently overlapping, or will overlap in the future (SAT test and sweep test).
 // Note that out_enterTime, out_exitTime, and out_mtv_dist need to be set to defaults on the first call.
-// axes        - the separating axes for these shapes.
+// numAxes     - the number of separating axes for these shapes.
+// twoSided    - which of the axes stand for both of their directions (see shape_pairs::TwoSidedAxes).
+// project     - called as project(i, projFirst, projSecond) to give the i-th axis, and set each shape's projection on it.
 // offset      - the position of first - second.
 // delta       - the delta of first - second (we act as if only first is moving).
 // out_norm    - the normal of collision, or direction of separation for the case where the shapes are already overlapping.
 // out_t       - the time of collision, or the distance to move for the case where the shapes are already overlapping.
+// out_axis    - the index of the last axis tested. For None results, the axis that ruled out a collision.
 // Returns the type of collision: None, a current MinimumTranslationVector collision, or a future Sweep collision on the interval [0, MAX].
-inline CollisionResult _perform_hybrid_SAT(const Shape& first, const Shape& second, const std::vector<Coord2>& axes, Coord2 offset,
-	Coord2 delta, Coord2& out_norm, gFloat& out_t) {
+template <typename ProjectOnAxis>
+inline CollisionResult _hybrid_SAT(std::size_t numAxes, shape_pairs::TwoSidedAxes twoSided, ProjectOnAxis project, Coord2 offset,
+	Coord2 delta, Coord2& out_norm, gFloat& out_t, std::size_t& out_axis) {
 	bool areCurrentlyOverlapping = true; // Start by assuming they are overlapping.
 	gFloat mtv_dist(-1), testDist, overlap1, overlap2;
 	gFloat speed, enterTime(-1), exitTime(MaxTime), testEnter, testExit;
 	Coord2 mtv_norm, sweep_norm;
 	Projection projFirst, projSecond;
-	for (std::size_t i = 0; i < axes.size(); ++i) {
-		projFirst = first.getProjection(axes[i]);
-		projSecond = second.getProjection(axes[i]);
-		projFirst += offset.dot(axes[i]); // Apply offset between the two polygons' positions.
+	for (std::size_t i = 0; i < numAxes; ++i) {
+		out_axis = i;
+		const Coord2 axis(project(i, projFirst, projSecond));
+		projFirst += offset.dot(axis); // Apply offset between the two polygons' positions.
 		overlap1 = projFirst.max - projSecond.min - constants::EPSILON;
 		overlap2 = projSecond.max - projFirst.min - constants::EPSILON;
-		speed = delta.dot(axes[i]); // Speed projected along this axis.
+		speed = delta.dot(axis); // Speed projected along this axis.
 		if (overlap1 < 0.0f || overlap2 < 0.0f) { // Not currently overlapping.
 			areCurrentlyOverlapping = false;
 			if (speed == 0)
@@ -213,7 +265,7 @@ inline CollisionResult _perform_hybrid_SAT(const Shape& first, const Shape& seco
 			if (testEnter > enterTime) {
 				enterTime = testEnter; // We want the latest time: the first time when all axes overlap.
 				// The last axis to overlap will have the collision normal.
-				sweep_norm = projFirst.min < projSecond.min ? -axes[i] : axes[i]; // Collision normal is relative to the first shape.
+				sweep_norm = projFirst.min < projSecond.min ? -axis : axis; // Collision normal is relative to the first shape.
 			}
 			if (testExit < exitTime)
 				exitTime = testExit; // Keep track of earliest exit time: some axis may stop overlapping before all axes overlap.
@@ -228,10 +280,11 @@ inline CollisionResult _perform_hybrid_SAT(const Shape& first, const Shape& seco
 					return CollisionResult::None;
 			}
 			if (areCurrentlyOverlapping) { // Regular MinimumTranslationVector checks.
-				testDist = (projFirst.min < projSecond.min ? overlap1 : overlap2) + constants::EPSILON; // Find separation for this axis.
+				const bool isNegative(shape_pairs::pushesOutNegative(projFirst, projSecond, overlap1, overlap2, shape_pairs::isTwoSided(twoSided, i)));
+				testDist = (isNegative ? overlap1 : overlap2) + constants::EPSILON; // Find separation for this axis.
 				if (mtv_dist == -1 || testDist < mtv_dist) {
 					mtv_dist = testDist;
-					mtv_norm = projFirst.min < projSecond.min ? -axes[i] : axes[i]; // Pushout direction for the first shape.
+					mtv_norm = isNegative ? -axis : axis; // Pushout direction for the first shape.
 				}
 			}
 		}
@@ -246,25 +299,134 @@ inline CollisionResult _perform_hybrid_SAT(const Shape& first, const Shape& seco
 	return CollisionResult::Sweep;
 }
 
+template <typename First, typename Second>
+inline CollisionResult _perform_hybrid_SAT(const First& first, const Second& second, const sat::AxisBuffer& axes, shape_pairs::TwoSidedAxes twoSided, Coord2 offset,
+	Coord2 delta, Coord2& out_norm, gFloat& out_t, std::size_t& out_axis) {
+	const auto project = [&first, &second, &axes](std::size_t i, Projection& projFirst, Projection& projSecond) {
+		projFirst = shape_pairs::project(first, axes[i]);
+		projSecond = shape_pairs::project(second, axes[i]);
+		return axes[i];
+	};
+	return _hybrid_SAT(axes.size(), twoSided, project, offset, delta, out_norm, out_t, out_axis);
+}
+
+// Rectangles are axis-aligned, so their projections on the x and y axes are their sides. Sweep them on just those axes, without
+// finding separating axes, with the same arithmetic as the general SAT tests.
+inline CollisionResult _rect_rect(const Rect& first, const Rect& second, Coord2 offset, Coord2 delta, Coord2& out_norm, gFloat& out_t) {
+	const auto project = [&first, &second](std::size_t i, Projection& projFirst, Projection& projSecond) {
+		if (i == 0) {
+			projFirst = Projection(first.left(), first.right());
+			projSecond = Projection(second.left(), second.right());
+			return Coord2(1, 0);
+		}
+		projFirst = Projection(first.top(), first.bottom());
+		projSecond = Projection(second.top(), second.bottom());
+		return Coord2(0, 1);
+	};
+	std::size_t lastAxis(0);
+	return _hybrid_SAT(2, 0, project, offset, delta, out_norm, out_t, lastAxis);
+}
+
+// Check if the shapes won't collide on the interval [0, MAX] because they are separated on an axis, and don't close the gap on it in time.
+// Matches the tests in _perform_hybrid_SAT for a single axis.
+template <typename First, typename Second>
+inline bool _rules_out_collision(const First& first, const Second& second, Coord2 axis, Coord2 offset, Coord2 delta) {
+	Projection projFirst(shape_pairs::project(first, axis));
+	const Projection projSecond(shape_pairs::project(second, axis));
+	projFirst += offset.dot(axis);
+	const gFloat overlap1(projFirst.max - projSecond.min - constants::EPSILON);
+	const gFloat overlap2(projSecond.max - projFirst.min - constants::EPSILON);
+	if (overlap1 >= 0.0f && overlap2 >= 0.0f)
+		return false; // Currently overlapping on this axis.
+	const gFloat speed(delta.dot(axis));
+	if (speed == 0)
+		return true;
+	const gFloat enterTime((overlap1 < 0.0f ? -overlap1 : overlap2) / speed);
+	return enterTime < 0.0f || enterTime > MaxTime;
+}
+
+// Sweep kernels for each pair of shape types, selected with shape_pairs::select.
+// Offset is first's position - second's position, and delta is the non-zero delta of first - second.
+template <typename First, typename Second>
+struct CollidesKernel {
+	static CollisionResult run(ConstShapeRef firstRef, ConstShapeRef secondRef, Coord2 offset, Coord2 delta, Coord2& out_norm, gFloat& out_t) {
+		const First& first(shape_pairs::as<First>(firstRef));
+		const Second& second(shape_pairs::as<Second>(secondRef));
+		if constexpr (std::is_same_v<First, Circle>) {
+			return _handle_circle_collisions(first, second, offset, delta, out_norm, out_t);
+		} else if constexpr (std::is_same_v<Second, Circle>) {
+			const CollisionResult r = _handle_circle_collisions(second, first, -offset, -delta, out_norm, out_t);
+			if (r != CollisionResult::None)
+				out_norm = -out_norm;
+			return r;
+		} else if constexpr (std::is_same_v<First, Rect> && std::is_same_v<Second, Rect>) {
+			return _rect_rect(first, second, offset, delta, out_norm, out_t);
+		} else {
+			sat::AxisBuffer axes;
+			shape_pairs::TwoSidedAxes twoSided;
+			shape_pairs::getSeparatingAxes(first, second, offset, axes, twoSided);
+			std::size_t lastAxis(0);
+			return _perform_hybrid_SAT(first, second, axes, twoSided, offset, delta, out_norm, out_t, lastAxis);
+		}
+	}
+};
+
+// Circles aren't cached, and are sent to the plain collides() before this is selected.
+template <typename First, typename Second>
+struct CachedCollidesKernel {
+	static CollisionResult run(ConstShapeRef firstRef, ConstShapeRef secondRef, Coord2 offset, Coord2 delta,
+		Coord2& out_norm, gFloat& out_t, SeparatingAxisCache& cache) {
+		const First& first(shape_pairs::as<First>(firstRef));
+		const Second& second(shape_pairs::as<Second>(secondRef));
+		if (cache.testCachedAxis(firstRef, secondRef, [&](Coord2 axis) { return _rules_out_collision(first, second, axis, offset, delta); }))
+			return CollisionResult::None;
+		sat::AxisBuffer axes;
+		shape_pairs::TwoSidedAxes twoSided;
+		shape_pairs::getSeparatingAxes(first, second, offset, axes, twoSided);
+		std::size_t lastAxis(0);
+		const CollisionResult result(_perform_hybrid_SAT(first, second, axes, twoSided, offset, delta, out_norm, out_t, lastAxis));
+		if (result != CollisionResult::None)
+			cache.store(firstRef, secondRef, out_norm);
+		else if (!axes.empty())
+			cache.store(firstRef, secondRef, axes[lastAxis]);
+		return result;
+	}
+};
+
+constexpr auto COLLIDES_KERNELS = shape_pairs::makeTable<CollidesKernel>();
+constexpr auto CACHED_COLLIDES_KERNELS = shape_pairs::makeTable<CachedCollidesKernel>();
+} // namespace
+
 CollisionResult collides(ConstShapeRef first, Coord2 firstPos, Coord2 firstDelta,
+	ConstShapeRef second, Coord2 secondPos, Coord2& out_norm, gFloat& out_t) {
+	if (gjk::isPreferred(first, second))
+		return gjk::collides(first, firstPos, firstDelta, second, secondPos, out_norm, out_t);
+	return sat::collides(first, firstPos, firstDelta, second, secondPos, out_norm, out_t);
+}
+
+CollisionResult sat::collides(ConstShapeRef first, Coord2 firstPos, Coord2 firstDelta,
 	ConstShapeRef second, Coord2 secondPos, Coord2& out_norm, gFloat& out_t) {
 	if (firstDelta.isZero()) // No movement, just do regular SAT.
-		return overlaps(first, firstPos, second, secondPos, out_norm, out_t) ? CollisionResult::MinimumTranslationVector : CollisionResult::None;
-	const Coord2 offset(firstPos - secondPos);
-	// Handle circle cases.
-	if (first.type() == ShapeType::Circle)
-		return _handle_circle_collisions(first.circle(), second, offset, firstDelta, out_norm, out_t);
-	if (second.type() == ShapeType::Circle) {
-		CollisionResult r = _handle_circle_collisions(second.circle(), first, -offset, -firstDelta, out_norm, out_t);
-		if (r != CollisionResult::None)
-			out_norm = -out_norm;
-		return r;
-	}
-	return _perform_hybrid_SAT(first.shape(), second.shape(), sat::getSeparatingAxes(first, second, offset), offset, firstDelta, out_norm, out_t);
+		return sat::overlaps(first, firstPos, second, secondPos, out_norm, out_t) ? CollisionResult::MinimumTranslationVector : CollisionResult::None;
+	return shape_pairs::select(COLLIDES_KERNELS, first, second)(first, second, firstPos - secondPos, firstDelta, out_norm, out_t);
 }
 
 CollisionResult collides(ConstShapeRef first, Coord2 firstPos, Coord2 firstDelta,
 	ConstShapeRef second, Coord2 secondPos, Coord2 secondDelta, Coord2& out_norm, gFloat& out_t) {
 	return collides(first, firstPos, firstDelta - secondDelta, second, secondPos, out_norm, out_t);
 }
+
+CollisionResult collides(ConstShapeRef first, Coord2 firstPos, Coord2 firstDelta,
+	ConstShapeRef second, Coord2 secondPos, Coord2& out_norm, gFloat& out_t, SeparatingAxisCache& cache) {
+	if (firstDelta.isZero()) // No movement, just do regular SAT.
+		return overlaps(first, firstPos, second, secondPos, out_norm, out_t, cache) ? CollisionResult::MinimumTranslationVector : CollisionResult::None;
+	if (first.type() == ShapeType::Circle || second.type() == ShapeType::Circle)
+		return collides(first, firstPos, firstDelta, second, secondPos, out_norm, out_t);
+	return shape_pairs::select(CACHED_COLLIDES_KERNELS, first, second)(first, second, firstPos - secondPos, firstDelta, out_norm, out_t, cache);
+}
+
+CollisionResult collides(ConstShapeRef first, Coord2 firstPos, Coord2 firstDelta,
+	ConstShapeRef second, Coord2 secondPos, Coord2 secondDelta, Coord2& out_norm, gFloat& out_t, SeparatingAxisCache& cache) {
+	return collides(first, firstPos, firstDelta - secondDelta, second, secondPos, out_norm, out_t, cache);
+}
 } // namespace ctp
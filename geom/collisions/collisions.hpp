@@ -7,6 +7,7 @@
 namespace ctp {
 class ConstShapeRef;
 class Circle;
+class SeparatingAxisCache;
 // Describes the type of collision.
 enum class CollisionResult {
 	None, // No collision.
@@ -31,6 +32,8 @@ CollisionResult collides(const Circle& first, Coord2 firstPos, Coord2 firstDelta
 
 
 // ---------------------------------------- Generic Case ----------------------------------------
+// Pairs with at least gjk::AUTO_VERTEX_THRESHOLD vertices between them are tested with GJK, and the rest with SAT.
+// To choose per call, use sat::collides() or gjk::collides().
 
 // Find when a collision will occur for one moving and one stationary shape, and the normal of their collision, if they collide.
 // Takes shapes, their positions, and the first shape's movement vector.
@@ -48,6 +51,14 @@ CollisionResult collides(ConstShapeRef first, Coord2 firstPos, Coord2 firstDelta
 // Returns the type of collision: None, a current MinimumTranslationVector collision, or a future Sweep collision on the interval [0, MAX].
 CollisionResult collides(ConstShapeRef first, Coord2 firstPos, Coord2 firstDelta,
 	ConstShapeRef second, Coord2 secondPos, Coord2 secondDelta, Coord2& out_norm, gFloat& out_t);
+
+// As above, but test the pair's axis from the cache first, and store the axis that ruled out a collision, or the collision's
+// normal, for next time. Worthwhile when the same pairs are tested repeatedly, e.g. every frame.
+// Moving circles have closed-form tests that don't use separating axes, so they don't use the cache.
+CollisionResult collides(ConstShapeRef first, Coord2 firstPos, Coord2 firstDelta,
+	ConstShapeRef second, Coord2 secondPos, Coord2& out_norm, gFloat& out_t, SeparatingAxisCache& cache);
+CollisionResult collides(ConstShapeRef first, Coord2 firstPos, Coord2 firstDelta,
+	ConstShapeRef second, Coord2 secondPos, Coord2 secondDelta, Coord2& out_norm, gFloat& out_t, SeparatingAxisCache& cache);
 }
 
 #endif // INCLUDE_GEOM_COLLISIONS_HPP
@@ -0,0 +1,103 @@
+#include "overlapping_pairs.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <future>
+#include <thread>
+#include <utility>
+
+#include "Collidable.hpp"
+#include "broadphase.hpp"
+#include "../units.hpp"
+#include "../intersections/overlaps.hpp"
+#include "../shapes/ShapeContainer.hpp"
+
+namespace ctp {
+namespace {
+// Fewest candidate pairs to give each thread: below this, starting a thread costs more than it saves.
+constexpr std::size_t MIN_PAIRS_PER_THREAD = 256;
+
+struct Item {
+	broadphase::AABB aabb;
+	std::size_t index; // Index in the given collidables.
+};
+using Candidate = std::pair<std::size_t, std::size_t>; // Indices of the collidables, in order.
+
+// Get the bounding boxes of the collidables, skipping nulls and repeats.
+std::vector<Item> _get_items(const std::vector<Collidable*>& collidables) {
+	std::vector<std::pair<const Collidable*, std::size_t>> sorted;
+	sorted.reserve(collidables.size());
+	for (std::size_t i = 0; i < collidables.size(); ++i) {
+		if (collidables[i])
+			sorted.emplace_back(collidables[i], i);
+	}
+	// Sorting by pointer then index puts the first of any repeats first.
+	std::sort(sorted.begin(), sorted.end());
+	std::vector<Item> items;
+	items.reserve(sorted.size());
+	for (std::size_t i = 0; i < sorted.size(); ++i) {
+		if (i == 0 || sorted[i].first != sorted[i - 1].first)
+			items.push_back(Item{broadphase::getAABB(*sorted[i].first), sorted[i].second});
+	}
+	return items;
+}
+
+// Sort the boxes along the axis they are most spread out on, and sweep along it to find pairs of boxes that overlap.
+std::vector<Candidate> _find_candidates(std::vector<Item>& items) {
+	const auto getAABB = [](const Item& item) { return &item.aabb; };
+	const broadphase::Axis axis(broadphase::chooseAxis(items.begin(), items.end(), getAABB, broadphase::Axis::X));
+	std::sort(items.begin(), items.end(), [axis](const Item& a, const Item& b) { return broadphase::minOn(a.aabb, axis) < broadphase::minOn(b.aabb, axis); });
+	std::vector<Candidate> candidates;
+	broadphase::sweepSorted(items.begin(), items.end(), axis, getAABB, [&candidates](const Item& a, const Item& b) {
+		candidates.emplace_back(std::min(a.index, b.index), std::max(a.index, b.index));
+	});
+	// Report pairs in the order of the given collidables, however the boxes were sorted.
+	std::sort(candidates.begin(), candidates.end());
+	return candidates;
+}
+
+// Test candidates [first, last) with the narrowphase.
+std::vector<OverlappingPair> _test_candidates(const std::vector<Collidable*>& collidables, const std::vector<Candidate>& candidates,
+                                              std::size_t first, std::size_t last, bool findMTV) {
+	std::vector<OverlappingPair> pairs;
+	for (std::size_t i = first; i < last; ++i) {
+		Collidable* a(collidables[candidates[i].first]);
+		Collidable* b(collidables[candidates[i].second]);
+		OverlappingPair pair;
+		pair.first = a;
+		pair.second = b;
+		const bool isOverlapping(findMTV
+			? overlaps(a->getCollider(), a->getPosition(), b->getCollider(), b->getPosition(), pair.normal, pair.dist)
+			: overlaps(a->getCollider(), a->getPosition(), b->getCollider(), b->getPosition()));
+		if (isOverlapping)
+			pairs.push_back(pair);
+	}
+	return pairs;
+}
+}
+
+std::vector<OverlappingPair> findOverlappingPairs(const std::vector<Collidable*>& collidables, bool findMTV, unsigned int threads) {
+	std::vector<Item> items(_get_items(collidables));
+	const std::vector<Candidate> candidates(_find_candidates(items));
+	if (threads == 0)
+		threads = std::max(1u, std::thread::hardware_concurrency());
+	threads = static_cast<unsigned int>(std::max<std::size_t>(1, std::min<std::size_t>(threads, candidates.size() / MIN_PAIRS_PER_THREAD)));
+	if (threads == 1)
+		return _test_candidates(collidables, candidates, 0, candidates.size(), findMTV);
+
+	// Each thread tests a contiguous run of candidates, so joining the results in order keeps the pairs sorted.
+	std::vector<std::future<std::vector<OverlappingPair>>> results;
+	const std::size_t perThread((candidates.size() + threads - 1) / threads);
+	for (std::size_t first = perThread; first < candidates.size(); first += perThread) {
+		const std::size_t last(std::min(candidates.size(), first + perThread));
+		results.push_back(std::async(std::launch::async, _test_candidates, std::cref(collidables), std::cref(candidates), first, last, findMTV));
+	}
+	std::vector<OverlappingPair> pairs(_test_candidates(collidables, candidates, 0, std::min(candidates.size(), perThread), findMTV));
+	for (auto& result : results) {
+		const std::vector<OverlappingPair> part(result.get());
+		pairs.insert(pairs.end(), part.begin(), part.end());
+	}
+	return pairs;
+}
+}
@@ -0,0 +1,29 @@
+#ifndef INCLUDE_GEOM_OVERLAPPING_PAIRS_HPP
+#define INCLUDE_GEOM_OVERLAPPING_PAIRS_HPP
+
+#include <vector>
+
+#include "../units.hpp"
+
+// Finding every pair of overlapping collidables in a scene.
+// As with overlaps(), "touching" shapes are not considered overlapping.
+namespace ctp {
+class Collidable;
+
+// Two collidables that overlap.
+struct OverlappingPair {
+	Collidable* first{nullptr};
+	Collidable* second{nullptr};
+	// Minimum translation vector to move first out of second. Only set if requested.
+	Coord2 normal;
+	gFloat dist{0};
+};
+
+// Find every pair of the given collidables that overlap.
+// Each pair is found once, with first coming before second in collidables. Null and repeated collidables are skipped.
+// Candidate pairs are found with a sort and sweep of bounding boxes, then tested with overlaps() on multiple threads.
+// findMTV    - Also find the minimum translation vector of each pair.
+// threads    - How many threads to test pairs with. 0 uses the hardware's concurrency.
+std::vector<OverlappingPair> findOverlappingPairs(const std::vector<Collidable*>& collidables, bool findMTV = false, unsigned int threads = 0);
+}
+#endif // INCLUDE_GEOM_OVERLAPPING_PAIRS_HPP
@@ -0,0 +1,54 @@
+#include "RectBatch.hpp"
+
+#include <limits>
+
+#include "../simd.hpp"
+#include "../shapes/Rectangle.hpp"
+
+namespace ctp {
+namespace {
+// Padding rectangles have every side at infinity, so they are far from anything real. Ray tests mask them off.
+constexpr gFloat PADDING = std::numeric_limits<gFloat>::infinity();
+}
+
+RectBatch::RectBatch(const std::vector<Rect>& rects) {
+	reserve(rects.size());
+	for (const Rect& rect : rects)
+		add(rect);
+}
+
+void RectBatch::add(const Rect& rect, Coord2 pos) {
+	if (size_ == lefts_.size()) {
+		const std::size_t padded = size_ + simd::LANES;
+		lefts_.resize(padded, PADDING);
+		rights_.resize(padded, PADDING);
+		tops_.resize(padded, PADDING);
+		bottoms_.resize(padded, PADDING);
+	}
+	lefts_[size_] = rect.left() + pos.x;
+	rights_[size_] = rect.right() + pos.x;
+	tops_[size_] = rect.top() + pos.y;
+	bottoms_[size_] = rect.bottom() + pos.y;
+	++size_;
+}
+
+void RectBatch::clear() noexcept {
+	lefts_.clear();
+	rights_.clear();
+	tops_.clear();
+	bottoms_.clear();
+	size_ = 0;
+}
+
+void RectBatch::reserve(std::size_t size) {
+	const std::size_t padded = simd::paddedSize(size);
+	lefts_.reserve(padded);
+	rights_.reserve(padded);
+	tops_.reserve(padded);
+	bottoms_.reserve(padded);
+}
+
+Rect RectBatch::operator[](std::size_t index) const {
+	return Rect(lefts_[index], tops_[index], rights_[index] - lefts_[index], bottoms_[index] - tops_[index]);
+}
+}
@@ -0,0 +1,49 @@
+#ifndef INCLUDE_GEOM_RECT_BATCH_HPP
+#define INCLUDE_GEOM_RECT_BATCH_HPP
+
+#include <cstddef>
+#include <vector>
+
+#include "../units.hpp"
+
+// Axis-aligned rectangles stored as structure of arrays, so rays can be tested against a SIMD register of them at a time.
+// Meant for large sets of rectangles that rarely change, such as the tiles of a map.
+// Each array is padded to a whole number of registers with rectangles at infinity, which tests of the batch ignore.
+namespace ctp {
+class Rect;
+
+class RectBatch {
+public:
+	RectBatch() = default;
+	explicit RectBatch(const std::vector<Rect>& rects);
+
+	// Add a rectangle at a position. Rectangles are indexed in the order they are added.
+	void add(const Rect& rect, Coord2 pos = Coord2(0, 0));
+	// Remove every rectangle.
+	void clear() noexcept;
+	// Reserve space for a number of rectangles.
+	void reserve(std::size_t size);
+
+	// Get a rectangle in the batch, at its position.
+	Rect operator[](std::size_t index) const;
+	// Get the number of rectangles in the batch.
+	std::size_t size() const noexcept { return size_; }
+	bool empty() const noexcept { return size_ == 0; }
+
+	// Get the padded arrays of each side of the rectangles. They hold a multiple of simd::LANES values.
+	const gFloat* lefts() const noexcept { return lefts_.data(); }
+	const gFloat* rights() const noexcept { return rights_.data(); }
+	const gFloat* tops() const noexcept { return tops_.data(); }
+	const gFloat* bottoms() const noexcept { return bottoms_.data(); }
+	// Get the size of the padded arrays.
+	std::size_t paddedSize() const noexcept { return lefts_.size(); }
+
+private:
+	std::vector<gFloat> lefts_;
+	std::vector<gFloat> rights_;
+	std::vector<gFloat> tops_;
+	std::vector<gFloat> bottoms_;
+	std::size_t size_{0};
+};
+}
+#endif // INCLUDE_GEOM_RECT_BATCH_HPP
@@ -0,0 +1,74 @@
+#ifndef INCLUDE_GEOM_SEPARATING_AXIS_CACHE_HPP
+#define INCLUDE_GEOM_SEPARATING_AXIS_CACHE_HPP
+
+#include <cstddef>
+#include <functional>
+#include <unordered_map>
+#include <utility>
+
+#include "../units.hpp"
+#include "../shapes/ShapeContainer.hpp"
+
+// Remembers the last separating or minimum axis found for pairs of shapes, so repeated SAT tests can try it first.
+// Shapes that move a little between tests are usually separated by the same axis as last time, so with a cache,
+// a pair that is still separated is ruled out after projecting onto one axis instead of all of them.
+// Pairs are keyed by the addresses of their shapes, in either order. A stale axis (from a shape that has since changed,
+// or from a destroyed shape whose address was reused) is never wrong: any axis that separates two shapes proves they
+// don't overlap, and one that doesn't just counts as a miss.
+// Not thread safe: use one cache per thread.
+namespace ctp {
+class SeparatingAxisCache {
+public:
+	// Test the pair's cached axis first, recording a hit if it rules out the pair, or a miss otherwise.
+	// isSeparating - Given the cached axis, returns true if it proves the shapes don't collide.
+	// Returns true if the cached axis ruled out the pair, and the full test can be skipped.
+	template <typename IsSeparating>
+	bool testCachedAxis(ConstShapeRef first, ConstShapeRef second, IsSeparating isSeparating) {
+		const auto it = axes_.find(_key(first, second));
+		if (it != axes_.end() && isSeparating(it->second)) {
+			++hits_;
+			return true;
+		}
+		++misses_;
+		return false;
+	}
+	// Remember the axis to test first for a pair of shapes.
+	void store(ConstShapeRef first, ConstShapeRef second, Coord2 axis) { axes_[_key(first, second)] = axis; }
+	// Forget a pair of shapes. NOOP if the pair isn't cached.
+	void erase(ConstShapeRef first, ConstShapeRef second) { axes_.erase(_key(first, second)); }
+	// Forget every pair. Statistics are kept.
+	void clear() noexcept { axes_.clear(); }
+	// Get the number of cached pairs.
+	std::size_t size() const noexcept { return axes_.size(); }
+
+	// Statistics -----------------------------------------------------------
+
+	// Get the number of tests ruled out by a cached axis.
+	std::size_t hits() const noexcept { return hits_; }
+	// Get the number of tests that needed the full set of axes, including pairs with nothing cached.
+	std::size_t misses() const noexcept { return misses_; }
+	// Get the fraction of tests ruled out by a cached axis, or 0 if there haven't been any tests.
+	double hitRate() const noexcept { return hits_ + misses_ == 0 ? 0.0 : static_cast<double>(hits_) / static_cast<double>(hits_ + misses_); }
+	void resetStats() noexcept { hits_ = 0; misses_ = 0; }
+
+private:
+	using Key = std::pair<const void*, const void*>;
+	struct KeyHash {
+		std::size_t operator()(const Key& key) const noexcept {
+			const std::size_t first(std::hash<const void*>()(key.first));
+			return first ^ (std::hash<const void*>()(key.second) + 0x9e3779b9 + (first << 6) + (first >> 2));
+		}
+	};
+	// Order the shapes so a pair has the same key either way around.
+	static Key _key(ConstShapeRef first, ConstShapeRef second) noexcept {
+		const void* a(first.address());
+		const void* b(second.address());
+		return std::less<const void*>()(a, b) ? Key(a, b) : Key(b, a);
+	}
+
+	std::unordered_map<Key, Coord2, KeyHash> axes_;
+	std::size_t hits_{0};
+	std::size_t misses_{0};
+};
+}
+#endif // INCLUDE_GEOM_SEPARATING_AXIS_CACHE_HPP
@@ -0,0 +1,373 @@
+#include "gjk.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+#include "sat.hpp"
+#include "../small_vector.hpp"
+#include "../units.hpp"
+#include "../constants.hpp"
+#include "../debug_logger.hpp"
+#include "../shapes/ShapeContainer.hpp"
+#include "../shapes/Rectangle.hpp"
+#include "../shapes/Polygon.hpp"
+#include "../shapes/Circle.hpp"
+#include "../collisions/collisions.hpp"
+
+namespace ctp::gjk {
+namespace {
+constexpr int MAX_ITERATIONS = 64; // Guards against float error keeping GJK or EPA from converging.
+constexpr gFloat CONVERGENCE_TOLERANCE = 0.00001f; // Relative to the size of the points involved.
+constexpr gFloat MaxTime = 1.0f; // Max t for sweep tests. Using interval [0,1].
+
+std::size_t _vertex_count(ConstShapeRef shape) {
+	switch (shape.type()) {
+	case ShapeType::Rectangle: return 4;
+	case ShapeType::Polygon:   return shape.poly().size();
+	case ShapeType::Circle:    return 1;
+	case ShapeType::PooledPolygon: return shape.pooled().view().size();
+	}
+	return 0;
+}
+
+// The Minkowski difference of the two shapes, first - second, where offset is first's position - second's position.
+// The shapes overlap if it contains the origin, and its closest point to the origin gives their distance or penetration.
+struct MinkowskiDifference {
+	ConstShapeRef first;
+	ConstShapeRef second;
+	Coord2 offset;
+	Coord2 support(Coord2 dir) const { return gjk::support(first, dir) + offset - gjk::support(second, -dir); }
+};
+
+// Up to three points of the Minkowski difference, newest last.
+struct Simplex {
+	Coord2 points[3];
+	int size{0};
+	void push(Coord2 point) noexcept { points[size++] = point; }
+	bool contains(Coord2 point) const noexcept {
+		return std::find(points, points + size, point) != points + size;
+	}
+};
+
+// Find the point on the line through a and b closest to the origin.
+// Projecting onto the line's normal keeps the result perpendicular to the line, despite float error.
+Coord2 _closest_on_line(Coord2 a, Coord2 b) {
+	const Coord2 norm((b - a).perpCCW());
+	return norm * (norm.dot(a) / norm.magnitude2());
+}
+
+// Find the point of a simplex closest to the origin, and reduce the simplex to the points needed to describe it.
+// Returns the closest point, which is the origin if a triangle contains it.
+Coord2 _closest_to_origin(Simplex& simplex) {
+	if (simplex.size == 1)
+		return simplex.points[0];
+	if (simplex.size == 2) {
+		const Coord2 a(simplex.points[0]), b(simplex.points[1]);
+		const Coord2 ab(b - a);
+		const gFloat length2(ab.magnitude2());
+		const gFloat t(length2 == 0 ? 1 : -a.dot(ab) / length2);
+		if (t <= 0) {
+			simplex.size = 1;
+			return a;
+		}
+		if (t >= 1) {
+			simplex.points[0] = b;
+			simplex.size = 1;
+			return b;
+		}
+		return _closest_on_line(a, b);
+	}
+	// Closest point on a triangle, by finding which Voronoi region of the triangle the origin is in.
+	const Coord2 a(simplex.points[0]), b(simplex.points[1]), c(simplex.points[2]);
+	const Coord2 ab(b - a), ac(c - a);
+	const gFloat d1(-ab.dot(a)), d2(-ac.dot(a));
+	if (d1 <= 0 && d2 <= 0) {
+		simplex.size = 1;
+		return a;
+	}
+	const gFloat d3(-ab.dot(b)), d4(-ac.dot(b));
+	if (d3 >= 0 && d4 <= d3) {
+		simplex.points[0] = b;
+		simplex.size = 1;
+		return b;
+	}
+	const gFloat vc(d1 * d4 - d3 * d2);
+	if (vc <= 0 && d1 >= 0 && d3 <= 0) {
+		simplex.size = 2;
+		return _closest_on_line(a, b);
+	}
+	const gFloat d5(-ab.dot(c)), d6(-ac.dot(c));
+	if (d6 >= 0 && d5 <= d6) {
+		simplex.points[0] = c;
+		simplex.size = 1;
+		return c;
+	}
+	const gFloat vb(d5 * d2 - d1 * d6);
+	if (vb <= 0 && d2 >= 0 && d6 <= 0) {
+		simplex.points[1] = c;
+		simplex.size = 2;
+		return _closest_on_line(a, c);
+	}
+	const gFloat va(d3 * d6 - d5 * d4);
+	if (va <= 0 && d4 - d3 >= 0 && d5 - d6 >= 0) {
+		simplex.points[0] = c;
+		simplex.size = 2;
+		return _closest_on_line(b, c);
+	}
+	return Coord2(0, 0); // Inside the triangle.
+}
+
+enum class Status {
+	Separated,   // Farther apart than CONTACT_TOLERANCE.
+	Touching,    // Within CONTACT_TOLERANCE of touching, from either side.
+	Intersecting // The simplex is a triangle containing the origin.
+};
+
+// Run GJK to find the point on the Minkowski difference closest to the origin.
+// findDistance  - Keep going until out_closest is the closest point, rather than stopping once they are known to be separated.
+// out_simplex   - The final simplex. For intersecting shapes, a triangle containing the origin.
+// out_closest   - For separated shapes, the closest point found.
+Status _gjk(const MinkowskiDifference& md, bool findDistance, Simplex& out_simplex, Coord2& out_closest) {
+	constexpr gFloat tolerance2(CONTACT_TOLERANCE * CONTACT_TOLERANCE);
+	out_simplex.size = 0;
+	out_simplex.push(md.support(md.offset.isZero() ? Coord2(1, 0) : md.offset));
+	Coord2 v(out_simplex.points[0]);
+	for (int i = 0; i < MAX_ITERATIONS; ++i) {
+		const gFloat dist2(v.magnitude2());
+		if (dist2 <= tolerance2)
+			return Status::Touching;
+		const Coord2 w(md.support(-v));
+		// Everything in the Minkowski difference is at least v.dot(w) / |v| from the origin along v.
+		const gFloat lowerBound(v.dot(w));
+		if (!findDistance && lowerBound > CONTACT_TOLERANCE * std::sqrt(dist2)) {
+			out_closest = v;
+			return Status::Separated;
+		}
+		// Stop once w gets no closer to the origin along v than v itself.
+		if (dist2 - lowerBound <= CONVERGENCE_TOLERANCE * dist2 || out_simplex.contains(w))
+			break;
+		out_simplex.push(w);
+		v = _closest_to_origin(out_simplex);
+		if (out_simplex.size == 3)
+			return Status::Intersecting;
+	}
+	out_closest = v;
+	return v.magnitude2() <= tolerance2 ? Status::Touching : Status::Separated;
+}
+
+// Check if the origin is farther than CONTACT_TOLERANCE inside a triangle, so the shapes certainly overlap.
+bool _is_deep_inside(const Simplex& triangle) {
+	for (int i = 0; i < 3; ++i) {
+		const Coord2 a(triangle.points[i]), b(triangle.points[(i + 1) % 3]);
+		const Coord2 edge(b - a);
+		if (std::abs(edge.cross(a)) <= CONTACT_TOLERANCE * edge.magnitude())
+			return false;
+	}
+	return true;
+}
+
+// EPA adds a point each iteration, so its polytope never outgrows this and stays off the heap.
+using Polytope = SmallVector<Coord2, 3 + MAX_ITERATIONS>;
+
+// Run EPA from GJK's triangle to find the edge of the Minkowski difference closest to the origin.
+// out_norm   - The edge's outward normal.
+// out_depth  - The edge's distance from the origin.
+// Returns false if it didn't converge.
+bool _epa(const MinkowskiDifference& md, const Simplex& triangle, Coord2& out_norm, gFloat& out_depth) {
+	Polytope polytope;
+	for (const Coord2 point : triangle.points)
+		polytope.push_back(point);
+	// Wind like Polygon, so that perpCCW gives outward normals.
+	if ((polytope[1] - polytope[0]).cross(polytope[2] - polytope[0]) > 0)
+		std::swap(polytope[1], polytope[2]);
+	for (int i = 0; i < MAX_ITERATIONS; ++i) {
+		std::size_t closestEdge(0);
+		gFloat minDist(-1);
+		Coord2 norm;
+		for (std::size_t k = 0, size = polytope.size(); k < size; ++k) {
+			const Coord2 a(polytope[k]), b(polytope[k + 1 < size ? k + 1 : 0]);
+			const Coord2 edgeNorm((b - a).perpCCW().normalize());
+			if (edgeNorm.isZero())
+				continue; // Repeated point.
+			const gFloat dist(edgeNorm.dot(a));
+			if (minDist == -1 || dist < minDist) {
+				minDist = dist;
+				norm = edgeNorm;
+				closestEdge = k;
+			}
+		}
+		const Coord2 point(md.support(norm));
+		const gFloat scale(std::max({gFloat(1), std::abs(point.x), std::abs(point.y)}));
+		if (point.dot(norm) - minDist <= CONVERGENCE_TOLERANCE * scale) { // The edge is on the Minkowski difference's boundary.
+			out_norm = norm;
+			out_depth = minDist;
+			return true;
+		}
+		// Insert the point after the closest edge's first point, splitting that edge.
+		polytope.push_back(point);
+		std::rotate(polytope.begin() + closestEdge + 1, polytope.end() - 1, polytope.end());
+	}
+	DBG_WARN("EPA did not converge.");
+	return false;
+}
+
+enum class RaycastResult { Miss, Hit, Inconclusive };
+
+// Cast a ray from the origin along dir against the Minkowski difference, to find when on [0, 1] it enters it.
+// out_t     - The time of entry, as a fraction of dir.
+// out_norm  - The outward normal of the Minkowski difference where it was entered.
+RaycastResult _raycast(const MinkowskiDifference& md, Coord2 dir, gFloat& out_t, Coord2& out_norm) {
+	constexpr gFloat tolerance2(CONTACT_TOLERANCE * CONTACT_TOLERANCE * 0.01f);
+	gFloat lambda(0);
+	Coord2 x, norm;
+	Simplex simplex;
+	Coord2 v(x - md.support(dir));
+	for (int i = 0; i < MAX_ITERATIONS && v.magnitude2() > tolerance2; ++i) {
+		const Coord2 point(md.support(v));
+		const Coord2 w(x - point);
+		const gFloat vw(v.dot(w));
+		if (vw > 0) { // x is outside point's supporting plane: advance the ray to it.
+			const gFloat vr(v.dot(dir));
+			if (vr >= 0)
+				return RaycastResult::Miss; // Moving away from the plane.
+			lambda -= vw / vr;
+			if (lambda > MaxTime)
+				return RaycastResult::Miss;
+			x = dir * lambda;
+			norm = v;
+		}
+		if (simplex.contains(point)) {
+			if (vw <= 0)
+				break; // No progress: x is as close as float precision allows.
+		} else {
+			simplex.push(point);
+		}
+		// Find the closest point on the simplex to x.
+		for (int k = 0; k < simplex.size; ++k)
+			simplex.points[k] -= x;
+		v = -_closest_to_origin(simplex);
+		for (int k = 0; k < simplex.size; ++k)
+			simplex.points[k] += x;
+	}
+	if (norm.isZero())
+		return RaycastResult::Inconclusive;
+	// When entering through an edge, its normal is more accurate than the last separating direction.
+	if (simplex.size == 2) {
+		const Coord2 edgeNorm((simplex.points[1] - simplex.points[0]).perpCCW());
+		norm = edgeNorm.dot(norm) < 0 ? -edgeNorm : edgeNorm;
+	}
+	out_t = lambda;
+	out_norm = norm.normalize();
+	return RaycastResult::Hit;
+}
+} // namespace
+
+bool isPreferred(ConstShapeRef first, ConstShapeRef second) {
+	return _vertex_count(first) + _vertex_count(second) >= AUTO_VERTEX_THRESHOLD;
+}
+
+Coord2 support(ConstShapeRef shape, Coord2 dir) {
+	switch (shape.type()) {
+	case ShapeType::Rectangle:
+	{
+		const Rect& rect(shape.rect());
+		return Coord2(dir.x < 0 ? rect.left() : rect.right(), dir.y < 0 ? rect.top() : rect.bottom());
+	}
+	case ShapeType::Polygon:
+	{
+		const Polygon& poly(shape.poly());
+		return poly[poly.getSupportIndex(dir)];
+	}
+	case ShapeType::Circle:
+		return shape.circle().center + dir.normalize() * shape.circle().radius;
+	case ShapeType::PooledPolygon:
+	{
+		const PolygonView poly(shape.pooled().view());
+		return poly[poly.getSupportIndex(dir)];
+	}
+	}
+	DBG_ERR("Unhandled shape type for support function. Using its polygon.");
+	return support(toPoly(shape), dir);
+}
+
+gFloat distance(ConstShapeRef first, Coord2 firstPos, ConstShapeRef second, Coord2 secondPos) {
+	const MinkowskiDifference md{first, second, firstPos - secondPos};
+	Simplex simplex;
+	Coord2 closest;
+	return _gjk(md, true, simplex, closest) == Status::Separated ? closest.magnitude() : 0;
+}
+
+bool overlaps(ConstShapeRef first, Coord2 firstPos, ConstShapeRef second, Coord2 secondPos) {
+	const MinkowskiDifference md{first, second, firstPos - secondPos};
+	Simplex simplex;
+	Coord2 closest, norm;
+	gFloat depth;
+	switch (_gjk(md, false, simplex, closest)) {
+	case Status::Separated:
+		return false;
+	case Status::Intersecting:
+		if (_is_deep_inside(simplex) || (_epa(md, simplex, norm, depth) && depth > CONTACT_TOLERANCE))
+			return true;
+		break;
+	case Status::Touching:
+		break;
+	}
+	return sat::overlaps(first, firstPos, second, secondPos);
+}
+
+bool overlaps(ConstShapeRef first, Coord2 firstPos, ConstShapeRef second, Coord2 secondPos, Coord2& out_norm, gFloat& out_dist) {
+	const MinkowskiDifference md{first, second, firstPos - secondPos};
+	Simplex simplex;
+	Coord2 closest, norm;
+	gFloat depth;
+	switch (_gjk(md, false, simplex, closest)) {
+	case Status::Separated:
+		return false;
+	case Status::Intersecting:
+		if (_epa(md, simplex, norm, depth) && depth > CONTACT_TOLERANCE) {
+			out_norm = -norm; // Moving first against the edge's normal moves the origin out of the Minkowski difference.
+			out_dist = depth;
+			return true;
+		}
+		break;
+	case Status::Touching:
+		break;
+	}
+	return sat::overlaps(first, firstPos, second, secondPos, out_norm, out_dist);
+}
+
+CollisionResult collides(ConstShapeRef first, Coord2 firstPos, Coord2 firstDelta,
+	ConstShapeRef second, Coord2 secondPos, Coord2& out_norm, gFloat& out_t) {
+	if (firstDelta.isZero())
+		return gjk::overlaps(first, firstPos, second, secondPos, out_norm, out_t) ? CollisionResult::MinimumTranslationVector : CollisionResult::None;
+	const MinkowskiDifference md{first, second, firstPos - secondPos};
+	Simplex simplex;
+	Coord2 closest, norm;
+	gFloat t;
+	switch (_gjk(md, false, simplex, closest)) {
+	case Status::Separated:
+		// Moving first by t * delta moves the Minkowski difference, so they first touch when a ray from the origin along -delta enters it.
+		switch (_raycast(md, -firstDelta, t, norm)) {
+		case RaycastResult::Miss:
+			return CollisionResult::None;
+		case RaycastResult::Hit:
+			out_norm = -norm;
+			out_t = t;
+			return CollisionResult::Sweep;
+		case RaycastResult::Inconclusive:
+			break;
+		}
+		break;
+	case Status::Intersecting:
+		if (_epa(md, simplex, norm, t) && t > CONTACT_TOLERANCE) {
+			out_norm = -norm;
+			out_t = t;
+			return CollisionResult::MinimumTranslationVector;
+		}
+		break;
+	case Status::Touching:
+		break;
+	}
+	return sat::collides(first, firstPos, firstDelta, second, secondPos, out_norm, out_t);
+}
+}
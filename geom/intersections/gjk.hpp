@@ -0,0 +1,53 @@
+#ifndef INCLUDE_GEOM_GJK_HPP
+#define INCLUDE_GEOM_GJK_HPP
+
+#include <cstddef>
+
+#include "../units.hpp"
+
+// Narrowphase tests using GJK (Gilbert-Johnson-Keerthi) on the shapes' Minkowski difference, with EPA (expanding polytope
+// algorithm) for penetration depth, and a GJK raycast for sweeps.
+// Shapes are only touched through support functions, so a test costs a few linear scans of each shape's vertices, rather
+// than SAT's projection of both shapes onto every edge normal of both shapes. This pays off for polygons with many vertices.
+// Results follow the same semantics as the SAT versions: "touching" shapes are not considered overlapping. Configurations
+// within CONTACT_TOLERANCE of touching, where float error in GJK/EPA could decide the result either way, are settled with SAT.
+// One difference: EPA gives the true minimum translation vector. For deep overlaps it can be shorter than SAT's, which pushes
+// the first shape out the side its projection is on.
+// overlaps() and collides() switch to these automatically for pairs with at least AUTO_VERTEX_THRESHOLD vertices between them.
+namespace ctp {
+class ConstShapeRef;
+enum class CollisionResult;
+}
+namespace ctp::gjk {
+// Combined vertex count of a pair of shapes at which GJK is used instead of SAT. Circles count as one vertex.
+constexpr std::size_t AUTO_VERTEX_THRESHOLD = 24;
+// Distance or penetration depth below which shapes are considered to be in contact, and are resolved with SAT.
+constexpr gFloat CONTACT_TOLERANCE = 0.0001f;
+
+// Check if a pair of shapes has enough vertices that GJK is expected to be faster than SAT.
+bool isPreferred(ConstShapeRef first, ConstShapeRef second);
+
+// Get the point on a shape farthest in the given direction. The direction doesn't need to be normalized.
+Coord2 support(ConstShapeRef shape, Coord2 dir);
+
+// Get the distance between two shapes with given positions, or 0 if they are touching or overlapping.
+gFloat distance(ConstShapeRef first, Coord2 firstPos, ConstShapeRef second, Coord2 secondPos);
+
+// Test if two shapes with given positions overlap each other.
+// Returns true if they overlap.
+bool overlaps(ConstShapeRef first, Coord2 firstPos, ConstShapeRef second, Coord2 secondPos);
+// Test if two shapes with given positions overlap each other.
+// Gives the normal and distance that make up the minimum translation vector of separation to move the first shape out of the second shape.
+// Returns true if they overlap.
+bool overlaps(ConstShapeRef first, Coord2 firstPos, ConstShapeRef second, Coord2 secondPos, Coord2& out_norm, gFloat& out_dist);
+
+// Find when a collision will occur for one moving and one stationary shape, and the normal of their collision, if they collide.
+// out_norm  - The collision normal for the first shape.
+// out_t     - For Sweep results: a value in range [0,1], indicating when along the delta vector the collision occurs.
+//             For MinimumTranslationVector results: The shapes are already colliding. Gives distance to travel along the norm to separate.
+// Returns the type of collision: None, a current MinimumTranslationVector collision, or a future Sweep collision on the interval [0, 1].
+CollisionResult collides(ConstShapeRef first, Coord2 firstPos, Coord2 firstDelta,
+	ConstShapeRef second, Coord2 secondPos, Coord2& out_norm, gFloat& out_t);
+}
+
+#endif // INCLUDE_GEOM_GJK_HPP
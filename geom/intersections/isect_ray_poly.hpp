@@ -5,6 +5,7 @@
 
 namespace ctp {
 class Polygon;
+class PolygonView;
 struct Ray;
 
 bool intersects(const Ray& r, const Polygon& p, Coord2 pos = Coord2(0, 0));
@@ -16,6 +17,13 @@ bool intersects(const Ray& r, const Polygon& p, Coord2 pos, gFloat& out_t, Coord
 bool intersects(const Ray& r, const Polygon& p, Coord2 pos, gFloat& out_enter, gFloat& out_exit);
 // Get both intersections and normals for the ray and polygon. If the ray's origin intersects the polygon, then out_enter == 0, and out_norm_enter = (0, 0).
 bool intersects(const Ray& r, const Polygon& p, Coord2 pos, gFloat& out_enter, Coord2& out_norm_enter, gFloat& out_exit, Coord2& out_norm_exit);
+
+// As above, for a view of a polygon, such as one in a PolygonPool.
+bool intersects(const Ray& r, const PolygonView& p, Coord2 pos = Coord2(0, 0));
+bool intersects(const Ray& r, const PolygonView& p, Coord2 pos, gFloat& out_t);
+bool intersects(const Ray& r, const PolygonView& p, Coord2 pos, gFloat& out_t, Coord2& out_norm);
+bool intersects(const Ray& r, const PolygonView& p, Coord2 pos, gFloat& out_enter, gFloat& out_exit);
+bool intersects(const Ray& r, const PolygonView& p, Coord2 pos, gFloat& out_enter, Coord2& out_norm_enter, gFloat& out_exit, Coord2& out_norm_exit);
 }
 
 #endif // INCLUDE_GEOM_ISECT_RAY_POLY_HPP
@@ -1,6 +1,10 @@
 #include "isect_ray_rect.hpp"
 
+#include <limits>
+
 #include "intersections.hpp"
+#include "RectBatch.hpp"
+#include "../simd.hpp"
 #include "../primitives/Ray.hpp"
 #include "../primitives/LineSegment.hpp"
 #include "../shapes/Rectangle.hpp"
@@ -41,6 +45,51 @@ inline bool _find_rect_intersect(const Ray& ray, const Rect& rect, bool isFirstI
 	}
 	return false;
 }
+
+using simd::Lanes;
+using simd::LANES;
+
+// A ray set up for slab tests against a register of rectangles at a time.
+struct SlabRay {
+	explicit SlabRay(const Ray& ray, gFloat maxT) noexcept
+		: origin_x(Lanes::fill(ray.origin.x)), origin_y(Lanes::fill(ray.origin.y))
+		, inv_dir_x(Lanes::fill(1.0f / ray.dir.x)), inv_dir_y(Lanes::fill(1.0f / ray.dir.y))
+		, max_t(Lanes::fill(maxT)), is_parallel_x(ray.dir.x == 0.0f), is_parallel_y(ray.dir.y == 0.0f) {}
+	Lanes origin_x;
+	Lanes origin_y;
+	Lanes inv_dir_x;
+	Lanes inv_dir_y;
+	Lanes max_t;
+	bool is_parallel_x;
+	bool is_parallel_y;
+};
+// Narrow the interval of the ray inside a register of rectangles to the part between one pair of their sides.
+// A ray parallel to the sides is either always or never between them.
+inline void _clip_to_slab(Lanes lows, Lanes highs, Lanes origin, Lanes invDir, bool isParallel, Lanes& tEnter, Lanes& tExit) {
+	if (isParallel) {
+		const Lanes never = Lanes::fill(std::numeric_limits<gFloat>::infinity());
+		tEnter = Lanes::select((lows <= origin) & (origin <= highs), tEnter, never);
+		return;
+	}
+	const Lanes tLow = (lows - origin) * invDir;
+	const Lanes tHigh = (highs - origin) * invDir;
+	tEnter = tEnter.max(tLow.min(tHigh));
+	tExit = tExit.min(tLow.max(tHigh));
+}
+// Test a ray against the register of rectangles in a batch starting at index i.
+// Gives the entry intersection in each lane, and returns a mask of which rectangles were hit.
+// Gives a bit per lane, lane 0 in the lowest bit, for the rectangles the ray hits. Padding lanes are never set.
+inline int _slab_test(const SlabRay& ray, const RectBatch& rects, std::size_t i, Lanes& out_t) {
+	Lanes tEnter = Lanes::fill(0);
+	Lanes tExit = ray.max_t;
+	_clip_to_slab(Lanes::load(rects.lefts() + i), Lanes::load(rects.rights() + i), ray.origin_x, ray.inv_dir_x, ray.is_parallel_x, tEnter, tExit);
+	_clip_to_slab(Lanes::load(rects.tops() + i), Lanes::load(rects.bottoms() + i), ray.origin_y, ray.inv_dir_y, ray.is_parallel_y, tEnter, tExit);
+	out_t = tEnter;
+	const int bits = (tEnter <= tExit).bits();
+	// Padding is at infinity, which a ray with an infinite maxT reaches, so mask it off in the last register.
+	const std::size_t remaining = rects.size() - i;
+	return remaining < LANES ? bits & ((1 << remaining) - 1) : bits;
+}
 } // namespace
 
 bool intersects(const Ray& ray, const Rect& rect) {
@@ -107,4 +156,42 @@ bool intersects(const Ray& ray, const Rect& rect, Coord2 pos, gFloat& out_enter,
 		return false;
 	return _find_rect_intersect(ray, r, false, out_exit, &out_norm_exit); // It enters the rectangle, so it must also exit.
 }
+
+void intersects(const Ray& ray, const RectBatch& rects, gFloat maxT, std::vector<std::uint32_t>& out_hits, std::vector<gFloat>& out_ts) {
+	constexpr std::size_t MASK_BITS = 32;
+	const std::size_t padded = rects.paddedSize();
+	out_hits.assign((rects.size() + MASK_BITS - 1) / MASK_BITS, 0);
+	out_ts.resize(padded);
+	const SlabRay slabRay(ray, maxT);
+	Lanes t;
+	for (std::size_t i = 0; i < padded; i += LANES) {
+		const std::uint32_t bits = static_cast<std::uint32_t>(_slab_test(slabRay, rects, i, t));
+		out_hits[i / MASK_BITS] |= bits << (i % MASK_BITS);
+		t.store(out_ts.data() + i);
+	}
+	out_ts.resize(rects.size());
+}
+bool intersects(const Ray& ray, const RectBatch& rects, gFloat maxT, std::size_t& out_index, gFloat& out_t) {
+	const SlabRay slabRay(ray, maxT);
+	gFloat closest = std::numeric_limits<gFloat>::infinity();
+	Lanes t;
+	gFloat ts[LANES];
+	for (std::size_t i = 0, padded = rects.paddedSize(); i < padded; i += LANES) {
+		// Only look at individual lanes when a register has a hit closer than the closest so far, which gets rare quickly.
+		const int bits = _slab_test(slabRay, rects, i, t) & (t < Lanes::fill(closest)).bits();
+		if (bits == 0)
+			continue;
+		t.store(ts);
+		for (std::size_t lane = 0; lane < LANES; ++lane) {
+			if ((bits & (1 << lane)) && ts[lane] < closest) {
+				closest = ts[lane];
+				out_index = i + lane;
+			}
+		}
+	}
+	if (closest == std::numeric_limits<gFloat>::infinity())
+		return false;
+	out_t = closest;
+	return true;
+}
 }
@@ -1,10 +1,15 @@
 #ifndef INCLUDE_GEOM_ISECT_RAY_RECT_HPP
 #define INCLUDE_GEOM_ISECT_RAY_RECT_HPP
 
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
 #include "../units.hpp"
 
 namespace ctp {
 class Rect;
+class RectBatch;
 struct Ray;
 
 bool intersects(const Ray& ray, const Rect& rect);
@@ -17,6 +22,16 @@ bool intersects(const Ray& ray, const Rect& rect, Coord2 pos, gFloat& out_t, Coo
 bool intersects(const Ray& ray, const Rect& rect, Coord2 pos, gFloat& out_enter, gFloat& out_exit);
 // Get both intersections and normals for the ray and rectangle. If the ray's origin intersects the rectangle, then out_enter == 0, and out_norm_enter = (0, 0).
 bool intersects(const Ray& ray, const Rect& rect, Coord2 pos, gFloat& out_enter, Coord2& out_norm_enter, gFloat& out_exit, Coord2& out_norm_exit);
+
+// Test a ray against every rectangle in a batch, a SIMD register of rectangles at a time, with the slab method.
+// Only intersections up to maxT along the ray count. Touching a rectangle counts as intersecting it.
+// out_hits - Bit masks of the rectangles the ray intersects: rectangle i is bit i % 32 of element i / 32.
+// out_ts   - The entry intersection for each rectangle, or 0 if the ray's origin is in it. Only meaningful for rectangles that were hit.
+void intersects(const Ray& ray, const RectBatch& rects, gFloat maxT, std::vector<std::uint32_t>& out_hits, std::vector<gFloat>& out_ts);
+// Find the closest rectangle in a batch that a ray intersects, up to maxT along the ray.
+// Gives the rectangle's index and entry intersection, or 0 if the ray's origin is in it. Ties go to the lowest index.
+// Returns true if the ray intersects any rectangle.
+bool intersects(const Ray& ray, const RectBatch& rects, gFloat maxT, std::size_t& out_index, gFloat& out_t);
 }
 
 #endif // INCLUDE_GEOM_ISECT_RAY_RECT_HPP
@@ -15,6 +15,7 @@ bool intersects(const Ray& r, ConstShapeRef s, Coord2 pos) {
 	case ShapeType::Rectangle: return intersects(r, s.rect(), pos);
 	case ShapeType::Polygon:   return intersects(r, s.poly(), pos);
 	case ShapeType::Circle:    return intersects(r, s.circle(), pos);
+	case ShapeType::PooledPolygon: return intersects(r, s.pooled().view(), pos);
 	}
 	DBG_ERR("Unhandled shape type for ray intersection.");
 	return false;
@@ -24,6 +25,7 @@ bool intersects(const Ray& r, ConstShapeRef s, Coord2 pos, gFloat& out_t) {
 	case ShapeType::Rectangle: return intersects(r, s.rect(), pos, out_t);
 	case ShapeType::Polygon:   return intersects(r, s.poly(), pos, out_t);
 	case ShapeType::Circle:    return intersects(r, s.circle(), pos, out_t);
+	case ShapeType::PooledPolygon: return intersects(r, s.pooled().view(), pos, out_t);
 	}
 	DBG_ERR("Unhandled shape type for ray intersection.");
 	return false;
@@ -33,6 +35,7 @@ bool intersects(const Ray& r, ConstShapeRef s, Coord2 pos, gFloat& out_t, Coord2
 	case ShapeType::Rectangle: return intersects(r, s.rect(), pos, out_t, out_norm);
 	case ShapeType::Polygon:   return intersects(r, s.poly(), pos, out_t, out_norm);
 	case ShapeType::Circle:    return intersects(r, s.circle(), pos, out_t, out_norm);
+	case ShapeType::PooledPolygon: return intersects(r, s.pooled().view(), pos, out_t, out_norm);
 	}
 	DBG_ERR("Unhandled shape type for ray intersection.");
 	return false;
@@ -42,6 +45,7 @@ bool intersects(const Ray& r, ConstShapeRef s, Coord2 pos, gFloat& out_enter, gF
 	case ShapeType::Rectangle: return intersects(r, s.rect(), pos, out_enter, out_exit);
 	case ShapeType::Polygon:   return intersects(r, s.poly(), pos, out_enter, out_exit);
 	case ShapeType::Circle:    return intersects(r, s.circle(), pos, out_enter, out_exit);
+	case ShapeType::PooledPolygon: return intersects(r, s.pooled().view(), pos, out_enter, out_exit);
 	}
 	DBG_ERR("Unhandled shape type for ray intersection.");
 	return false;
@@ -51,6 +55,7 @@ bool intersects(const Ray& r, ConstShapeRef s, Coord2 pos, gFloat& out_enter, Co
 	case ShapeType::Rectangle: return intersects(r, s.rect(), pos, out_enter, out_norm_enter, out_exit, out_norm_exit);
 	case ShapeType::Polygon:   return intersects(r, s.poly(), pos, out_enter, out_norm_enter, out_exit, out_norm_exit);
 	case ShapeType::Circle:    return intersects(r, s.circle(), pos, out_enter, out_norm_enter, out_exit, out_norm_exit);
+	case ShapeType::PooledPolygon: return intersects(r, s.pooled().view(), pos, out_enter, out_norm_enter, out_exit, out_norm_exit);
 	}
 	DBG_ERR("Unhandled shape type for ray intersection.");
 	return false;
@@ -1,77 +1,367 @@
 #include "overlaps.hpp"
 
+#include <algorithm>
+#include <limits>
+#include <type_traits>
+
 #include "sat.hpp"
+#include "gjk.hpp"
+#include "shape_pairs.hpp"
+#include "SeparatingAxisCache.hpp"
 #include "../units.hpp"
 #include "../constants.hpp"
 #include "../shapes/Rectangle.hpp"
+#include "../shapes/Polygon.hpp"
+#include "../shapes/Circle.hpp"
 #include "../shapes/ShapeContainer.hpp"
+#include "../primitives/Projection.hpp"
 
 namespace ctp {
+namespace {
+inline bool _are_separated(Projection projFirst, Projection projSecond) {
+	return projFirst.min + constants::EPSILON > projSecond.max || projFirst.max < projSecond.min + constants::EPSILON;
+}
 
-bool overlaps(const Rect& first, const Rect& second) {
-	return first.left() < second.right() &&
-		first.right() > second.left() &&
-		first.top() < second.bottom() &&
-		first.bottom() > second.top();
+// Check if two shapes' projections on an axis are separated. Offset is first's position - second's position.
+template <typename First, typename Second>
+inline bool _is_separated_on(const First& first, const Second& second, Coord2 axis, Coord2 offset) {
+	Projection projFirst(shape_pairs::project(first, axis));
+	projFirst += offset.dot(axis);
+	return _are_separated(projFirst, shape_pairs::project(second, axis));
 }
 
-bool overlaps(ConstShapeRef first, ConstShapeRef second) {
-	const std::vector<Coord2> axes(sat::getSeparatingAxes(first, second));
-	const Shape& firstShape(first.shape()), & secondShape(second.shape());
-	Projection projFirst, projSecond;
-	for (std::size_t i = 0; i < axes.size(); ++i) {
-		projFirst = firstShape.getProjection(axes[i]);
-		projSecond = secondShape.getProjection(axes[i]);
-		if (projFirst.min + constants::EPSILON > projSecond.max || projFirst.max < projSecond.min + constants::EPSILON)
-			return false;
+// Rectangles are axis-aligned, so their projections on the x and y axes are their sides. Pairs of them are tested on just those
+// axes, without finding separating axes, with the same arithmetic as the general SAT tests.
+inline Projection _x_projection(const Rect& r, gFloat offset = 0) { return Projection(r.left() + offset, r.right() + offset); }
+inline Projection _y_projection(const Rect& r, gFloat offset = 0) { return Projection(r.top() + offset, r.bottom() + offset); }
+
+inline bool _rects_overlap(const Rect& first, const Rect& second, Coord2 offset) {
+	return !_are_separated(_x_projection(first, offset.x), _x_projection(second)) &&
+		!_are_separated(_y_projection(first, offset.y), _y_projection(second));
+}
+
+inline bool _rects_overlap(const Rect& first, const Rect& second, Coord2 offset, Coord2& out_norm, gFloat& out_dist) {
+	const Projection firstX(_x_projection(first, offset.x)), secondX(_x_projection(second));
+	const Projection firstY(_y_projection(first, offset.y)), secondY(_y_projection(second));
+	const gFloat overlapX1(firstX.max - secondX.min), overlapX2(secondX.max - firstX.min);
+	const gFloat overlapY1(firstY.max - secondY.min), overlapY2(secondY.max - firstY.min);
+	if (overlapX1 < constants::EPSILON || overlapX2 < constants::EPSILON || overlapY1 < constants::EPSILON || overlapY2 < constants::EPSILON)
+		return false;
+	// Push out along the axis with the least overlap, preferring x.
+	const gFloat distX(firstX.min < secondX.min ? overlapX1 : overlapX2);
+	const gFloat distY(firstY.min < secondY.min ? overlapY1 : overlapY2);
+	if (distY < distX) {
+		out_norm = Coord2(0, firstY.min < secondY.min ? -1.0f : 1.0f);
+		out_dist = distY;
+	} else {
+		out_norm = Coord2(firstX.min < secondX.min ? -1.0f : 1.0f, 0);
+		out_dist = distX;
 	}
 	return true;
 }
 
-bool overlaps(ConstShapeRef first, Coord2 firstPos, ConstShapeRef second, Coord2 secondPos) {
-	const Coord2 offset(firstPos - secondPos);
-	const std::vector<Coord2> axes(sat::getSeparatingAxes(first, second, offset));
-	Projection projFirst, projSecond;
-	for (std::size_t i = 0; i < axes.size(); ++i) {
-		projFirst = first.shape().getProjection(axes[i]);
-		projSecond = second.shape().getProjection(axes[i]);
-		projFirst += offset.dot(axes[i]); // Apply offset between the two shapes' positions.
-		if (projFirst.min + constants::EPSILON > projSecond.max || projFirst.max < projSecond.min + constants::EPSILON)
+// Find how a circle overlaps a polygon from the polygon's feature closest to the circle's center. Offset is the circle's position - the polygon's position.
+// The center is farthest outside (or least inside) of one edge. Inside the polygon, that edge is the nearest way out. Outside, the
+// closest point to the center is on that edge, or on one of its vertices if the center is past the edge's end.
+// Gives the minimum translation vector if they overlap. Otherwise, out_norm is set to an axis that separates them.
+inline bool _circle_poly_overlap(const Circle& circle, const PolygonView& poly, Coord2 offset, Coord2& out_norm, gFloat& out_dist) {
+	const std::size_t size(poly.size());
+	const Coord2 center(circle.center + offset);
+	const gFloat maxSeparation(circle.radius - constants::EPSILON); // Touching shapes are not overlapping.
+	std::size_t edge(0);
+	gFloat separation(std::numeric_limits<gFloat>::lowest());
+	for (std::size_t i = 0; i < size; ++i) {
+		const Coord2 edgeNorm(poly.getEdgeNorm(i));
+		const gFloat testSeparation((center - poly[i]).dot(edgeNorm));
+		if (testSeparation > maxSeparation) {
+			out_norm = edgeNorm;
 			return false;
+		}
+		if (testSeparation > separation) {
+			separation = testSeparation;
+			edge = i;
+		}
 	}
+	out_norm = poly.getEdgeNorm(edge);
+	out_dist = circle.radius - separation;
+	if (separation <= 0) // The center is inside the polygon.
+		return true;
+	const Coord2 start(poly[edge]), end(poly[edge + 1 < size ? edge + 1 : 0]);
+	const Coord2 edgeDir(end - start);
+	Coord2 vertex;
+	if ((center - start).dot(edgeDir) < 0)
+		vertex = start;
+	else if ((center - end).dot(edgeDir) > 0)
+		vertex = end;
+	else
+		return true; // The center is beside the edge.
+	const Coord2 toCenter(center - vertex);
+	const gFloat dist(toCenter.magnitude());
+	out_norm = toCenter / dist; // Not zero: the center is outside the polygon.
+	if (dist > maxSeparation)
+		return false;
+	out_dist = circle.radius - dist;
 	return true;
 }
 
-bool overlaps(ConstShapeRef first, Coord2 firstPos, ConstShapeRef second, Coord2 secondPos, Coord2& out_norm, gFloat& out_dist) {
-	const Coord2 offset(firstPos - secondPos);
-	const std::vector<Coord2> axes(sat::getSeparatingAxes(first, second, offset));
-	const Shape& firstShape(first.shape()), & secondShape(second.shape());
-	Coord2 norm, testNorm;
-	gFloat overlap1, overlap2, minDist(-1), testDist;
-	Projection projFirst, projSecond;
-	for (std::size_t i = 0; i < axes.size(); ++i) {
-		projFirst = firstShape.getProjection(axes[i]);
-		projSecond = secondShape.getProjection(axes[i]);
-		projFirst += offset.dot(axes[i]); // Apply offset between the two shapes' positions.
-		overlap1 = projFirst.max - projSecond.min;
-		overlap2 = projSecond.max - projFirst.min;
-		if (overlap1 < constants::EPSILON || overlap2 < constants::EPSILON)
-			return false;
-		// Find separation for this axis.
-		if (projFirst.min < projSecond.min) {
-			testDist = overlap1;
-			testNorm = -axes[i]; // Ensure right direction to pushout the first shape.
+template <typename First, typename Second>
+constexpr bool ARE_RECTS = std::is_same_v<First, Rect> && std::is_same_v<Second, Rect>;
+
+template <typename First, typename Second>
+constexpr bool ARE_CIRCLE_AND_POLY = (std::is_same_v<First, Circle> && std::is_same_v<Second, PolygonView>) ||
+	(std::is_same_v<First, PolygonView> && std::is_same_v<Second, Circle>);
+
+// _circle_poly_overlap for a circle and a polygon in either order, with out_norm for the first shape.
+template <typename First, typename Second>
+inline bool _circle_and_poly_overlap(const First& first, const Second& second, Coord2 offset, Coord2& out_norm, gFloat& out_dist) {
+	if constexpr (std::is_same_v<First, Circle>) {
+		return _circle_poly_overlap(first, second, offset, out_norm, out_dist);
+	} else {
+		const bool isOverlapping(_circle_poly_overlap(second, first, -offset, out_norm, out_dist));
+		out_norm = -out_norm;
+		return isOverlapping;
+	}
+}
+
+// SAT kernels for each pair of shape types, selected with shape_pairs::select. Offset is first's position - second's position.
+template <typename First, typename Second>
+struct OverlapsKernel {
+	static bool run(ConstShapeRef firstRef, ConstShapeRef secondRef, Coord2 offset) {
+		const First& first(shape_pairs::as<First>(firstRef));
+		const Second& second(shape_pairs::as<Second>(secondRef));
+		if constexpr (ARE_RECTS<First, Second>) {
+			return _rects_overlap(first, second, offset);
+		} else if constexpr (ARE_CIRCLE_AND_POLY<First, Second>) {
+			Coord2 norm;
+			gFloat dist;
+			return _circle_and_poly_overlap(first, second, offset, norm, dist);
+		} else {
+			sat::AxisBuffer axes;
+			shape_pairs::getSeparatingAxes(first, second, offset, axes);
+			for (std::size_t i = 0; i < axes.size(); ++i) {
+				if (_is_separated_on(first, second, axes[i], offset))
+					return false;
+			}
+			return true;
+		}
+	}
+};
+
+template <typename First, typename Second>
+struct MinimumTranslationKernel {
+	static bool run(ConstShapeRef firstRef, ConstShapeRef secondRef, Coord2 offset, Coord2& out_norm, gFloat& out_dist) {
+		const First& first(shape_pairs::as<First>(firstRef));
+		const Second& second(shape_pairs::as<Second>(secondRef));
+		if constexpr (ARE_RECTS<First, Second>) {
+			return _rects_overlap(first, second, offset, out_norm, out_dist);
+		} else if constexpr (ARE_CIRCLE_AND_POLY<First, Second>) {
+			Coord2 norm;
+			gFloat dist;
+			if (!_circle_and_poly_overlap(first, second, offset, norm, dist))
+				return false;
+			out_norm = norm;
+			out_dist = dist;
+			return true;
 		} else {
-			testDist = overlap2;
-			testNorm = axes[i];
+			sat::AxisBuffer axes;
+			shape_pairs::TwoSidedAxes twoSided;
+			shape_pairs::getSeparatingAxes(first, second, offset, axes, twoSided);
+			Coord2 norm, testNorm;
+			gFloat overlap1, overlap2, minDist(-1), testDist;
+			Projection projFirst, projSecond;
+			for (std::size_t i = 0; i < axes.size(); ++i) {
+				projFirst = shape_pairs::project(first, axes[i]);
+				projSecond = shape_pairs::project(second, axes[i]);
+				projFirst += offset.dot(axes[i]); // Apply offset between the two shapes' positions.
+				overlap1 = projFirst.max - projSecond.min;
+				overlap2 = projSecond.max - projFirst.min;
+				if (overlap1 < constants::EPSILON || overlap2 < constants::EPSILON)
+					return false;
+				// Find separation for this axis.
+				if (shape_pairs::pushesOutNegative(projFirst, projSecond, overlap1, overlap2, shape_pairs::isTwoSided(twoSided, i))) {
+					testDist = overlap1;
+					testNorm = -axes[i]; // Ensure right direction to pushout the first shape.
+				} else {
+					testDist = overlap2;
+					testNorm = axes[i];
+				}
+				if (minDist == -1 || testDist < minDist) {
+					minDist = testDist;
+					norm = testNorm;
+				}
+			}
+			out_norm = norm;
+			out_dist = minDist;
+			return true;
+		}
+	}
+};
+
+template <typename First, typename Second>
+struct CachedOverlapsKernel {
+	static bool run(ConstShapeRef firstRef, ConstShapeRef secondRef, Coord2 offset, SeparatingAxisCache& cache) {
+		const First& first(shape_pairs::as<First>(firstRef));
+		const Second& second(shape_pairs::as<Second>(secondRef));
+		if (cache.testCachedAxis(firstRef, secondRef, [&](Coord2 axis) { return _is_separated_on(first, second, axis, offset); }))
+			return false;
+		if constexpr (ARE_CIRCLE_AND_POLY<First, Second>) {
+			// Store the axis that separated them, or the minimum translation's axis if they overlap.
+			Coord2 norm;
+			gFloat dist;
+			const bool isOverlapping(_circle_and_poly_overlap(first, second, offset, norm, dist));
+			cache.store(firstRef, secondRef, norm);
+			return isOverlapping;
+		}
+		sat::AxisBuffer axes;
+		shape_pairs::getSeparatingAxes(first, second, offset, axes);
+		Coord2 minAxis;
+		gFloat minOverlap(-1), overlap;
+		Projection projFirst, projSecond;
+		for (std::size_t i = 0; i < axes.size(); ++i) {
+			projFirst = shape_pairs::project(first, axes[i]);
+			projSecond = shape_pairs::project(second, axes[i]);
+			projFirst += offset.dot(axes[i]); // Apply offset between the two shapes' positions.
+			if (_are_separated(projFirst, projSecond)) {
+				cache.store(firstRef, secondRef, axes[i]);
+				return false;
+			}
+			// The axis they overlap least on is the most likely to separate them next time.
+			overlap = std::min(projFirst.max - projSecond.min, projSecond.max - projFirst.min);
+			if (minOverlap == -1 || overlap < minOverlap) {
+				minOverlap = overlap;
+				minAxis = axes[i];
+			}
+		}
+		if (minOverlap != -1)
+			cache.store(firstRef, secondRef, minAxis);
+		return true;
+	}
+};
+
+template <typename First, typename Second>
+struct CachedMinimumTranslationKernel {
+	static bool run(ConstShapeRef firstRef, ConstShapeRef secondRef, Coord2 offset, Coord2& out_norm, gFloat& out_dist, SeparatingAxisCache& cache) {
+		const First& first(shape_pairs::as<First>(firstRef));
+		const Second& second(shape_pairs::as<Second>(secondRef));
+		if (cache.testCachedAxis(firstRef, secondRef, [&](Coord2 axis) { return _is_separated_on(first, second, axis, offset); }))
+			return false;
+		if constexpr (ARE_CIRCLE_AND_POLY<First, Second>) {
+			Coord2 norm;
+			gFloat dist;
+			const bool isOverlapping(_circle_and_poly_overlap(first, second, offset, norm, dist));
+			cache.store(firstRef, secondRef, norm);
+			if (isOverlapping) {
+				out_norm = norm;
+				out_dist = dist;
+			}
+			return isOverlapping;
 		}
-		if (minDist == -1 || testDist < minDist) {
-			minDist = testDist;
-			norm = testNorm;
+		sat::AxisBuffer axes;
+		shape_pairs::TwoSidedAxes twoSided;
+		shape_pairs::getSeparatingAxes(first, second, offset, axes, twoSided);
+		Coord2 norm, testNorm;
+		gFloat overlap1, overlap2, minDist(-1), testDist;
+		Projection projFirst, projSecond;
+		for (std::size_t i = 0; i < axes.size(); ++i) {
+			projFirst = shape_pairs::project(first, axes[i]);
+			projSecond = shape_pairs::project(second, axes[i]);
+			projFirst += offset.dot(axes[i]); // Apply offset between the two shapes' positions.
+			overlap1 = projFirst.max - projSecond.min;
+			overlap2 = projSecond.max - projFirst.min;
+			if (overlap1 < constants::EPSILON || overlap2 < constants::EPSILON) {
+				cache.store(firstRef, secondRef, axes[i]);
+				return false;
+			}
+			// Find separation for this axis.
+			if (shape_pairs::pushesOutNegative(projFirst, projSecond, overlap1, overlap2, shape_pairs::isTwoSided(twoSided, i))) {
+				testDist = overlap1;
+				testNorm = -axes[i]; // Ensure right direction to pushout the first shape.
+			} else {
+				testDist = overlap2;
+				testNorm = axes[i];
+			}
+			if (minDist == -1 || testDist < minDist) {
+				minDist = testDist;
+				norm = testNorm;
+			}
 		}
+		if (minDist != -1)
+			cache.store(firstRef, secondRef, norm);
+		out_norm = norm;
+		out_dist = minDist;
+		return true;
 	}
+};
+
+constexpr auto OVERLAPS_KERNELS = shape_pairs::makeTable<OverlapsKernel>();
+constexpr auto MINIMUM_TRANSLATION_KERNELS = shape_pairs::makeTable<MinimumTranslationKernel>();
+constexpr auto CACHED_OVERLAPS_KERNELS = shape_pairs::makeTable<CachedOverlapsKernel>();
+constexpr auto CACHED_MINIMUM_TRANSLATION_KERNELS = shape_pairs::makeTable<CachedMinimumTranslationKernel>();
+}
+
+bool overlaps(const Rect& first, const Rect& second) {
+	return first.left() < second.right() &&
+		first.right() > second.left() &&
+		first.top() < second.bottom() &&
+		first.bottom() > second.top();
+}
+
+bool overlaps(const Circle& circle, Coord2 circlePos, const Polygon& poly, Coord2 polyPos) {
+	return overlaps(circle, circlePos, poly.view(), polyPos);
+}
+
+bool overlaps(const Circle& circle, Coord2 circlePos, const Polygon& poly, Coord2 polyPos, Coord2& out_norm, gFloat& out_dist) {
+	return overlaps(circle, circlePos, poly.view(), polyPos, out_norm, out_dist);
+}
+
+bool overlaps(const Circle& circle, Coord2 circlePos, const PolygonView& poly, Coord2 polyPos) {
+	Coord2 norm;
+	gFloat dist;
+	return _circle_poly_overlap(circle, poly, circlePos - polyPos, norm, dist);
+}
+
+bool overlaps(const Circle& circle, Coord2 circlePos, const PolygonView& poly, Coord2 polyPos, Coord2& out_norm, gFloat& out_dist) {
+	Coord2 norm;
+	gFloat dist;
+	if (!_circle_poly_overlap(circle, poly, circlePos - polyPos, norm, dist))
+		return false;
 	out_norm = norm;
-	out_dist = minDist;
+	out_dist = dist;
 	return true;
 }
+
+bool overlaps(ConstShapeRef first, ConstShapeRef second) {
+	if (gjk::isPreferred(first, second))
+		return gjk::overlaps(first, Coord2(0, 0), second, Coord2(0, 0));
+	return shape_pairs::select(OVERLAPS_KERNELS, first, second)(first, second, Coord2(0, 0));
+}
+
+bool overlaps(ConstShapeRef first, Coord2 firstPos, ConstShapeRef second, Coord2 secondPos) {
+	if (gjk::isPreferred(first, second))
+		return gjk::overlaps(first, firstPos, second, secondPos);
+	return sat::overlaps(first, firstPos, second, secondPos);
+}
+
+bool overlaps(ConstShapeRef first, Coord2 firstPos, ConstShapeRef second, Coord2 secondPos, Coord2& out_norm, gFloat& out_dist) {
+	if (gjk::isPreferred(first, second))
+		return gjk::overlaps(first, firstPos, second, secondPos, out_norm, out_dist);
+	return sat::overlaps(first, firstPos, second, secondPos, out_norm, out_dist);
+}
+
+bool sat::overlaps(ConstShapeRef first, Coord2 firstPos, ConstShapeRef second, Coord2 secondPos) {
+	return shape_pairs::select(OVERLAPS_KERNELS, first, second)(first, second, firstPos - secondPos);
+}
+
+bool sat::overlaps(ConstShapeRef first, Coord2 firstPos, ConstShapeRef second, Coord2 secondPos, Coord2& out_norm, gFloat& out_dist) {
+	return shape_pairs::select(MINIMUM_TRANSLATION_KERNELS, first, second)(first, second, firstPos - secondPos, out_norm, out_dist);
+}
+
+bool overlaps(ConstShapeRef first, Coord2 firstPos, ConstShapeRef second, Coord2 secondPos, SeparatingAxisCache& cache) {
+	return shape_pairs::select(CACHED_OVERLAPS_KERNELS, first, second)(first, second, firstPos - secondPos, cache);
+}
+
+bool overlaps(ConstShapeRef first, Coord2 firstPos, ConstShapeRef second, Coord2 secondPos, Coord2& out_norm, gFloat& out_dist,
+              SeparatingAxisCache& cache) {
+	return shape_pairs::select(CACHED_MINIMUM_TRANSLATION_KERNELS, first, second)(first, second, firstPos - secondPos, out_norm, out_dist, cache);
+}
 }
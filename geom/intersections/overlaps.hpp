@@ -6,12 +6,26 @@
 namespace ctp {
 class ConstShapeRef;
 class Rect;
+class Polygon;
+class PolygonView;
+class Circle;
+class SeparatingAxisCache;
 
 // Specialized algorithms ------------------------------------------------
 
 bool overlaps(const Rect& first, const Rect& second);
+// Test if a circle overlaps a polygon, by finding the polygon's edge or vertex closest to the circle's center in one pass over
+// its edges, rather than projecting both shapes onto every axis. Gives the same results as the general algorithms with SAT.
+bool overlaps(const Circle& circle, Coord2 circlePos, const Polygon& poly, Coord2 polyPos);
+// As above, giving the minimum translation vector to move the circle out of the polygon.
+bool overlaps(const Circle& circle, Coord2 circlePos, const Polygon& poly, Coord2 polyPos, Coord2& out_norm, gFloat& out_dist);
+// As above, for a view of a polygon, such as one in a PolygonPool.
+bool overlaps(const Circle& circle, Coord2 circlePos, const PolygonView& poly, Coord2 polyPos);
+bool overlaps(const Circle& circle, Coord2 circlePos, const PolygonView& poly, Coord2 polyPos, Coord2& out_norm, gFloat& out_dist);
 
 // General algorithms  ---------------------------------------------------
+// Pairs with at least gjk::AUTO_VERTEX_THRESHOLD vertices between them are tested with GJK, and the rest with SAT.
+// To choose per call, use the versions in the sat and gjk namespaces.
 
 // Test if two shapes overlap each other.
 // Returns true if they overlap.
@@ -23,6 +37,14 @@ bool overlaps(ConstShapeRef first, Coord2 firstPos, ConstShapeRef second, Coord2
 // Gives the normal and distance that make up the minimum translation vector of separation to move the first shape out of the second shape.
 // Returns true if they overlap.
 bool overlaps(ConstShapeRef first, Coord2 firstPos, ConstShapeRef second, Coord2 secondPos, Coord2& out_norm, gFloat& out_dist);
+
+// Cached algorithms  ----------------------------------------------------
+// As above, but test the pair's axis from the cache first, and store the axis that separated them, or their minimum axis
+// if they overlap, for next time. Worthwhile when the same pairs are tested repeatedly, e.g. every frame.
+
+bool overlaps(ConstShapeRef first, Coord2 firstPos, ConstShapeRef second, Coord2 secondPos, SeparatingAxisCache& cache);
+bool overlaps(ConstShapeRef first, Coord2 firstPos, ConstShapeRef second, Coord2 secondPos, Coord2& out_norm, gFloat& out_dist,
+              SeparatingAxisCache& cache);
 }
 
 #endif // INCLUDE_GEOM_OVERLAPS_HPP
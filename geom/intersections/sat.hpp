@@ -3,14 +3,30 @@
 
 #include <vector>
 
+#include "gjk.hpp"
+#include "../small_vector.hpp"
 #include "../units.hpp"
 
-namespace ctp { class ConstShapeRef; }
+namespace ctp {
+class ConstShapeRef;
+enum class CollisionResult;
+}
 namespace ctp::sat {
+// A list of separating axes, with inline room for every pair of shapes that overlaps() and collides() test with SAT rather than GJK.
+using AxisBuffer = SmallVector<Coord2, gjk::AUTO_VERTEX_THRESHOLD>;
+
 // Given two shapes, find the axes of separation for them. Offset is first's position - second's position.
 // If given an unknown shape type, converts the shape to a polygon and uses that.
 // Returns a vector of normalized separating axes.
 std::vector<Coord2> getSeparatingAxes(ConstShapeRef first, ConstShapeRef second, Coord2 offset = Coord2(0, 0));
+// Find the axes of separation for two shapes, replacing the contents of out_axes, without allocating for pairs that fit its inline capacity.
+void getSeparatingAxes(ConstShapeRef first, ConstShapeRef second, Coord2 offset, AxisBuffer& out_axes);
+
+// Versions of overlaps() and collides() that always use SAT, however many vertices the shapes have.
+bool overlaps(ConstShapeRef first, Coord2 firstPos, ConstShapeRef second, Coord2 secondPos);
+bool overlaps(ConstShapeRef first, Coord2 firstPos, ConstShapeRef second, Coord2 secondPos, Coord2& out_norm, gFloat& out_dist);
+CollisionResult collides(ConstShapeRef first, Coord2 firstPos, Coord2 firstDelta,
+	ConstShapeRef second, Coord2 secondPos, Coord2& out_norm, gFloat& out_t);
 }
 
 #endif // INCLUDE_GEOM_SAT_HPP
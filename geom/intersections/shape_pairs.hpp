@@ -0,0 +1,162 @@
+#ifndef INCLUDE_GEOM_SHAPE_PAIRS_HPP
+#define INCLUDE_GEOM_SHAPE_PAIRS_HPP
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+#include "sat.hpp"
+#include "../math.hpp"
+#include "../units.hpp"
+#include "../shapes/ShapeContainer.hpp"
+#include "../primitives/Projection.hpp"
+
+// Dispatch of narrowphase kernels over pairs of concrete shape types.
+// A kernel is a class template on the two shape types with a static run function. makeTable instantiates it for every pair,
+// in a table indexed by ShapeType, so a test selects its kernel with one lookup instead of switching on the types, and the
+// kernel's inner loops call the concrete shapes' functions directly, where they can be inlined.
+namespace ctp::shape_pairs {
+constexpr std::size_t NUM_SHAPE_TYPES = 4;
+static_assert(static_cast<std::size_t>(ShapeType::Rectangle) == 0 && static_cast<std::size_t>(ShapeType::Polygon) == 1 &&
+	static_cast<std::size_t>(ShapeType::Circle) == 2 && static_cast<std::size_t>(ShapeType::PooledPolygon) == 3,
+	"Tables are indexed by ShapeType.");
+
+// Get the concrete shape a reference refers to, as kernels take it. Its type must match: polygons, owned or pooled, are
+// taken as views, so one kernel handles both.
+template <typename S> S as(ConstShapeRef shape) noexcept;
+template <> inline Rect as<Rect>(ConstShapeRef shape) noexcept { return shape.rect(); }
+template <> inline PolygonView as<PolygonView>(ConstShapeRef shape) noexcept {
+	return shape.type() == ShapeType::PooledPolygon ? shape.pooled().view() : shape.poly().view();
+}
+template <> inline Circle as<Circle>(ConstShapeRef shape) noexcept { return shape.circle(); }
+
+// Project a shape onto an axis.
+template <typename S>
+inline Projection project(const S& shape, Coord2 axis) { return shape.getProjection(axis); }
+
+// Find the closest vertex or point on a shape to a point.
+template <typename S>
+inline Coord2 closestTo(const S& shape, Coord2 point) { return shape.getClosestTo(point); }
+
+// Check if a shape has its parallel axes merged, so pairs with it skip shared axes.
+template <typename S>
+inline bool _merges_axes(const S& shape) noexcept {
+	if constexpr (std::is_same_v<S, PolygonView>)
+		return shape.hasMergedAxes();
+	else
+		return false;
+}
+
+// Which axes of an AxisBuffer stand for both of their directions, a bit for each. A polygon's merged axis does when its
+// opposite side's normal was merged into it, as does an axis that two shapes share from opposite sides. Testing such an
+// axis once must give the same result as testing it in each direction.
+using TwoSidedAxes = std::uint64_t;
+constexpr std::size_t MAX_TWO_SIDED_AXES = 64;
+
+constexpr bool isTwoSided(TwoSidedAxes twoSided, std::size_t index) noexcept {
+	return index < MAX_TWO_SIDED_AXES && (twoSided >> index & 1) != 0;
+}
+
+// Add an axis, unless it's parallel to one of the first numShared axes. When it is, that axis becomes two-sided if this one
+// points the other way or is two-sided itself. Past the bits TwoSidedAxes has, both directions are added instead.
+inline void _add_axis(Coord2 axis, bool isTwoSidedAxis, std::size_t numShared, sat::AxisBuffer& axes, TwoSidedAxes& twoSided) {
+	for (std::size_t i = 0; i < numShared && i < MAX_TWO_SIDED_AXES; ++i) {
+		if (math::areParallelAxes(axis, axes[i])) {
+			if (isTwoSidedAxis || axis.dot(axes[i]) < 0)
+				twoSided |= TwoSidedAxes(1) << i;
+			return;
+		}
+	}
+	if (isTwoSidedAxis) {
+		if (axes.size() >= MAX_TWO_SIDED_AXES) {
+			axes.push_back(axis);
+			axes.push_back(-axis);
+			return;
+		}
+		twoSided |= TwoSidedAxes(1) << axes.size();
+	}
+	axes.push_back(axis);
+}
+
+// Add the separating axes that first contributes when paired with second.
+// Returns true if they are all the axes the pair needs.
+template <typename First, typename Second>
+inline bool _add_separating_axes(const First& first, const Second& second, Coord2 offset, sat::AxisBuffer& axes, TwoSidedAxes& twoSided) {
+	// When adding the second shape's axes, skip any the first shape added, if either merges its own.
+	const std::size_t numShared = _merges_axes(first) || _merges_axes(second) ? axes.size() : 0;
+	if constexpr (std::is_same_v<First, Rect>) {
+		_add_axis(Coord2(1, 0), false, numShared, axes, twoSided); // Rectangles are axis-alligned.
+		_add_axis(Coord2(0, 1), false, numShared, axes, twoSided);
+		return std::is_same_v<Second, Rect>; // Rectangles will share axes.
+	} else if constexpr (std::is_same_v<First, PolygonView>) {
+		const std::size_t size = first.size();
+		axes.reserve(axes.size() + size);
+		for (std::size_t i = 0; i < size; ++i) {
+			if (first.isAxis(i))
+				_add_axis(first.getEdgeNorm(i), first.isTwoSidedAxis(i), numShared, axes, twoSided);
+		}
+		return false;
+	} else {
+		const Coord2 firstPos(first.center + offset);
+		if constexpr (std::is_same_v<Second, Circle>) { // Only one axis for two circles.
+			const Coord2 axis = firstPos - second.center;
+			axes.push_back(axis.x == 0 && axis.y == 0 ? Coord2(0, 1) : axis.normalize());
+			return true;
+		} else {
+			// Get axis from circle to the cloeset point/vertex on the other shape.
+			const Coord2 axis = closestTo(second, firstPos) - firstPos;
+			if (axis.x != 0 || axis.y != 0) // If this is a zero vector, they are already overlapping, and can use other axes for the MinimumTranslationVector.
+				axes.push_back(axis.normalize());
+			return false;
+		}
+	}
+}
+
+// Find the separating axes for a pair of shapes, replacing the contents of out_axes, and which of them are two-sided.
+// Offset is first's position - second's position.
+template <typename First, typename Second>
+inline void getSeparatingAxes(const First& first, const Second& second, Coord2 offset, sat::AxisBuffer& out_axes, TwoSidedAxes& out_two_sided) {
+	out_axes.clear();
+	out_two_sided = 0;
+	if (!_add_separating_axes(first, second, offset, out_axes, out_two_sided))
+		_add_separating_axes(second, first, -offset, out_axes, out_two_sided);
+}
+
+// Find the separating axes for a pair of shapes, for tests that don't need their directions.
+template <typename First, typename Second>
+inline void getSeparatingAxes(const First& first, const Second& second, Coord2 offset, sat::AxisBuffer& out_axes) {
+	TwoSidedAxes twoSided;
+	getSeparatingAxes(first, second, offset, out_axes, twoSided);
+}
+
+// Check if the minimum translation vector on an axis pushes the first shape out the negative side of the second.
+// overlap1 is first's max - second's min, and overlap2 is second's max - first's min.
+// Pushes out the side the first shape's projection starts on. A two-sided axis stands for testing both of its directions,
+// which differ when one projection contains the other: then it pushes out the nearer side, as the two tests together would.
+inline bool pushesOutNegative(Projection projFirst, Projection projSecond, gFloat overlap1, gFloat overlap2, bool isTwoSided) noexcept {
+	const bool startsBefore(projFirst.min < projSecond.min);
+	if (!isTwoSided || startsBefore == (projFirst.max < projSecond.max))
+		return startsBefore;
+	return startsBefore ? !(overlap2 < overlap1) : overlap1 < overlap2;
+}
+
+// Build a table of a kernel instantiated for every pair of shape types. Both kinds of polygon share the PolygonView kernels.
+template <template <typename, typename> typename Kernel>
+constexpr auto makeTable() noexcept {
+	using Fn = decltype(&Kernel<Rect, Rect>::run);
+	return std::array<std::array<Fn, NUM_SHAPE_TYPES>, NUM_SHAPE_TYPES>{{
+		{{&Kernel<Rect, Rect>::run, &Kernel<Rect, PolygonView>::run, &Kernel<Rect, Circle>::run, &Kernel<Rect, PolygonView>::run}},
+		{{&Kernel<PolygonView, Rect>::run, &Kernel<PolygonView, PolygonView>::run, &Kernel<PolygonView, Circle>::run, &Kernel<PolygonView, PolygonView>::run}},
+		{{&Kernel<Circle, Rect>::run, &Kernel<Circle, PolygonView>::run, &Kernel<Circle, Circle>::run, &Kernel<Circle, PolygonView>::run}},
+		{{&Kernel<PolygonView, Rect>::run, &Kernel<PolygonView, PolygonView>::run, &Kernel<PolygonView, Circle>::run, &Kernel<PolygonView, PolygonView>::run}},
+	}};
+}
+
+// Select the kernel for a pair of shapes from a table.
+template <typename Table>
+constexpr auto select(const Table& table, ConstShapeRef first, ConstShapeRef second) noexcept {
+	return table[static_cast<std::size_t>(first.type())][static_cast<std::size_t>(second.type())];
+}
+}
+#endif // INCLUDE_GEOM_SHAPE_PAIRS_HPP
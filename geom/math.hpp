@@ -2,10 +2,12 @@
 #define INCLUDE_GEOM_MATH_HPP
 
 #include "units.hpp"
+#include "constants.hpp"
 
 #include <algorithm>
 #include <limits>
 #include <type_traits>
+#include <utility>
 
 namespace ctp { struct Ray; }
 namespace ctp::math {
@@ -26,6 +28,12 @@ enum class AngleResult {
 // Find what kind of angle the minimum angle between two vectors is.
 AngleResult minAngle(Coord2 vec1, Coord2 vec2) noexcept;
 
+// Check if two normalized axes are parallel, pointing the same or opposite ways. A zero vector isn't parallel to anything.
+constexpr bool areParallelAxes(Coord2 a, Coord2 b) noexcept {
+	const gFloat cross = a.cross(b);
+	return !a.isZero() && !b.isZero() && cross < constants::EPSILON && cross > -constants::EPSILON;
+}
+
 // Reflect a direction across a normal.
 constexpr Coord2 reflect(Coord2 dir, Coord2 norm) noexcept {
 	return dir - 2.0f * norm * dir.dot(norm);
@@ -17,7 +17,7 @@ struct Box2 {
 	constexpr Box2& operator=(Box2&& box) = default;
 	~Box2() = default;
 
-	constexpr bool operator==(const Box2& o) noexcept { return x == o.x && y == o.y && w == o.w && h == o.h; }
+	constexpr bool operator==(const Box2& o) const noexcept { return x == o.x && y == o.y && w == o.w && h == o.h; }
 
 	// Translate by a vector.
 	template <typename U>
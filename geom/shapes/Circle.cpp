@@ -1,20 +1,15 @@
 #include "Circle.hpp"
 
 #include "Polygon.hpp"
+#include "Rectangle.hpp"
 #include "../constants.hpp"
 
 namespace ctp {
 
 const std::size_t Circle::SEGS_IN_POLY = 20;
 
-Projection Circle::getProjection(Coord2 axis) const noexcept {
-	gFloat proj(axis.dot(center));
-	return Projection(proj - radius, proj + radius);
-}
-
-Coord2 Circle::getClosestTo(Coord2 point) const noexcept {
-	const Coord2 dir((point - center).normalize());
-	return dir * radius;
+Rect Circle::getAABB() const noexcept {
+	return Rect(left(), top(), right() - left(), bottom() - top());
 }
 
 Polygon Circle::toPoly() const {
@@ -1,12 +1,18 @@
 #ifndef INCLUDE_GEOM_CIRCLE_HPP
 #define INCLUDE_GEOM_CIRCLE_HPP
 
-#include "Shape.hpp"
+#include <cstddef>
+#include <type_traits>
+
 #include "../units.hpp"
 #include "../primitives/Projection.hpp"
 
+// Circle with a center and radius. Not polymorphic, and trivially copyable.
 namespace ctp {
-class Circle : public Shape {
+class Polygon;
+class Rect;
+
+class Circle {
 public:
 	static const std::size_t SEGS_IN_POLY;
 
@@ -18,14 +24,27 @@ public:
 	constexpr Circle(gFloat center_x, gFloat center_y, gFloat radius) noexcept : center(center_x, center_y), radius(radius) {}
 	constexpr Circle(Coord2 center, gFloat radius) noexcept : center(center), radius(radius) {}
 
-	inline gFloat left()   const noexcept override { return center.x - radius; }
-	inline gFloat right()  const noexcept override { return center.x + radius; }
-	inline gFloat top()    const noexcept override { return center.y - radius; }
-	inline gFloat bottom() const noexcept override { return center.y + radius; }
+	constexpr gFloat left()   const noexcept { return center.x - radius; }
+	constexpr gFloat right()  const noexcept { return center.x + radius; }
+	constexpr gFloat top()    const noexcept { return center.y - radius; }
+	constexpr gFloat bottom() const noexcept { return center.y + radius; }
 
-	Projection getProjection(Coord2 axis) const noexcept override;
-	Coord2 getClosestTo(Coord2 point) const noexcept override; // Gets closest point on the circle.
-	Polygon toPoly() const override;
+	Rect getAABB() const noexcept;
+	Projection getProjection(Coord2 axis) const noexcept;
+	Coord2 getClosestTo(Coord2 point) const noexcept; // Gets closest point on the circle.
+	Polygon toPoly() const;
 };
+static_assert(std::is_trivially_copyable_v<Circle>, "Circles can be copied as plain data.");
+
+// Inline, for callers that know they have a circle.
+inline Projection Circle::getProjection(Coord2 axis) const noexcept {
+	gFloat proj(axis.dot(center));
+	return Projection(proj - radius, proj + radius);
+}
+
+inline Coord2 Circle::getClosestTo(Coord2 point) const noexcept {
+	const Coord2 dir((point - center).normalize());
+	return dir * radius;
+}
 }
 #endif // INCLUDE_GEOM_CIRCLE_HPP
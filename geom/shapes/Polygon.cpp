@@ -1,192 +1,171 @@
 #include "Polygon.hpp"
 
+#include <algorithm>
+#include <cassert>
+#include <type_traits>
+
 #include "Rectangle.hpp"
 #include "../primitives/Projection.hpp"
 #include "../units.hpp"
 #include "../constants.hpp"
 #include "../math.hpp"
+#include "../simd.hpp"
+#include "../intersections/gjk.hpp"
 
 namespace ctp {
 
 namespace {
-constexpr Coord2 computeEdgeNormal(Coord2 first, Coord2 second) noexcept {
-	return Coord2(first.y - second.y, second.x - first.x).normalize();
-}
-}
+using simd::Lanes;
+using simd::LANES;
 
-Polygon::Polygon(std::vector<Coord2> vertices, bool computeEdgeNormals) : vertices_(std::move(vertices)) {
-	_find_bounds();
-	if (computeEdgeNormals)
-		computeNormals();
+// Find the minimum and maximum of a padded array of coordinates.
+Projection minMax(const gFloat* values, std::size_t paddedSize) noexcept {
+	Lanes min = Lanes::load(values);
+	Lanes max = min;
+	for (std::size_t i = LANES; i < paddedSize; i += LANES) {
+		const Lanes block = Lanes::load(values + i);
+		min = min.min(block);
+		max = max.max(block);
+	}
+	return Projection(min.minLane(), max.maxLane());
 }
 
-Polygon::Polygon(std::vector<Coord2> vertices, std::optional<std::vector<Coord2>> edgeNormals)
-	: vertices_(std::move(vertices))
-	, edge_normals_(std::move(edgeNormals)) {
-	_find_bounds();
+// Add a value to a padded array of coordinates.
+void offset(gFloat* values, std::size_t paddedSize, gFloat delta) noexcept {
+	const Lanes deltas = Lanes::fill(delta);
+	for (std::size_t i = 0; i < paddedSize; i += LANES)
+		(Lanes::load(values + i) + deltas).store(values + i);
+}
 }
 
-Projection Polygon::getProjection(Coord2 axis) const {
-	gFloat min = vertices_[0].dot(axis);
-	gFloat max = min;
-	for (std::size_t i = 1, size = vertices_.size(); i < size; ++i) {
-		const gFloat proj = vertices_[i].dot(axis);
-		if (proj < min)
-			min = proj;
-		else if (proj > max)
-			max = proj;
+const std::size_t Polygon::SUPPORT_TABLE_MIN_SIZE = 16;
+const std::size_t Polygon::MERGED_AXES_MAX_SIZE = gjk::AUTO_VERTEX_THRESHOLD;
+static_assert(gjk::AUTO_VERTEX_THRESHOLD <= 32, "Merged axes are kept as a bit per edge normal.");
+// Holding INLINE_SIZE vertices and their normals in place costs every polygon their size, used or not: 208 bytes in all on
+// 64-bit libstdc++. Keep it within four cache lines, since polygons are copied and moved whole.
+static_assert(sizeof(Polygon) <= 256, "Polygons should stay small enough to keep in place.");
+static_assert(std::is_nothrow_move_constructible_v<Polygon> && std::is_nothrow_move_assignable_v<Polygon>, "Moving a polygon never allocates.");
+
+Polygon::Polygon(std::vector<Coord2> vertices, bool computeEdgeNormals) : Polygon(vertices.data(), vertices.size(), computeEdgeNormals) {}
+
+Polygon::Polygon(const PolygonView& view) {
+	_resize_storage(view.size(), view.hasEdgeNormals());
+	for (std::size_t i = 0; i < size_; ++i)
+		_set_vertex(i, view[i]);
+	if (has_edge_normals_) {
+		for (std::size_t i = 0; i < size_; ++i)
+			_set_edge_normal(i, view.getEdgeNorm(i));
 	}
-	return Projection(min, max);
+	_finish_storage();
 }
 
-Coord2 Polygon::getClosestTo(Coord2 point) const {
-	std::optional<gFloat> minDist;
-	Coord2 closest;
-	for (auto& vertex : vertices_) {
-		const gFloat testDist = (point - vertex).magnitude2();
-		if (!minDist || testDist < *minDist) {
-			minDist = testDist;
-			closest = vertex;
-		}
-	}
-	return closest;
+Polygon::Polygon(const Coord2* vertices, std::size_t size, bool computeEdgeNormals) {
+	_store_vertices(vertices, size, computeEdgeNormals);
+}
+
+Rect Polygon::getAABB() const noexcept {
+	return view().getAABB();
 }
 
-Coord2 Polygon::getEdgeNorm(std::size_t index) const {
-	if (edge_normals_)
-		return (*edge_normals_)[index];
-	const Coord2 first = vertices_[index];
-	++index;
-	const Coord2 second = vertices_[index * (index < vertices_.size())]; // Wrap if necessary.
-	return computeEdgeNormal(first, second);
+Projection Polygon::getProjection(Coord2 axis) const {
+	return view().getProjection(axis);
 }
 
 void Polygon::computeNormals() {
-	if (edge_normals_)
+	if (has_edge_normals_)
 		return;
-	edge_normals_.emplace();
-	const size_t size = vertices_.size();
-	edge_normals_->reserve(size);
+	// Make room for the normals and their padding after the vertices, which stay where they are.
+	data_.resize(4 * static_cast<std::size_t>(padded_size_), 0);
+	has_edge_normals_ = true;
+	const size_t size = size_;
 	Coord2 first, second;
 	for (size_t i = 0; i < size;) {
-		first = vertices_[i];
-		++i;
-		second = vertices_[i * (i < size)];
-		edge_normals_->emplace_back(computeEdgeNormal(first, second));
+		first = (*this)[i];
+		second = (*this)[(i + 1) * (i + 1 < size)];
+		_set_edge_normal(i++, PolygonView::_edge_normal(first, second));
 	}
+	_merge_axes();
+	_compute_normal_angles();
 }
 
-Polygon::VerticesInDirection Polygon::getVerticesInDirection(Coord2 dir) const {
-	const int numVerts = static_cast<int>(vertices_.size());
-	// Look for where edge normals change from being acute with the given direction, to perpendicular or obtuse.
-	// The first and last vertices in the range will have only one acute edge normal.
-	VerticesInDirection result;
-	const math::AngleResult firstEdge = math::minAngle(getEdgeNorm(numVerts - 1), dir);
-	const bool isFirstEdgeAcute = firstEdge == math::AngleResult::ACUTE; // Whether this edge is inside or outside the region.
-	math::AngleResult prevEdge = firstEdge;
-	math::AngleResult currEdge = firstEdge;
-	int i = 0;
-	for (; i < numVerts - 1; ++i) {
-		currEdge = math::minAngle(getEdgeNorm(i), dir);
-		if (isFirstEdgeAcute != (currEdge == math::AngleResult::ACUTE)) { // Crossed into or out of the region.
-			if (isFirstEdgeAcute) {
-				result.last_index = i;
-				result.is_last_edge_perpendicular = currEdge == math::AngleResult::PERPENDICULAR;
-			} else {
-				result.first_index = i;
-				result.is_first_edge_perpendicular = prevEdge == math::AngleResult::PERPENDICULAR;
-			}
-			break;
-		}
-		prevEdge = currEdge;
-	}
-	// Loop backwards from the end of the polygon to find the other side of the region.
-	prevEdge = firstEdge;
-	int k = numVerts - 2;
-	for (; k != i; --k) {
-		currEdge = math::minAngle(getEdgeNorm(k), dir);
-		if (isFirstEdgeAcute != (currEdge == math::AngleResult::ACUTE)) // Crossed the region boundary again.
-			break;
-		prevEdge = currEdge;
-	}
-	if (isFirstEdgeAcute) {
-		result.first_index = k + 1;
-		result.is_first_edge_perpendicular = currEdge == math::AngleResult::PERPENDICULAR;
-	} else {
-		result.last_index = k + 1;
-		result.is_last_edge_perpendicular = prevEdge == math::AngleResult::PERPENDICULAR;
-	}
-	return result;
+Polygon Polygon::extend(Coord2 dir, gFloat dist, const VerticesInDirection& verticesInfo) const {
+	Polygon extended;
+	extend(dir, dist, verticesInfo, extended);
+	return extended;
 }
 
-Polygon Polygon::extend(Coord2 dir, gFloat dist, const VerticesInDirection& verticesInfo) const {
-	std::vector<Coord2> newVertices;
-	std::optional<std::vector<Coord2>> newEdgeNorms;
-	const int size = static_cast<int>(vertices_.size());
+void Polygon::extend(Coord2 dir, gFloat dist, const VerticesInDirection& verticesInfo, Polygon& out_polygon) const {
+	assert(&out_polygon != this);
+	const int size = static_cast<int>(size_);
 	const int numVerts = size + (verticesInfo.is_first_edge_perpendicular ? 0 : 1) + (verticesInfo.is_last_edge_perpendicular ? 0 : 1);
-	newVertices.reserve(numVerts);
-	if (edge_normals_) {
-		newEdgeNorms.emplace();
-		newEdgeNorms->reserve(numVerts);
-	}
+	out_polygon._resize_storage(numVerts, has_edge_normals_);
+	std::size_t vert = 0, norm = 0;
+	const auto addVertex = [&out_polygon, &vert](Coord2 vertex) { out_polygon._set_vertex(vert++, vertex); };
+	const auto addNorm = [&out_polygon, &norm](Coord2 normal) { out_polygon._set_edge_normal(norm++, normal); };
 	const Coord2 translation(dir * dist);
 	for (int i = 0; i < size; ++i) {
 		// Extend vertices in the region first-to-last inclusive. Duplicate first/last vertices if required.
 		if (i == verticesInfo.first_index && !verticesInfo.is_first_edge_perpendicular) {
-			newVertices.emplace_back(vertices_[i]);
-			newVertices.emplace_back(vertices_[i] + translation);
-			if (edge_normals_) {
-				newEdgeNorms->emplace_back(dir.perpCCW());
-				newEdgeNorms->emplace_back((*edge_normals_)[i]);
+			addVertex((*this)[i]);
+			addVertex((*this)[i] + translation);
+			if (has_edge_normals_) {
+				addNorm(dir.perpCCW());
+				addNorm(_get_edge_normal(i));
 			}
 		} else if (i == verticesInfo.last_index && !verticesInfo.is_last_edge_perpendicular) {
-			newVertices.emplace_back(vertices_[i] + translation);
-			newVertices.emplace_back(vertices_[i]);
-			if (edge_normals_) {
-				newEdgeNorms->emplace_back(dir.perpCW());
-				newEdgeNorms->emplace_back((*edge_normals_)[i]);
+			addVertex((*this)[i] + translation);
+			addVertex((*this)[i]);
+			if (has_edge_normals_) {
+				addNorm(dir.perpCW());
+				addNorm(_get_edge_normal(i));
 			}
 		} else {
-			newVertices.emplace_back(verticesInfo.first_index > verticesInfo.last_index ? // Determine which range to use.
-				((i <= verticesInfo.last_index || i >= verticesInfo.first_index) ? vertices_[i] + translation : vertices_[i]) : // Range overlaps end/start of the vector.
-				((i <= verticesInfo.last_index && i >= verticesInfo.first_index) ? vertices_[i] + translation : vertices_[i])); // Range is somewhere in the middle of the vector.
-			if (edge_normals_)
-				newEdgeNorms->emplace_back((*edge_normals_)[i]);
+			addVertex(verticesInfo.first_index > verticesInfo.last_index ? // Determine which range to use.
+				((i <= verticesInfo.last_index || i >= verticesInfo.first_index) ? (*this)[i] + translation : (*this)[i]) : // Range overlaps end/start of the vector.
+				((i <= verticesInfo.last_index && i >= verticesInfo.first_index) ? (*this)[i] + translation : (*this)[i])); // Range is somewhere in the middle of the vector.
+			if (has_edge_normals_)
+				addNorm(_get_edge_normal(i));
 		}
 	}
-	return Polygon(std::move(newVertices), std::move(newEdgeNorms));
+	out_polygon._finish_storage();
 }
 
 Polygon Polygon::clipExtend(Coord2 dir, gFloat dist, const VerticesInDirection& verticesInfo) const {
-	std::vector<Coord2> newVertices;
-	std::optional<std::vector<Coord2>> newEdgeNorms;
-	// Since we always duplicate when clipping, we will have last-to-first inclusive + 2x duplicates.
-	const std::size_t numVerts = std::abs(verticesInfo.last_index - verticesInfo.first_index) + 3;
-	newVertices.reserve(numVerts);
-	newVertices.emplace_back(vertices_[verticesInfo.first_index]); // First vertex gets duplicated.
-	if (edge_normals_) {
-		newEdgeNorms.emplace();
-		newEdgeNorms->reserve(numVerts);
-		newEdgeNorms->emplace_back(dir.perpCCW());
-	}
+	Polygon extended;
+	clipExtend(dir, dist, verticesInfo, extended);
+	return extended;
+}
+
+void Polygon::clipExtend(Coord2 dir, gFloat dist, const VerticesInDirection& verticesInfo, Polygon& out_polygon) const {
+	assert(&out_polygon != this);
+	const int size = static_cast<int>(size_);
+	// Since we always duplicate when clipping, we will have first-to-last inclusive + 2x duplicates.
+	const int numExtended = verticesInfo.last_index - verticesInfo.first_index + (verticesInfo.last_index < verticesInfo.first_index ? size : 0);
+	out_polygon._resize_storage(numExtended + 3, has_edge_normals_);
+	std::size_t vert = 0, norm = 0;
+	const auto addVertex = [&out_polygon, &vert](Coord2 vertex) { out_polygon._set_vertex(vert++, vertex); };
+	const auto addNorm = [&out_polygon, &norm](Coord2 normal) { out_polygon._set_edge_normal(norm++, normal); };
+	addVertex((*this)[verticesInfo.first_index]); // First vertex gets duplicated.
+	if (has_edge_normals_)
+		addNorm(dir.perpCCW());
 	const Coord2 translation(dir * dist);
-	for (int i = verticesInfo.first_index, size = static_cast<int>(vertices_.size()); i != verticesInfo.last_index; i = (++i < size) ? i : 0) {
-		newVertices.emplace_back(vertices_[i] + translation);
-		if (newEdgeNorms)
-			newEdgeNorms->emplace_back((*edge_normals_)[i]);
+	for (int i = verticesInfo.first_index; i != verticesInfo.last_index; i = (++i < size) ? i : 0) {
+		addVertex((*this)[i] + translation);
+		if (has_edge_normals_)
+			addNorm(_get_edge_normal(i));
 	}
-	newVertices.emplace_back(vertices_[verticesInfo.last_index] + translation);
-	newVertices.emplace_back(vertices_[verticesInfo.last_index]); // Last vertex gets duplicated.
-	if (newEdgeNorms) {
-		newEdgeNorms->emplace_back(dir.perpCW());
-		newEdgeNorms->emplace_back(computeEdgeNormal(vertices_[verticesInfo.last_index], vertices_[verticesInfo.first_index]));
+	addVertex((*this)[verticesInfo.last_index] + translation);
+	addVertex((*this)[verticesInfo.last_index]); // Last vertex gets duplicated.
+	if (has_edge_normals_) {
+		addNorm(dir.perpCW());
+		addNorm(PolygonView::_edge_normal((*this)[verticesInfo.last_index], (*this)[verticesInfo.first_index]));
 	}
-	return Polygon(std::move(newVertices), std::move(newEdgeNorms));
+	out_polygon._finish_storage();
 }
 
 void Polygon::translate(Coord2 delta) noexcept {
-	for (auto& vertex : vertices_)
-		vertex += delta;
+	offset(data_.data(), padded_size_, delta.x);
+	offset(data_.data() + padded_size_, padded_size_, delta.y);
 	x_min_ += delta.x;
 	x_max_ += delta.x;
 	y_min_ += delta.y;
@@ -199,20 +178,96 @@ Polygon Polygon::translate(const Polygon& p, Coord2 delta) {
 	return t;
 }
 
+void Polygon::_store_vertices(const Coord2* vertices, std::size_t size, bool computeEdgeNormals) {
+	_resize_storage(size, computeEdgeNormals);
+	for (std::size_t i = 0; i < size; ++i)
+		_set_vertex(i, vertices[i]);
+	if (computeEdgeNormals) {
+		for (std::size_t i = 0; i < size; ++i)
+			_set_edge_normal(i, PolygonView::_edge_normal(vertices[i], vertices[i + 1 < size ? i + 1 : 0]));
+	}
+	_finish_storage();
+}
+
+void Polygon::_resize_storage(std::size_t size, bool hasEdgeNormals) {
+	size_ = size;
+	padded_size_ = static_cast<std::uint32_t>(simd::paddedSize(size));
+	data_.resize(padded_size_ * (hasEdgeNormals ? 4 : 2));
+	has_edge_normals_ = hasEdgeNormals;
+	has_normal_angles_ = false;
+}
+
+void Polygon::_finish_storage() {
+	// Pad with copies of the first vertex, and zeroed normals.
+	const std::size_t padded = padded_size_;
+	for (std::size_t i = size_; i < padded; ++i) {
+		data_[i] = data_[0];
+		data_[padded + i] = data_[padded];
+	}
+	_find_bounds();
+	if (has_edge_normals_) {
+		for (std::size_t i = size_; i < padded; ++i)
+			_set_edge_normal(i, Coord2(0, 0));
+		_merge_axes();
+		_compute_normal_angles();
+	} else {
+		axes_ = 0;
+		two_sided_axes_ = 0;
+	}
+}
+
 void Polygon::_find_bounds() {
-	if (vertices_.empty())
+	if (size_ == 0)
+		return;
+	const Projection xBounds = minMax(data_.data(), padded_size_);
+	const Projection yBounds = minMax(data_.data() + padded_size_, padded_size_);
+	x_min_ = xBounds.min; x_max_ = xBounds.max;
+	y_min_ = yBounds.min; y_max_ = yBounds.max;
+}
+
+void Polygon::_merge_axes() {
+	axes_ = 0;
+	two_sided_axes_ = 0;
+	if (size_ >= MERGED_AXES_MAX_SIZE)
+		return;
+	for (std::size_t i = 0; i < size_; ++i) {
+		const Coord2 normal = _get_edge_normal(i);
+		std::size_t axis = 0;
+		while (axis < i && ((axes_ >> axis & 1) == 0 || !math::areParallelAxes(normal, _get_edge_normal(axis))))
+			++axis;
+		if (axis == i)
+			axes_ |= std::uint32_t(1) << i;
+		else if (normal.dot(_get_edge_normal(axis)) < 0)
+			two_sided_axes_ |= std::uint32_t(1) << axis;
+	}
+}
+
+void Polygon::_compute_normal_angles() {
+	const std::size_t size = size_;
+	const std::size_t tableStart = 4 * static_cast<std::size_t>(padded_size_);
+	has_normal_angles_ = false;
+	data_.resize(tableStart);
+	if (size < SUPPORT_TABLE_MIN_SIZE)
 		return;
-	x_min_ = vertices_[0].x; x_max_ = vertices_[0].x;
-	y_min_ = vertices_[0].y; y_max_ = vertices_[0].y;
-	for (std::size_t i = 1; i < vertices_.size(); ++i) {
-		if (x_min_ > vertices_[i].x)
-			x_min_ = vertices_[i].x;
-		if (x_max_ < vertices_[i].x)
-			x_max_ = vertices_[i].x;
-		if (y_min_ > vertices_[i].y)
-			y_min_ = vertices_[i].y;
-		if (y_max_ < vertices_[i].y)
-			y_max_ = vertices_[i].y;
+	for (std::size_t i = 0; i < size; ++i) {
+		const Coord2 norm = _get_edge_normal(i);
+		if (norm.isZero()) {
+			data_.resize(tableStart);
+			return; // Degenerate edge. Leave this polygon to the linear searches.
+		}
+		data_.push_back(PolygonView::_pseudo_angle(norm));
+	}
+	gFloat* const angles = data_.data() + tableStart;
+	// Following the winding, edge normal angles decrease until they wrap around once. Start the table after the wrap.
+	std::size_t start = 0;
+	for (std::size_t i = 0, prev = size - 1; i < size; prev = i++) {
+		if (angles[i] > angles[prev]) {
+			start = i;
+			break;
+		}
 	}
+	std::rotate(angles, angles + start, angles + size);
+	has_normal_angles_ = true;
+	normal_angles_start_ = static_cast<std::uint32_t>(start);
 }
 }
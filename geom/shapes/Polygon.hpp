@@ -1,78 +1,158 @@
 #ifndef INCLUDE_GEOM_POLYGON_HPP
 #define INCLUDE_GEOM_POLYGON_HPP
 
-#include "Shape.hpp"
-
-#include <optional>
+#include <cstdint>
 #include <vector>
 
+#include "PolygonView.hpp"
+#include "../units.hpp"
+#include "../small_vector.hpp"
+
 // Convex polygon with counterclockwise winding.
 // Vertices are in counterclockwise order, the final vertex connecting to the first vertex.
 namespace ctp {
-class Polygon : public Shape {
+class Rect;
+struct Projection;
+
+class Polygon {
+	friend class PolygonPool;
 public:
+	// Number of vertices a polygon holds in place with their edge normals: the common three to six vertices, padded to the
+	// SIMD width. Polygons that don't compute their normals use the room for twice as many vertices. Larger polygons keep their
+	// storage on the heap.
+	static constexpr std::size_t INLINE_SIZE = 8;
+
 	Polygon() = default;
 	Polygon(std::vector<Coord2> vertices, bool computeEdgeNormals = false);
+	// Copy the polygon a view refers to, with its edge normals if it has them.
+	explicit Polygon(const PolygonView& view);
 	Polygon(const Polygon&) = default;
 	Polygon(Polygon&&) = default;
 	Polygon& operator=(const Polygon&) = default;
 	Polygon& operator=(Polygon&&) = default;
 
-	gFloat left()   const override { return x_min_; }
-	gFloat right()  const override { return x_max_; }
-	gFloat top()    const override { return y_min_; }
-	gFloat bottom() const override { return y_max_; }
+	gFloat left()   const noexcept { return x_min_; }
+	gFloat right()  const noexcept { return x_max_; }
+	gFloat top()    const noexcept { return y_min_; }
+	gFloat bottom() const noexcept { return y_max_; }
 
-	Projection getProjection(Coord2 axis) const override;
+	Rect getAABB() const noexcept;
+	Projection getProjection(Coord2 axis) const;
 
-	Polygon toPoly() const noexcept override { return *this; }
+	Polygon toPoly() const { return *this; }
+	// Get a view of the polygon, for code that handles polygons wherever they are stored. It lasts until the polygon changes.
+	PolygonView view() const noexcept;
 
 	// Find the closest vertex to the given point.
 	// Note: this doesn't disqualify the edge case were the closest vertex could be on the "far" side of the polygon.
-	Coord2 getClosestTo(Coord2 point) const override;
+	Coord2 getClosestTo(Coord2 point) const { return view().getClosestTo(point); }
 
 	// Get normalized counter-clockwise edge normal for the polygon at a given index.
 	// Edges are indexed by vertex order, e.g. edge 0 is made from vertex 0 and 1.
-	Coord2 getEdgeNorm(std::size_t index) const;
+	Coord2 getEdgeNorm(std::size_t index) const { return view().getEdgeNorm(index); }
 	// Precompute all normals for the polygon. NOOP if already computed.
+	// Polygons with at least SUPPORT_TABLE_MIN_SIZE vertices also get a table of edge normal angles, so queries for their
+	// vertices in a direction (getSupportIndex, getProjection, getVerticesInDirection) can binary search it.
 	void computeNormals();
+	// Minimum number of vertices for a polygon to get a table of edge normal angles. Smaller polygons are faster to scan.
+	static const std::size_t SUPPORT_TABLE_MIN_SIZE;
+
+	// Get the number of separating axes the polygon has for SAT tests: its edge normals, with parallel normals (like those
+	// of opposite sides) merged. Normals are merged when they are computed, for polygons with fewer than MERGED_AXES_MAX_SIZE
+	// vertices. Otherwise each normal is its own axis.
+	std::size_t getNumAxes() const noexcept { return view().getNumAxes(); }
+	// Check if an edge normal is a separating axis. Merged axes are the first edge normal in each direction.
+	bool isAxis(std::size_t index) const noexcept { return axes_ == 0 || (axes_ >> index & 1) != 0; }
+	// Check if an opposite edge normal was merged into a separating axis, so the axis stands for both of its directions.
+	bool isTwoSidedAxis(std::size_t index) const noexcept { return (two_sided_axes_ >> index & 1) != 0; }
+	// Check if the polygon's parallel normals are merged. SAT also skips axes such a polygon shares with the other shape.
+	bool hasMergedAxes() const noexcept { return axes_ != 0; }
+	// Number of vertices from which polygons don't merge their axes. Pairs of shapes that big are tested with GJK, which doesn't use them.
+	static const std::size_t MERGED_AXES_MAX_SIZE;
+
+	// Find the index of the vertex farthest in a given direction. The direction doesn't need to be normalized.
+	std::size_t getSupportIndex(Coord2 dir) const { return view().getSupportIndex(dir); }
 
 	// Indicates vertices on a polygon in a given direction, following its winding (first > last is possible).
-	struct VerticesInDirection {
-		int first_index = -1;
-		int last_index = -1;
-		bool is_first_edge_perpendicular = false;
-		bool is_last_edge_perpendicular = false;
-	};
+	using VerticesInDirection = PolygonView::VerticesInDirection;
 	// Find the region of vertices in a given direction (for instance, to extend the polygon in that direction).
-	VerticesInDirection getVerticesInDirection(Coord2 dir) const;
+	VerticesInDirection getVerticesInDirection(Coord2 dir) const { return view().getVerticesInDirection(dir); }
 
 	// Extend a polygon by projecting it along a direction by dist.
 	[[nodiscard]] Polygon extend(Coord2 dir, gFloat dist) const { return extend(dir, dist, getVerticesInDirection(dir)); }
 	[[nodiscard]] Polygon extend(Coord2 dir, gFloat dist, const VerticesInDirection& verticesInfo) const;
+	// Extend a polygon into out_polygon, replacing its contents and reusing its storage. It must not be this polygon.
+	// If this polygon has its normals computed, they are copied rather than recomputed.
+	void extend(Coord2 dir, gFloat dist, Polygon& out_polygon) const { extend(dir, dist, getVerticesInDirection(dir), out_polygon); }
+	void extend(Coord2 dir, gFloat dist, const VerticesInDirection& verticesInfo, Polygon& out_polygon) const;
 
 	// Extend a polygon by projecting it along a direction by delta (dir*dist), clipping the result to only include
 	// the portion of the polygon that was extended.
 	[[nodiscard]] Polygon clipExtend(Coord2 dir, gFloat dist) const { return clipExtend(dir, dist, getVerticesInDirection(dir)); }
 	[[nodiscard]] Polygon clipExtend(Coord2 dir, gFloat dist, const VerticesInDirection& verticesInfo) const;
+	// Clip-extend a polygon into out_polygon, replacing its contents and reusing its storage. It must not be this polygon.
+	void clipExtend(Coord2 dir, gFloat dist, Polygon& out_polygon) const { clipExtend(dir, dist, getVerticesInDirection(dir), out_polygon); }
+	void clipExtend(Coord2 dir, gFloat dist, const VerticesInDirection& verticesInfo, Polygon& out_polygon) const;
 
 	void translate(Coord2 delta) noexcept;
 	[[nodiscard]] static Polygon translate(const Polygon& p, Coord2 delta);
 
-	Coord2 operator[](std::size_t index) const noexcept { return vertices_[index]; }
+	Coord2 operator[](std::size_t index) const noexcept { return Coord2(data_[index], data_[padded_size_ + index]); }
 	// Get the number of vertices in the polygon.
-	std::size_t size() const noexcept { return vertices_.size(); }
+	std::size_t size() const noexcept { return size_; }
 
 private:
-	Polygon(std::vector<Coord2> vertices, std::optional<std::vector<Coord2>> edgeNormals);
+	Polygon(const Coord2* vertices, std::size_t size, bool computeEdgeNormals);
+	// Replace the vertices, reusing the storage. Computes the edge normals if asked for.
+	void _store_vertices(const Coord2* vertices, std::size_t size, bool computeEdgeNormals);
+	// Size the storage for a number of vertices, and their edge normals if asked for, keeping any capacity it already has.
+	// Set each vertex (and normal), then finish with _finish_storage.
+	void _resize_storage(std::size_t size, bool hasEdgeNormals);
+	void _set_vertex(std::size_t index, Coord2 vertex) noexcept { data_[index] = vertex.x; data_[padded_size_ + index] = vertex.y; }
+	Coord2 _get_edge_normal(std::size_t index) const noexcept { return Coord2(data_[2 * padded_size_ + index], data_[3 * padded_size_ + index]); }
+	void _set_edge_normal(std::size_t index, Coord2 normal) noexcept { data_[2 * padded_size_ + index] = normal.x; data_[3 * padded_size_ + index] = normal.y; }
+	void _finish_storage();
 	void _find_bounds();
+	void _compute_normal_angles();
+	void _merge_axes();
 
-	std::vector<Coord2> vertices_;
+	// Everything is kept in one buffer, as structures of arrays. Vertices come first: all the x coordinates, then all the y
+	// coordinates. Each array is padded to a multiple of the SIMD width with copies of the first vertex, so they can be
+	// processed a full register at a time. Edge normals follow if they are computed, padded the same way: all their x
+	// components, then all their y components. Last is the table of normal angles, if the polygon has one.
+	// Polygons with up to INLINE_SIZE vertices and their normals fit in place, so making and copying them doesn't touch the heap.
+	SmallVector<gFloat, 4 * INLINE_SIZE> data_;
+	std::size_t size_{0};
 	gFloat x_min_{0};
 	gFloat x_max_{0};
 	gFloat y_min_{0};
 	gFloat y_max_{0};
-	std::optional<std::vector<Coord2>> edge_normals_;
+	std::uint32_t padded_size_{0};
+	// A bit for each edge normal that isn't parallel to an earlier one, if they are merged. Zero if they aren't.
+	std::uint32_t axes_{0};
+	// A bit for each of those axes that an opposite edge normal was merged into.
+	std::uint32_t two_sided_axes_{0};
+	// The table holds pseudo-angles of the edge normals, starting from edge normal_angles_start_ so they are in descending order.
+	std::uint32_t normal_angles_start_{0};
+	bool has_edge_normals_{false};
+	bool has_normal_angles_{false};
 };
+
+inline PolygonView Polygon::view() const noexcept {
+	PolygonView view;
+	view.coords_ = data_.data();
+	view.edge_normals_ = has_edge_normals_ ? data_.data() + 2 * static_cast<std::size_t>(padded_size_) : nullptr;
+	view.normal_angles_ = has_normal_angles_ ? data_.data() + 4 * static_cast<std::size_t>(padded_size_) : nullptr;
+	view.size_ = static_cast<std::uint32_t>(size_);
+	view.padded_size_ = padded_size_;
+	view.axes_ = axes_;
+	view.two_sided_axes_ = two_sided_axes_;
+	view.normal_angles_start_ = normal_angles_start_;
+	view.x_min_ = x_min_;
+	view.x_max_ = x_max_;
+	view.y_min_ = y_min_;
+	view.y_max_ = y_max_;
+	return view;
+}
 }
 #endif // INCLUDE_GEOM_POLYGON_HPP
@@ -0,0 +1,51 @@
+#include "PolygonPool.hpp"
+
+namespace ctp {
+PolygonPool::Handle PolygonPool::add(const Coord2* vertices, std::size_t size) {
+	scratch_._store_vertices(vertices, size, true);
+	return _append(scratch_.view());
+}
+
+PolygonPool::Handle PolygonPool::add(const Polygon& polygon, Coord2 pos) {
+	scratch_ = polygon;
+	scratch_.computeNormals();
+	scratch_.translate(pos);
+	return _append(scratch_.view());
+}
+
+void PolygonPool::clear() noexcept {
+	entries_.clear();
+	coords_.clear();
+	edge_normals_.clear();
+	normal_angles_.clear();
+}
+
+void PolygonPool::reserve(std::size_t size, std::size_t numVertices) {
+	// Each polygon pads its vertices to a whole register.
+	const std::size_t padded = numVertices + size * (simd::LANES - 1);
+	entries_.reserve(size);
+	coords_.reserve(2 * padded);
+	edge_normals_.reserve(2 * padded);
+}
+
+PolygonPool::Handle PolygonPool::_append(const PolygonView& polygon) {
+	const Handle handle = static_cast<Handle>(entries_.size());
+	Entry entry;
+	entry.offset = static_cast<std::uint32_t>(coords_.size() / 2);
+	entry.size = polygon.size_;
+	entry.normal_angles_offset = polygon.normal_angles_ ? static_cast<std::uint32_t>(normal_angles_.size()) : NO_NORMAL_ANGLES;
+	entry.normal_angles_start = polygon.normal_angles_start_;
+	entry.axes = polygon.axes_;
+	entry.two_sided_axes = polygon.two_sided_axes_;
+	entry.x_min = polygon.x_min_;
+	entry.x_max = polygon.x_max_;
+	entry.y_min = polygon.y_min_;
+	entry.y_max = polygon.y_max_;
+	coords_.insert(coords_.end(), polygon.coords_, polygon.coords_ + 2 * static_cast<std::size_t>(polygon.padded_size_));
+	edge_normals_.insert(edge_normals_.end(), polygon.edge_normals_, polygon.edge_normals_ + 2 * static_cast<std::size_t>(polygon.padded_size_));
+	if (polygon.normal_angles_)
+		normal_angles_.insert(normal_angles_.end(), polygon.normal_angles_, polygon.normal_angles_ + polygon.size_);
+	entries_.push_back(entry);
+	return handle;
+}
+}
@@ -0,0 +1,119 @@
+#ifndef INCLUDE_GEOM_POLYGON_POOL_HPP
+#define INCLUDE_GEOM_POLYGON_POOL_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <vector>
+
+#include "Polygon.hpp"
+#include "PolygonView.hpp"
+#include "../simd.hpp"
+
+// Contiguous storage for large sets of polygons that rarely change, such as the walls of a level.
+// Every polygon's vertices share one buffer of coordinates, and their edge normals (always precomputed) share another, back
+// to back in the order they were added. Each polygon keeps its x coordinates then its y coordinates, and its normals' x
+// components then their y components, padded as Polygon pads them. A table of entries gives each polygon's offset into the buffers, its number of vertices, and its bounds and
+// axes, so looking a polygon up touches one entry and then reads its data in order.
+// Polygons are referred to by handles, which stay valid as the pool grows. Views of polygons only last until the next add.
+namespace ctp {
+class PooledPolygon;
+
+class PolygonPool {
+	friend class PooledPolygon;
+public:
+	using Handle = std::uint32_t;
+
+	PolygonPool() = default;
+	// Pooled polygons point at their pool, so a pool stays where it was made.
+	PolygonPool(const PolygonPool&) = delete;
+	PolygonPool(PolygonPool&&) = delete;
+	PolygonPool& operator=(const PolygonPool&) = delete;
+	PolygonPool& operator=(PolygonPool&&) = delete;
+
+	// Add a polygon, copying its vertices. Returns its handle. Handles are given out in the order polygons are added.
+	Handle add(const Coord2* vertices, std::size_t size);
+	Handle add(const std::vector<Coord2>& vertices) { return add(vertices.data(), vertices.size()); }
+	// Add a copy of a polygon at a position.
+	Handle add(const Polygon& polygon, Coord2 pos = Coord2(0, 0));
+	// Remove every polygon. Invalidates all handles.
+	void clear() noexcept;
+	// Reserve space for a number of polygons, with a number of vertices between them.
+	void reserve(std::size_t size, std::size_t numVertices = 0);
+
+	// Get a view of a polygon in the pool.
+	PolygonView operator[](Handle handle) const noexcept;
+	// Get a pooled polygon to keep in a ShapeContainer, or pass anywhere a ConstShapeRef is expected.
+	PooledPolygon get(Handle handle) const noexcept;
+	// Get the number of polygons in the pool.
+	std::size_t size() const noexcept { return entries_.size(); }
+	bool empty() const noexcept { return entries_.empty(); }
+
+private:
+	// Where a polygon's data starts in the buffers, and what is known about it without reading them.
+	struct Entry {
+		std::uint32_t offset; // In padded vertices: its coordinates and its normals both start at twice this.
+		std::uint32_t size;
+		std::uint32_t normal_angles_offset; // NO_NORMAL_ANGLES if the polygon doesn't have a table.
+		std::uint32_t normal_angles_start;
+		std::uint32_t axes;
+		std::uint32_t two_sided_axes;
+		gFloat x_min;
+		gFloat x_max;
+		gFloat y_min;
+		gFloat y_max;
+	};
+	static constexpr std::uint32_t NO_NORMAL_ANGLES = ~std::uint32_t(0);
+
+	Handle _append(const PolygonView& polygon);
+
+	std::vector<Entry> entries_;
+	std::vector<gFloat> coords_;
+	// Padded like the vertices, so one offset finds both.
+	std::vector<gFloat> edge_normals_;
+	std::vector<gFloat> normal_angles_;
+	// Polygons are built here before they are copied in, so adding them reuses its storage.
+	Polygon scratch_;
+};
+
+// A polygon in a pool: the pool and the polygon's handle. Shapes that refer to it hold it by value, so it can be kept
+// anywhere, and it stays valid until its pool is cleared or destroyed.
+class PooledPolygon {
+public:
+	constexpr PooledPolygon(const PolygonPool& pool, PolygonPool::Handle handle) noexcept : pool_{&pool}, handle_{handle} {}
+
+	constexpr const PolygonPool& pool() const noexcept { return *pool_; }
+	constexpr PolygonPool::Handle handle() const noexcept { return handle_; }
+	// Get a view of the polygon. It only lasts until the next add to its pool.
+	PolygonView view() const noexcept { return (*pool_)[handle_]; }
+	// Get the address of the polygon's entry in its pool, to identify it.
+	const void* address() const noexcept { return &pool_->entries_[handle_]; }
+
+private:
+	const PolygonPool* pool_;
+	PolygonPool::Handle handle_;
+};
+static_assert(std::is_trivially_copyable_v<PooledPolygon>, "Pooled polygons can be copied as plain data.");
+static_assert(!std::is_copy_constructible_v<PolygonPool> && !std::is_move_constructible_v<PolygonPool>, "Pools can't be copied or moved out from under their pooled polygons.");
+
+inline PolygonView PolygonPool::operator[](Handle handle) const noexcept {
+	const Entry& entry = entries_[handle];
+	PolygonView view;
+	view.coords_ = coords_.data() + 2 * static_cast<std::size_t>(entry.offset);
+	view.edge_normals_ = edge_normals_.data() + 2 * static_cast<std::size_t>(entry.offset);
+	view.normal_angles_ = entry.normal_angles_offset == NO_NORMAL_ANGLES ? nullptr : normal_angles_.data() + entry.normal_angles_offset;
+	view.size_ = entry.size;
+	view.padded_size_ = static_cast<std::uint32_t>(simd::paddedSize(entry.size));
+	view.axes_ = entry.axes;
+	view.two_sided_axes_ = entry.two_sided_axes;
+	view.normal_angles_start_ = entry.normal_angles_start;
+	view.x_min_ = entry.x_min;
+	view.x_max_ = entry.x_max;
+	view.y_min_ = entry.y_min;
+	view.y_max_ = entry.y_max;
+	return view;
+}
+
+inline PooledPolygon PolygonPool::get(Handle handle) const noexcept { return PooledPolygon(*this, handle); }
+}
+#endif // INCLUDE_GEOM_POLYGON_POOL_HPP
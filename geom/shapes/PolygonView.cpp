@@ -0,0 +1,177 @@
+#include "PolygonView.hpp"
+
+#include <algorithm>
+#include <functional>
+#include <optional>
+
+#include "Polygon.hpp"
+#include "Rectangle.hpp"
+#include "../primitives/Projection.hpp"
+#include "../units.hpp"
+#include "../math.hpp"
+#include "../simd.hpp"
+
+namespace ctp {
+
+namespace {
+// Minimum number of vertices for getProjection to search the normal angle table instead of running the projection kernel.
+constexpr std::size_t SEARCHED_PROJECTION_MIN_SIZE = 96;
+
+using simd::Lanes;
+using simd::LANES;
+
+// Find the minimum and maximum dot products of padded arrays of vertices with an axis.
+Projection project(const gFloat* xs, const gFloat* ys, std::size_t paddedSize, Coord2 axis) noexcept {
+	const Lanes axisX = Lanes::fill(axis.x);
+	const Lanes axisY = Lanes::fill(axis.y);
+	Lanes min = Lanes::load(xs) * axisX + Lanes::load(ys) * axisY;
+	Lanes max = min;
+	for (std::size_t i = LANES; i < paddedSize; i += LANES) {
+		const Lanes proj = Lanes::load(xs + i) * axisX + Lanes::load(ys + i) * axisY;
+		min = min.min(proj);
+		max = max.max(proj);
+	}
+	return Projection(min.minLane(), max.maxLane());
+}
+}
+
+Rect PolygonView::getAABB() const noexcept {
+	return Rect(left(), top(), right() - left(), bottom() - top());
+}
+
+Projection PolygonView::getProjection(Coord2 axis) const {
+	if (normal_angles_ && size_ >= SEARCHED_PROJECTION_MIN_SIZE)
+		return Projection((*this)[_search_normal_angles(-axis)].dot(axis), (*this)[_search_normal_angles(axis)].dot(axis));
+	return project(coords_, coords_ + padded_size_, padded_size_, axis);
+}
+
+Polygon PolygonView::toPoly() const {
+	return Polygon(*this);
+}
+
+Coord2 PolygonView::getClosestTo(Coord2 point) const {
+	std::optional<gFloat> minDist;
+	Coord2 closest;
+	for (std::size_t i = 0; i < size_; ++i) {
+		const Coord2 vertex = (*this)[i];
+		const gFloat testDist = (point - vertex).magnitude2();
+		if (!minDist || testDist < *minDist) {
+			minDist = testDist;
+			closest = vertex;
+		}
+	}
+	return closest;
+}
+
+Coord2 PolygonView::getEdgeNorm(std::size_t index) const {
+	if (edge_normals_)
+		return Coord2(edge_normals_[index], edge_normals_[padded_size_ + index]);
+	const Coord2 first = (*this)[index];
+	++index;
+	const Coord2 second = (*this)[index * (index < size_)]; // Wrap if necessary.
+	return _edge_normal(first, second);
+}
+
+std::size_t PolygonView::getNumAxes() const noexcept {
+	if (axes_ == 0)
+		return size_;
+	std::size_t numAxes = 0;
+	for (std::uint32_t bits = axes_; bits != 0; bits &= bits - 1)
+		++numAxes;
+	return numAxes;
+}
+
+std::size_t PolygonView::getSupportIndex(Coord2 dir) const {
+	if (normal_angles_)
+		return _search_normal_angles(dir);
+	std::size_t best = 0;
+	gFloat bestProj = (*this)[0].dot(dir);
+	for (std::size_t i = 1, size = size_; i < size; ++i) {
+		const gFloat proj = (*this)[i].dot(dir);
+		if (proj > bestProj) {
+			bestProj = proj;
+			best = i;
+		}
+	}
+	return best;
+}
+
+PolygonView::VerticesInDirection PolygonView::getVerticesInDirection(Coord2 dir) const {
+	if (normal_angles_)
+		return _search_vertices_in_direction(dir);
+	const int numVerts = static_cast<int>(size_);
+	// Look for where edge normals change from being acute with the given direction, to perpendicular or obtuse.
+	// The first and last vertices in the range will have only one acute edge normal.
+	VerticesInDirection result;
+	const math::AngleResult firstEdge = math::minAngle(getEdgeNorm(numVerts - 1), dir);
+	const bool isFirstEdgeAcute = firstEdge == math::AngleResult::ACUTE; // Whether this edge is inside or outside the region.
+	math::AngleResult prevEdge = firstEdge;
+	math::AngleResult currEdge = firstEdge;
+	int i = 0;
+	for (; i < numVerts - 1; ++i) {
+		currEdge = math::minAngle(getEdgeNorm(i), dir);
+		if (isFirstEdgeAcute != (currEdge == math::AngleResult::ACUTE)) { // Crossed into or out of the region.
+			if (isFirstEdgeAcute) {
+				result.last_index = i;
+				result.is_last_edge_perpendicular = currEdge == math::AngleResult::PERPENDICULAR;
+			} else {
+				result.first_index = i;
+				result.is_first_edge_perpendicular = prevEdge == math::AngleResult::PERPENDICULAR;
+			}
+			break;
+		}
+		prevEdge = currEdge;
+	}
+	// Loop backwards from the end of the polygon to find the other side of the region.
+	prevEdge = firstEdge;
+	int k = numVerts - 2;
+	for (; k != i; --k) {
+		currEdge = math::minAngle(getEdgeNorm(k), dir);
+		if (isFirstEdgeAcute != (currEdge == math::AngleResult::ACUTE)) // Crossed the region boundary again.
+			break;
+		prevEdge = currEdge;
+	}
+	if (isFirstEdgeAcute) {
+		result.first_index = k + 1;
+		result.is_first_edge_perpendicular = currEdge == math::AngleResult::PERPENDICULAR;
+	} else {
+		result.last_index = k + 1;
+		result.is_last_edge_perpendicular = prevEdge == math::AngleResult::PERPENDICULAR;
+	}
+	return result;
+}
+
+std::size_t PolygonView::_search_normal_angles(Coord2 dir) const {
+	// The farthest vertex in a direction is between the last edge normal above the direction's angle and the first one below it.
+	const std::size_t size = size_;
+	const gFloat* const angles = normal_angles_;
+	const std::size_t offset = std::lower_bound(angles, angles + size, _pseudo_angle(dir), std::greater<gFloat>()) - angles;
+	const std::size_t index = normal_angles_start_ + (offset < size ? offset : 0);
+	return index < size ? index : index - size;
+}
+
+PolygonView::VerticesInDirection PolygonView::_search_vertices_in_direction(Coord2 dir) const {
+	const std::size_t size = size_;
+	const auto next = [size](std::size_t i) { return i + 1 < size ? i + 1 : 0; };
+	const auto prev = [size](std::size_t i) { return i > 0 ? i - 1 : size - 1; };
+	const auto edgeAngle = [this, dir](std::size_t i) { return math::minAngle(getEdgeNorm(i), dir); };
+	// The region's edges have normals within 90 degrees of the direction, so it spans the farthest vertices in either
+	// perpendicular direction. Then step over nearly perpendicular edges, classifying them the same way as the linear search.
+	std::size_t first = _search_normal_angles(dir.perpCCW());
+	std::size_t last = prev(_search_normal_angles(dir.perpCW()));
+	for (std::size_t i = 0; i < size && edgeAngle(first) != math::AngleResult::ACUTE; ++i)
+		first = next(first);
+	for (std::size_t i = 0; i < size && edgeAngle(prev(first)) == math::AngleResult::ACUTE; ++i)
+		first = prev(first);
+	for (std::size_t i = 0; i < size && edgeAngle(last) != math::AngleResult::ACUTE; ++i)
+		last = prev(last);
+	for (std::size_t i = 0; i < size && edgeAngle(next(last)) == math::AngleResult::ACUTE; ++i)
+		last = next(last);
+	VerticesInDirection result;
+	result.first_index = static_cast<int>(first);
+	result.last_index = static_cast<int>(next(last));
+	result.is_first_edge_perpendicular = edgeAngle(prev(first)) == math::AngleResult::PERPENDICULAR;
+	result.is_last_edge_perpendicular = edgeAngle(next(last)) == math::AngleResult::PERPENDICULAR;
+	return result;
+}
+}
@@ -0,0 +1,97 @@
+#ifndef INCLUDE_GEOM_POLYGON_VIEW_HPP
+#define INCLUDE_GEOM_POLYGON_VIEW_HPP
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+#include "../units.hpp"
+
+// A read-only view of a polygon's storage, which a Polygon or a PolygonPool owns. It answers the same queries as a polygon,
+// so narrowphase tests run the same code on polygons wherever they are kept.
+// Views are plain data and cheap to make. One only lasts until its polygon changes, or its pool is added to.
+namespace ctp {
+class Rect;
+class Polygon;
+struct Projection;
+
+class PolygonView {
+	friend class Polygon;
+	friend class PolygonPool;
+public:
+	PolygonView() = default;
+
+	gFloat left()   const noexcept { return x_min_; }
+	gFloat right()  const noexcept { return x_max_; }
+	gFloat top()    const noexcept { return y_min_; }
+	gFloat bottom() const noexcept { return y_max_; }
+
+	Rect getAABB() const noexcept;
+	Projection getProjection(Coord2 axis) const;
+
+	// Copy the viewed polygon.
+	Polygon toPoly() const;
+
+	// Find the closest vertex to the given point.
+	Coord2 getClosestTo(Coord2 point) const;
+
+	// Get normalized counter-clockwise edge normal for the polygon at a given index.
+	Coord2 getEdgeNorm(std::size_t index) const;
+	// Check if the polygon has its edge normals computed.
+	bool hasEdgeNormals() const noexcept { return edge_normals_ != nullptr; }
+
+	// Get the number of separating axes the polygon has for SAT tests. See Polygon::getNumAxes.
+	std::size_t getNumAxes() const noexcept;
+	bool isAxis(std::size_t index) const noexcept { return axes_ == 0 || (axes_ >> index & 1) != 0; }
+	bool isTwoSidedAxis(std::size_t index) const noexcept { return (two_sided_axes_ >> index & 1) != 0; }
+	bool hasMergedAxes() const noexcept { return axes_ != 0; }
+
+	// Find the index of the vertex farthest in a given direction. The direction doesn't need to be normalized.
+	std::size_t getSupportIndex(Coord2 dir) const;
+
+	// Indicates vertices on a polygon in a given direction, following its winding (first > last is possible).
+	struct VerticesInDirection {
+		int first_index = -1;
+		int last_index = -1;
+		bool is_first_edge_perpendicular = false;
+		bool is_last_edge_perpendicular = false;
+	};
+	// Find the region of vertices in a given direction (for instance, to extend the polygon in that direction).
+	VerticesInDirection getVerticesInDirection(Coord2 dir) const;
+
+	Coord2 operator[](std::size_t index) const noexcept { return Coord2(coords_[index], coords_[padded_size_ + index]); }
+	// Get the number of vertices in the polygon.
+	std::size_t size() const noexcept { return size_; }
+
+private:
+	static Coord2 _edge_normal(Coord2 first, Coord2 second) noexcept {
+		return Coord2(first.y - second.y, second.x - first.x).normalize();
+	}
+	// A value in [0, 4) that increases with a vector's angle, like atan2 without the trigonometry.
+	static gFloat _pseudo_angle(Coord2 vec) noexcept {
+		const gFloat x = vec.x / (std::abs(vec.x) + std::abs(vec.y));
+		return vec.y < 0 ? 3 + x : 1 - x;
+	}
+	std::size_t _search_normal_angles(Coord2 dir) const;
+	VerticesInDirection _search_vertices_in_direction(Coord2 dir) const;
+
+	// Padded x coordinates followed by padded y coordinates, as Polygon stores them.
+	const gFloat* coords_{nullptr};
+	// Padded x components of the edge normals followed by their padded y components, or null if they aren't computed.
+	const gFloat* edge_normals_{nullptr};
+	// The table of edge normal angles, or null if the polygon doesn't have one.
+	const gFloat* normal_angles_{nullptr};
+	std::uint32_t size_{0};
+	std::uint32_t padded_size_{0};
+	std::uint32_t axes_{0};
+	std::uint32_t two_sided_axes_{0};
+	std::uint32_t normal_angles_start_{0};
+	gFloat x_min_{0};
+	gFloat x_max_{0};
+	gFloat y_min_{0};
+	gFloat y_max_{0};
+};
+static_assert(std::is_trivially_copyable_v<PolygonView>, "Polygon views can be copied as plain data.");
+}
+#endif // INCLUDE_GEOM_POLYGON_VIEW_HPP
@@ -1,11 +1,17 @@
 #ifndef INCLUDE_GEOM_RECT_HPP
 #define INCLUDE_GEOM_RECT_HPP
 
-#include "Shape.hpp"
+#include <type_traits>
+
+#include "../units.hpp"
 #include "../primitives/Box2.hpp"
+#include "../primitives/Projection.hpp"
 
+// Axis-aligned rectangle. Not polymorphic, and trivially copyable, so it's no bigger than its box.
 namespace ctp {
-class Rect : public Box2<gFloat>, public Shape {
+class Polygon;
+
+class Rect : public Box2<gFloat> {
 public:
 	using Box2::Box2;
 	constexpr Rect(Box2 b) noexcept : Box2{b} {};
@@ -14,14 +20,53 @@ public:
 	constexpr gFloat center_x() const noexcept { return x + w * 0.5f; }
 	constexpr gFloat center_y() const noexcept { return y + h * 0.5f; }
 
-	gFloat left() const noexcept override { return Box2::left(); }
-	gFloat right() const noexcept override { return Box2::right(); }
-	gFloat top() const noexcept override { return Box2::top(); }
-	gFloat bottom() const noexcept override { return Box2::bottom(); }
-
-	Projection getProjection(Coord2 axis) const noexcept override;
-	Coord2 getClosestTo(Coord2 point) const noexcept override; // Gets closest corner of the rectangle.
-	Polygon toPoly() const override;
+	constexpr Rect getAABB() const noexcept { return *this; }
+	Projection getProjection(Coord2 axis) const noexcept;
+	Coord2 getClosestTo(Coord2 point) const noexcept; // Gets closest corner of the rectangle.
+	Polygon toPoly() const;
 };
+static_assert(std::is_trivially_copyable_v<Rect> && sizeof(Rect) == sizeof(Box2<gFloat>), "Rectangles can be copied as their boxes.");
+
+// Defined here so they can be inlined into narrowphase kernels that call them directly.
+inline Projection Rect::getProjection(Coord2 axis) const noexcept {
+	gFloat proj{axis.dot(topLeft())};
+	gFloat min{proj};
+	gFloat max{proj};
+	proj = axis.dot(topRight());
+	if (proj < min)
+		min = proj;
+	else // Max and min are the same right now.
+		max = proj;
+	proj = axis.dot(bottomLeft());
+	if (proj < min)
+		min = proj;
+	else if (proj > max)
+		max = proj;
+	proj = axis.dot(bottomRight());
+	if (proj < min)
+		min = proj;
+	else if (proj > max)
+		max = proj;
+	return Projection{min, max};
+}
+
+inline Coord2 Rect::getClosestTo(Coord2 point) const noexcept {
+	gFloat minDist{(point - topLeft()).magnitude2()};
+	Coord2 closest{topLeft()};
+	gFloat testDist{(point - topRight()).magnitude2()};
+	if (testDist < minDist) {
+		minDist = testDist;
+		closest = topRight();
+	}
+	testDist = (point - bottomRight()).magnitude2();
+	if (testDist < minDist) {
+		minDist = testDist;
+		closest = bottomRight();
+	}
+	testDist = (point - bottomLeft()).magnitude2();
+	if (testDist < minDist)
+		closest = bottomLeft();
+	return closest;
+}
 }
 #endif // INCLUDE_GEOM_RECT_HPP
@@ -0,0 +1,51 @@
+#include "ShapeContainer.hpp"
+
+#include "../units.hpp"
+#include "../debug_logger.hpp"
+#include "../primitives/Projection.hpp"
+
+namespace ctp {
+Rect getAABB(ConstShapeRef shape) {
+	switch (shape.type()) {
+		case ShapeType::Rectangle: return shape.rect().getAABB();
+		case ShapeType::Polygon: return shape.poly().getAABB();
+		case ShapeType::Circle: return shape.circle().getAABB();
+		case ShapeType::PooledPolygon: return shape.pooled().view().getAABB();
+	}
+	DBG_ERR("Unhandled shape type for bounding box.");
+	return Rect();
+}
+
+Projection getProjection(ConstShapeRef shape, Coord2 axis) {
+	switch (shape.type()) {
+		case ShapeType::Rectangle: return shape.rect().getProjection(axis);
+		case ShapeType::Polygon: return shape.poly().getProjection(axis);
+		case ShapeType::Circle: return shape.circle().getProjection(axis);
+		case ShapeType::PooledPolygon: return shape.pooled().view().getProjection(axis);
+	}
+	DBG_ERR("Unhandled shape type for projection.");
+	return Projection();
+}
+
+Coord2 getClosestTo(ConstShapeRef shape, Coord2 point) {
+	switch (shape.type()) {
+		case ShapeType::Rectangle: return shape.rect().getClosestTo(point);
+		case ShapeType::Polygon: return shape.poly().getClosestTo(point);
+		case ShapeType::Circle: return shape.circle().getClosestTo(point);
+		case ShapeType::PooledPolygon: return shape.pooled().view().getClosestTo(point);
+	}
+	DBG_ERR("Unhandled shape type for closest point.");
+	return Coord2();
+}
+
+Polygon toPoly(ConstShapeRef shape) {
+	switch (shape.type()) {
+		case ShapeType::Rectangle: return shape.rect().toPoly();
+		case ShapeType::Polygon: return shape.poly();
+		case ShapeType::Circle: return shape.circle().toPoly();
+		case ShapeType::PooledPolygon: return shape.pooled().view().toPoly();
+	}
+	DBG_ERR("Unhandled shape type for polygon conversion.");
+	return Polygon();
+}
+}
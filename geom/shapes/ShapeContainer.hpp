@@ -4,7 +4,9 @@
 #include "Rectangle.hpp"
 #include "Polygon.hpp"
 #include "Circle.hpp"
+#include "PolygonPool.hpp"
 #include <cassert>
+#include <type_traits>
 #include <variant>
 
 // Classes for passing typed shapes around. Must contain a shape.
@@ -14,15 +16,19 @@ enum class ShapeType {
 	Rectangle,
 	Polygon,
 	Circle,
+	PooledPolygon,
 };
 
 class ShapeContainer;
 
+// References are a type and a pointer to the shape of that type, or the handle of a pooled polygon: shapes have no common
+// base class or vtable.
 class ShapeRef {
 public:
-	constexpr ShapeRef(Rect& r) noexcept : type_{ShapeType::Rectangle}, shape_{&r} {}
-	constexpr ShapeRef(Polygon& p) noexcept : type_{ShapeType::Polygon}, shape_{&p} {}
-	constexpr ShapeRef(Circle& c) noexcept : type_{ShapeType::Circle}, shape_{&c} {}
+	constexpr ShapeRef(Rect& r) noexcept : type_{ShapeType::Rectangle}, rect_{&r} {}
+	constexpr ShapeRef(Polygon& p) noexcept : type_{ShapeType::Polygon}, poly_{&p} {}
+	constexpr ShapeRef(Circle& c) noexcept : type_{ShapeType::Circle}, circle_{&c} {}
+	constexpr ShapeRef(PooledPolygon p) noexcept : type_{ShapeType::PooledPolygon}, pooled_{p} {}
 	constexpr ShapeRef(ShapeContainer& c) noexcept;
 
 	ShapeRef() = delete;
@@ -32,28 +38,46 @@ public:
 	ShapeRef& operator=(ShapeRef&&) = default;
 
 	constexpr const ShapeType& type() const noexcept { return type_; }
-	constexpr const Shape& shape() const noexcept { return *shape_; }
-	constexpr const Rect& rect() const noexcept { assert(type_ == ShapeType::Rectangle); return static_cast<Rect&>(*shape_); }
-	constexpr const Polygon& poly() const noexcept { assert(type_ == ShapeType::Polygon); return static_cast<Polygon&>(*shape_); }
-	constexpr const Circle& circle() const noexcept { assert(type_ == ShapeType::Circle); return static_cast<Circle&>(*shape_); }
-	constexpr Shape& shape() noexcept { return *shape_; }
-	constexpr Rect& rect() noexcept { assert(type_ == ShapeType::Rectangle); return static_cast<Rect&>(*shape_); }
-	constexpr Polygon& poly() noexcept { assert(type_ == ShapeType::Polygon); return static_cast<Polygon&>(*shape_); }
-	constexpr Circle& circle() noexcept { assert(type_ == ShapeType::Circle); return static_cast<Circle&>(*shape_); }
+	// Get the address of the shape, to identify it.
+	constexpr const void* address() const noexcept {
+		switch (type_) {
+			case ShapeType::Rectangle: return rect_;
+			case ShapeType::Polygon: return poly_;
+			case ShapeType::Circle: return circle_;
+			case ShapeType::PooledPolygon: return pooled_.address();
+		}
+		return nullptr;
+	}
+	constexpr const Rect& rect() const noexcept { assert(type_ == ShapeType::Rectangle); return *rect_; }
+	constexpr const Polygon& poly() const noexcept { assert(type_ == ShapeType::Polygon); return *poly_; }
+	constexpr const Circle& circle() const noexcept { assert(type_ == ShapeType::Circle); return *circle_; }
+	constexpr PooledPolygon pooled() const noexcept { assert(type_ == ShapeType::PooledPolygon); return pooled_; }
+	constexpr Rect& rect() noexcept { assert(type_ == ShapeType::Rectangle); return *rect_; }
+	constexpr Polygon& poly() noexcept { assert(type_ == ShapeType::Polygon); return *poly_; }
+	constexpr Circle& circle() noexcept { assert(type_ == ShapeType::Circle); return *circle_; }
 protected:
-	constexpr ShapeRef(ShapeType t) noexcept : type_{t} {}
-	constexpr void setShape(Shape& s) noexcept { shape_ = &s; }
+	constexpr ShapeRef(ShapeType t) noexcept : type_{t}, rect_{nullptr} {}
+	constexpr void setShape(Rect& r) noexcept { rect_ = &r; }
+	constexpr void setShape(Polygon& p) noexcept { poly_ = &p; }
+	constexpr void setShape(Circle& c) noexcept { circle_ = &c; }
+	constexpr void setShape(PooledPolygon p) noexcept { pooled_ = p; }
 	ShapeType type_;
 private:
-	Shape* shape_{nullptr};
+	union {
+		Rect* rect_;
+		Polygon* poly_;
+		Circle* circle_;
+		PooledPolygon pooled_;
+	};
 };
 
 class ConstShapeRef {
 public:
-	constexpr ConstShapeRef(const Rect& r) noexcept : type_{ShapeType::Rectangle}, shape_{&r} {}
-	constexpr ConstShapeRef(const Polygon& p) noexcept : type_{ShapeType::Polygon}, shape_{&p} {}
-	constexpr ConstShapeRef(const Circle& c) noexcept : type_{ShapeType::Circle}, shape_{&c} {}
-	constexpr ConstShapeRef(const ShapeRef& r) noexcept : type_{r.type()}, shape_{&r.shape()} {}
+	constexpr ConstShapeRef(const Rect& r) noexcept : type_{ShapeType::Rectangle}, rect_{&r} {}
+	constexpr ConstShapeRef(const Polygon& p) noexcept : type_{ShapeType::Polygon}, poly_{&p} {}
+	constexpr ConstShapeRef(const Circle& c) noexcept : type_{ShapeType::Circle}, circle_{&c} {}
+	constexpr ConstShapeRef(PooledPolygon p) noexcept : type_{ShapeType::PooledPolygon}, pooled_{p} {}
+	constexpr ConstShapeRef(const ShapeRef& r) noexcept : ConstShapeRef{_from(r)} {}
 	constexpr ConstShapeRef(const ShapeContainer& c) noexcept;
 
 	ConstShapeRef() = delete;
@@ -63,73 +87,99 @@ public:
 	ConstShapeRef& operator=(ConstShapeRef&&) = default;
 
 	constexpr const ShapeType& type() const noexcept { return type_; }
-	constexpr const Shape& shape() const noexcept { return *shape_; }
-	constexpr const Rect& rect() const noexcept { assert(type_ == ShapeType::Rectangle); return static_cast<const Rect&>(*shape_); }
-	constexpr const Polygon& poly() const noexcept { assert(type_ == ShapeType::Polygon); return static_cast<const Polygon&>(*shape_); }
-	constexpr const Circle& circle() const noexcept { assert(type_ == ShapeType::Circle); return static_cast<const Circle&>(*shape_); }
+	// Get the address of the shape, to identify it.
+	constexpr const void* address() const noexcept {
+		switch (type_) {
+			case ShapeType::Rectangle: return rect_;
+			case ShapeType::Polygon: return poly_;
+			case ShapeType::Circle: return circle_;
+			case ShapeType::PooledPolygon: return pooled_.address();
+		}
+		return nullptr;
+	}
+	constexpr const Rect& rect() const noexcept { assert(type_ == ShapeType::Rectangle); return *rect_; }
+	constexpr const Polygon& poly() const noexcept { assert(type_ == ShapeType::Polygon); return *poly_; }
+	constexpr const Circle& circle() const noexcept { assert(type_ == ShapeType::Circle); return *circle_; }
+	constexpr PooledPolygon pooled() const noexcept { assert(type_ == ShapeType::PooledPolygon); return pooled_; }
 private:
+	static constexpr ConstShapeRef _from(const ShapeRef& r) noexcept {
+		switch (r.type()) {
+			case ShapeType::Polygon: return r.poly();
+			case ShapeType::Circle: return r.circle();
+			case ShapeType::PooledPolygon: return r.pooled();
+			default: return r.rect();
+		}
+	}
+
 	ShapeType type_;
-	const Shape* shape_{nullptr};
+	union {
+		const Rect* rect_;
+		const Polygon* poly_;
+		const Circle* circle_;
+		PooledPolygon pooled_;
+	};
 };
 
 // Hold a shape with type information.
 class ShapeContainer : ShapeRef {
+	friend class ShapeRef;
+	friend class ConstShapeRef;
 public:
 	using ShapeRef::type;
-	using ShapeRef::shape;
+	using ShapeRef::address;
 	using ShapeRef::rect;
 	using ShapeRef::poly;
 	using ShapeRef::circle;
+	using ShapeRef::pooled;
 
 	ShapeContainer() = delete;
 	ShapeContainer(Rect r) noexcept : ShapeRef{ShapeType::Rectangle}, shape_{std::move(r)} {
-		ShapeRef::setShape(std::get<Rect>(shape_));
+		setShape();
 	}
+	// Moving a polygon never allocates, so this doesn't throw. Copying one into the argument may.
 	ShapeContainer(Polygon p) noexcept : ShapeRef{ShapeType::Polygon}, shape_{std::move(p)} {
-		ShapeRef::setShape(std::get<Polygon>(shape_));
+		setShape();
 	}
 	ShapeContainer(Circle c) noexcept : ShapeRef{ShapeType::Circle}, shape_{std::move(c)} {
-		ShapeRef::setShape(std::get<Circle>(shape_));
+		setShape();
+	}
+	ShapeContainer(PooledPolygon p) noexcept : ShapeRef{ShapeType::PooledPolygon}, shape_{p} {
+		setShape();
 	}
 	// Construct shape in place by forwarding arguments.
 	template <typename Contained, typename... Args>
-	ShapeContainer(std::in_place_type_t<Contained> placeType, Args&&... args) noexcept : ShapeRef(ShapeType::Rectangle), shape_{placeType, std::forward<Args>(args)...} {
+	ShapeContainer(std::in_place_type_t<Contained> placeType, Args&&... args) noexcept(std::is_nothrow_constructible_v<Contained, Args...>) : ShapeRef(ShapeType::Rectangle), shape_{placeType, std::forward<Args>(args)...} {
 		if constexpr (std::is_same_v<Rect, Contained>) {
 			// Type was defaulted to Rect.
 		} else if constexpr (std::is_same_v<Polygon, Contained>) {
 			type_ = ShapeType::Polygon;
 		} else if constexpr (std::is_same_v<Circle, Contained>) {
 			type_ = ShapeType::Circle;
+		} else if constexpr (std::is_same_v<PooledPolygon, Contained>) {
+			type_ = ShapeType::PooledPolygon;
 		} else
 			static_assert(std::is_same_v<Contained, false>); // Unhandled shape type.
-		ShapeRef::setShape(std::get<Contained>(shape_));
+		setShape();
 	}
 
-	explicit ShapeContainer(ConstShapeRef shape) noexcept : ShapeRef{shape.type()} {
+	// Copies the shape. Copying a polygon too big to keep in place allocates.
+	explicit ShapeContainer(ConstShapeRef shape) : ShapeRef{shape.type()} {
 		switch (shape.type()) {
-			case ShapeType::Rectangle:
-				shape_ = shape.rect();
-				ShapeRef::setShape(std::get<Rect>(shape_));
-				break;
-			case ShapeType::Polygon:
-				shape_ = shape.poly();
-				ShapeRef::setShape(std::get<Polygon>(shape_));
-				break;
-			case ShapeType::Circle:
-				shape = shape.circle();
-				ShapeRef::setShape(std::get<Circle>(shape_));
-				break;
+			case ShapeType::Rectangle: shape_ = shape.rect(); break;
+			case ShapeType::Polygon: shape_ = shape.poly(); break;
+			case ShapeType::Circle: shape_ = shape.circle(); break;
+			case ShapeType::PooledPolygon: shape_ = shape.pooled(); break;
 		}
 		setShape();
 	}
 
-	ShapeContainer(const ShapeContainer& o) noexcept : ShapeRef{o.type_}, shape_{o.shape_} {
+	ShapeContainer(const ShapeContainer& o) : ShapeRef{o.type_}, shape_{o.shape_} {
 		setShape();
 	}
 	ShapeContainer(ShapeContainer&& o) noexcept : ShapeRef{o.type_}, shape_{std::move(o.shape_)} {
 		setShape();
 	}
-	ShapeContainer& operator=(const ShapeContainer& o) noexcept {
+	ShapeContainer& operator=(const ShapeContainer& o) {
 		type_ = o.type_;
 		shape_ = o.shape_;
 		setShape();
@@ -143,20 +193,30 @@ public:
 	}
 
 private:
-	constexpr void setShape() noexcept {
+	void setShape() noexcept {
 		switch (type_) {
 			case ShapeType::Rectangle: ShapeRef::setShape(std::get<Rect>(shape_)); break;
 			case ShapeType::Polygon: ShapeRef::setShape(std::get<Polygon>(shape_)); break;
 			case ShapeType::Circle: ShapeRef::setShape(std::get<Circle>(shape_)); break;
+			case ShapeType::PooledPolygon: ShapeRef::setShape(std::get<PooledPolygon>(shape_)); break;
 		}
 	}
 
-	std::variant<Rect, Polygon, Circle> shape_;
+	std::variant<Rect, Polygon, Circle, PooledPolygon> shape_;
 
 };
 
-constexpr ShapeRef::ShapeRef(ShapeContainer& s) noexcept : type_{s.type()}, shape_{&s.shape()} {}
-constexpr ConstShapeRef::ConstShapeRef(const ShapeContainer& s) noexcept : type_{s.type()}, shape_{&s.shape()} {}
+constexpr ShapeRef::ShapeRef(ShapeContainer& s) noexcept : ShapeRef{static_cast<ShapeRef&>(s)} {}
+constexpr ConstShapeRef::ConstShapeRef(const ShapeContainer& s) noexcept : ConstShapeRef{static_cast<const ShapeRef&>(s)} {}
+
+// Get the axis-aligned bounding box for a shape.
+Rect getAABB(ConstShapeRef shape);
+// Get a shape's projection along a given axis.
+Projection getProjection(ConstShapeRef shape, Coord2 axis);
+// Find the closest vertex/point on a shape to a given point.
+Coord2 getClosestTo(ConstShapeRef shape, Coord2 point);
+// Convert a shape into a polygon. Every shape can be at least approximated by a convex polygon.
+Polygon toPoly(ConstShapeRef shape);
 }
 
 #endif // INCLUDE_GEOM_SHAPE_CONTAINER_HPP
@@ -0,0 +1,83 @@
+#ifndef INCLUDE_GEOM_SIMD_HPP
+#define INCLUDE_GEOM_SIMD_HPP
+
+#include "units.hpp"
+
+#include <algorithm>
+#include <cstddef>
+
+#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+#define GEOM_SIMD_SSE
+#include <xmmintrin.h>
+#endif
+
+// A minimal wrapper over SIMD registers of gFloats, for kernels that process structure of arrays data a register at a time.
+// Uses SSE where the target has it, and otherwise plain arrays, which compilers can still vectorize.
+namespace ctp::simd {
+// Number of gFloats in a register. Arrays processed by the kernels are padded to a multiple of this.
+constexpr std::size_t LANES = 4;
+
+// Round a number of elements up to a whole number of registers.
+constexpr std::size_t paddedSize(std::size_t size) noexcept { return (size + LANES - 1) / LANES * LANES; }
+
+#ifdef GEOM_SIMD_SSE
+// The result of comparing lanes: all bits set in lanes where the comparison is true.
+struct Mask {
+	__m128 v;
+	Mask operator&(Mask o) const noexcept { return {_mm_and_ps(v, o.v)}; }
+	Mask operator|(Mask o) const noexcept { return {_mm_or_ps(v, o.v)}; }
+	// Get one bit per lane, lane 0 in the lowest bit.
+	int bits() const noexcept { return _mm_movemask_ps(v); }
+};
+
+struct Lanes {
+	__m128 v;
+	static Lanes load(const gFloat* values) noexcept { return {_mm_loadu_ps(values)}; }
+	static Lanes fill(gFloat value) noexcept { return {_mm_set1_ps(value)}; }
+	// Pick lanes from a where the mask is set, and from b elsewhere.
+	static Lanes select(Mask mask, Lanes a, Lanes b) noexcept { return {_mm_or_ps(_mm_and_ps(mask.v, a.v), _mm_andnot_ps(mask.v, b.v))}; }
+	void store(gFloat* values) const noexcept { _mm_storeu_ps(values, v); }
+	Lanes operator+(Lanes o) const noexcept { return {_mm_add_ps(v, o.v)}; }
+	Lanes operator-(Lanes o) const noexcept { return {_mm_sub_ps(v, o.v)}; }
+	Lanes operator*(Lanes o) const noexcept { return {_mm_mul_ps(v, o.v)}; }
+	Mask operator<(Lanes o) const noexcept { return {_mm_cmplt_ps(v, o.v)}; }
+	Mask operator<=(Lanes o) const noexcept { return {_mm_cmple_ps(v, o.v)}; }
+	Lanes min(Lanes o) const noexcept { return {_mm_min_ps(v, o.v)}; }
+	Lanes max(Lanes o) const noexcept { return {_mm_max_ps(v, o.v)}; }
+	// Reduce the lanes to their minimum or maximum by swapping neighbouring lanes, then neighbouring pairs.
+	gFloat minLane() const noexcept {
+		const __m128 pairs = _mm_min_ps(v, _mm_shuffle_ps(v, v, _MM_SHUFFLE(2, 3, 0, 1)));
+		return _mm_cvtss_f32(_mm_min_ps(pairs, _mm_shuffle_ps(pairs, pairs, _MM_SHUFFLE(1, 0, 3, 2))));
+	}
+	gFloat maxLane() const noexcept {
+		const __m128 pairs = _mm_max_ps(v, _mm_shuffle_ps(v, v, _MM_SHUFFLE(2, 3, 0, 1)));
+		return _mm_cvtss_f32(_mm_max_ps(pairs, _mm_shuffle_ps(pairs, pairs, _MM_SHUFFLE(1, 0, 3, 2))));
+	}
+};
+#else
+struct Mask {
+	bool v[LANES];
+	Mask operator&(Mask o) const noexcept { for (std::size_t i = 0; i < LANES; ++i) o.v[i] = v[i] && o.v[i]; return o; }
+	Mask operator|(Mask o) const noexcept { for (std::size_t i = 0; i < LANES; ++i) o.v[i] = v[i] || o.v[i]; return o; }
+	int bits() const noexcept { int b = 0; for (std::size_t i = 0; i < LANES; ++i) b |= v[i] ? 1 << i : 0; return b; }
+};
+
+struct Lanes {
+	gFloat v[LANES];
+	static Lanes load(const gFloat* values) noexcept { Lanes l; std::copy(values, values + LANES, l.v); return l; }
+	static Lanes fill(gFloat value) noexcept { Lanes l; std::fill(l.v, l.v + LANES, value); return l; }
+	static Lanes select(Mask mask, Lanes a, Lanes b) noexcept { for (std::size_t i = 0; i < LANES; ++i) a.v[i] = mask.v[i] ? a.v[i] : b.v[i]; return a; }
+	void store(gFloat* values) const noexcept { std::copy(v, v + LANES, values); }
+	Lanes operator+(Lanes o) const noexcept { for (std::size_t i = 0; i < LANES; ++i) o.v[i] = v[i] + o.v[i]; return o; }
+	Lanes operator-(Lanes o) const noexcept { for (std::size_t i = 0; i < LANES; ++i) o.v[i] = v[i] - o.v[i]; return o; }
+	Lanes operator*(Lanes o) const noexcept { for (std::size_t i = 0; i < LANES; ++i) o.v[i] = v[i] * o.v[i]; return o; }
+	Mask operator<(Lanes o) const noexcept { Mask m; for (std::size_t i = 0; i < LANES; ++i) m.v[i] = v[i] < o.v[i]; return m; }
+	Mask operator<=(Lanes o) const noexcept { Mask m; for (std::size_t i = 0; i < LANES; ++i) m.v[i] = v[i] <= o.v[i]; return m; }
+	Lanes min(Lanes o) const noexcept { for (std::size_t i = 0; i < LANES; ++i) o.v[i] = std::min(v[i], o.v[i]); return o; }
+	Lanes max(Lanes o) const noexcept { for (std::size_t i = 0; i < LANES; ++i) o.v[i] = std::max(v[i], o.v[i]); return o; }
+	gFloat minLane() const noexcept { return *std::min_element(v, v + LANES); }
+	gFloat maxLane() const noexcept { return *std::max_element(v, v + LANES); }
+};
+#endif
+}
+#endif // INCLUDE_GEOM_SIMD_HPP
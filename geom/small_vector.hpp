@@ -0,0 +1,81 @@
+#ifndef INCLUDE_GEOM_SMALL_VECTOR_HPP
+#define INCLUDE_GEOM_SMALL_VECTOR_HPP
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <type_traits>
+#include <vector>
+
+// A vector of small, trivially copyable values that holds up to N of them in place, only using the heap beyond that.
+// The values are always contiguous: they move to the heap all at once when they outgrow the inline storage.
+namespace ctp {
+template <typename T, std::size_t N>
+class SmallVector {
+	static_assert(std::is_trivially_copyable_v<T>, "SmallVector only holds trivially copyable values.");
+public:
+	static constexpr std::size_t INLINE_CAPACITY = N;
+
+	SmallVector() = default;
+	explicit SmallVector(std::size_t size, T value = T()) { resize(size, value); }
+
+	void push_back(T value) {
+		if (size_ < N) {
+			inline_[size_++] = value;
+			return;
+		}
+		if (size_ == N)
+			heap_.assign(inline_.begin(), inline_.end());
+		heap_.push_back(value);
+		++size_;
+	}
+	void pop_back() noexcept {
+		--size_;
+		if (size_ == N)
+			std::copy(heap_.begin(), heap_.begin() + N, inline_.begin());
+		if (size_ >= N)
+			heap_.pop_back();
+	}
+	void resize(std::size_t size, T value = T()) {
+		if (size <= N) {
+			if (_is_on_heap())
+				std::copy(heap_.begin(), heap_.begin() + size, inline_.begin());
+			else if (size > size_)
+				std::fill(inline_.begin() + size_, inline_.begin() + size, value);
+			heap_.clear();
+		} else {
+			if (!_is_on_heap())
+				heap_.assign(inline_.begin(), inline_.begin() + size_);
+			heap_.resize(size, value);
+		}
+		size_ = size;
+	}
+	// Make room for a number of values. Only allocates if they won't fit inline.
+	void reserve(std::size_t size) {
+		if (size > N)
+			heap_.reserve(size);
+	}
+	void clear() noexcept { size_ = 0; heap_.clear(); }
+
+	std::size_t size() const noexcept { return size_; }
+	bool empty() const noexcept { return size_ == 0; }
+	T* data() noexcept { return _is_on_heap() ? heap_.data() : inline_.data(); }
+	const T* data() const noexcept { return _is_on_heap() ? heap_.data() : inline_.data(); }
+	T& operator[](std::size_t index) noexcept { return data()[index]; }
+	const T& operator[](std::size_t index) const noexcept { return data()[index]; }
+	T& back() noexcept { return data()[size_ - 1]; }
+	const T& back() const noexcept { return data()[size_ - 1]; }
+	T* begin() noexcept { return data(); }
+	const T* begin() const noexcept { return data(); }
+	T* end() noexcept { return data() + size_; }
+	const T* end() const noexcept { return data() + size_; }
+
+private:
+	bool _is_on_heap() const noexcept { return size_ > N; }
+
+	std::array<T, N> inline_;
+	std::vector<T> heap_;
+	std::size_t size_{0};
+};
+}
+#endif // INCLUDE_GEOM_SMALL_VECTOR_HPP
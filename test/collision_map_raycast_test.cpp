@@ -0,0 +1,111 @@
+#include "catch.hpp"
+#include "definitions.hpp"
+
+#include <cmath>
+#include <memory>
+
+using namespace ctp;
+
+SCENARIO("Raycasting against collision maps.", "[CollisionMap][raycast]") {
+	std::vector<std::unique_ptr<Wall>> walls;
+	walls.push_back(std::make_unique<Wall>(Rect(0, 0, 2, 2), Coord2(10, -1)));        // Ahead along +x.
+	walls.push_back(std::make_unique<Wall>(Circle(1), Coord2(20, 0)));                // Behind the first.
+	walls.push_back(std::make_unique<Wall>(Polygon(shapes::octagon), Coord2(0, 30))); // Ahead along +y.
+	for (int i = 0; i < 30; ++i) // Clutter off of the tested rays.
+		walls.push_back(std::make_unique<Wall>(Rect(0, 0, 1, 1), Coord2(static_cast<gFloat>(i * 3 - 40), -20)));
+	std::vector<Collidable*> collidables;
+	for (const auto& wall : walls)
+		collidables.push_back(wall.get());
+	const Collidable* first(walls[0].get());
+	const Collidable* second(walls[1].get());
+	const Collidable* octagon(walls[2].get());
+
+	const ListCollisionMap list(collidables);
+	const StaticBVHCollisionMap bvh(collidables);
+	DynamicTreeCollisionMap tree;
+	GridCollisionMap grid(Rect(-50, -50, 100, 100), 5);
+	for (Collidable* c : collidables) {
+		tree.insert(c);
+		grid.insert(c);
+	}
+	const std::vector<const CollisionMap*> maps{&list, &bvh, &tree, &grid};
+
+	GIVEN("A ray that passes through several collidables.") {
+		const Ray ray{Coord2(0, 0), Coord2(1, 0)};
+		THEN("Each map finds the closest one.") {
+			for (const CollisionMap* map : maps) {
+				const RaycastHit hit(map->raycast(ray, 100));
+				REQUIRE(hit);
+				CHECK(hit.collidable == first);
+				CHECK(hit.t == ApproxEps(10));
+				CHECK(hit.normal.x == ApproxEps(-1));
+				CHECK(hit.normal.y == ApproxEps(0));
+			}
+		}
+		WHEN("It starts past the first collidable.") {
+			const Ray past{Coord2(15, 0), Coord2(1, 0)};
+			THEN("The next one is found.") {
+				for (const CollisionMap* map : maps) {
+					const RaycastHit hit(map->raycast(past, 100));
+					REQUIRE(hit);
+					CHECK(hit.collidable == second);
+					CHECK(hit.t == ApproxEps(4));
+				}
+			}
+		}
+		WHEN("Its maximum distance is before the first collidable.") {
+			THEN("Nothing is found.") {
+				for (const CollisionMap* map : maps)
+					CHECK_FALSE(map->raycast(ray, 9.5f));
+			}
+		}
+	}
+	GIVEN("A ray that hits a polygon.") {
+		const Ray ray{Coord2(0.5f, 0), Coord2(0, 1)};
+		THEN("Each map finds it.") {
+			for (const CollisionMap* map : maps) {
+				const RaycastHit hit(map->raycast(ray, 100));
+				REQUIRE(hit);
+				CHECK(hit.collidable == octagon);
+				CHECK(hit.t == ApproxEps(30 - 2 + 0.5f / 3)); // Edge from (0, -2) to (1.5, -1.5).
+				CHECK(hit.normal.y < 0);
+			}
+		}
+	}
+	GIVEN("A ray that starts inside a collidable.") {
+		const Ray ray{Coord2(11, 0), Coord2(0, -1)};
+		THEN("It hits at its origin.") {
+			for (const CollisionMap* map : maps) {
+				const RaycastHit hit(map->raycast(ray, 100));
+				REQUIRE(hit);
+				CHECK(hit.collidable == first);
+				CHECK(hit.t == 0);
+				CHECK(hit.normal.isZero());
+			}
+		}
+	}
+	GIVEN("A ray that misses everything.") {
+		const Ray ray{Coord2(0, 0), Coord2(-1, 0)};
+		THEN("Nothing is found.") {
+			for (const CollisionMap* map : maps) {
+				const RaycastHit hit(map->raycast(ray, 100));
+				CHECK_FALSE(hit);
+				CHECK(hit.collidable == nullptr);
+			}
+		}
+	}
+	GIVEN("Rays in many directions.") {
+		THEN("The accelerated maps agree with testing every collidable.") {
+			for (int i = 0; i < 64; ++i) {
+				const gFloat angle(static_cast<gFloat>(i) * 0.1f);
+				const Ray ray{Coord2(-5, 5), Coord2(std::cos(angle), std::sin(angle))};
+				const RaycastHit expected(list.raycast(ray, 80));
+				for (const CollisionMap* map : maps) {
+					const RaycastHit hit(map->raycast(ray, 80));
+					CHECK(hit.collidable == expected.collidable);
+					CHECK(hit.t == ApproxEps(expected.t));
+				}
+			}
+		}
+	}
+}
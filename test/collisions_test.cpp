@@ -1,6 +1,11 @@
 #include "catch.hpp"
 #include "definitions.hpp"
 
+#include <cmath>
+#include <string>
+#include <utility>
+#include <vector>
+
 using namespace ctp;
 
 SCENARIO("One shape is moving to collide with a stationary one.", "[collides][sweep]") {
@@ -991,3 +996,180 @@ SCENARIO("Hybrid SAT with both shapes moving.", "[collides]") {
 		}
 	}
 }
+
+SCENARIO("Circles sweeping into rectangles agree with sweeping into the rectangles' polygons.", "[collides][sweep]") {
+	const Rect rect(-1, -0.5f, 2, 1);
+	const Polygon rectPoly(rect.toPoly());
+	const Circle circle(0.75f);
+	GIVEN("A circle moving from many positions around the rectangle in many directions.") {
+		THEN("It collides the same way with the rectangle as with its polygon.") {
+			int sweeps(0);
+			for (int x = -12; x <= 12; ++x) {
+				for (int y = -9; y <= 9; ++y) {
+					const Coord2 pos(static_cast<gFloat>(x) * 0.253f, static_cast<gFloat>(y) * 0.211f);
+					for (int i = 0; i < 24; ++i) {
+						const gFloat angle(constants::TAU * static_cast<gFloat>(i) / 24.0f + 0.05f);
+						const Coord2 delta(Coord2(std::cos(angle), std::sin(angle)) * 2.5f);
+						INFO("Circle at " << pos.x << ", " << pos.y << " moving " << delta.x << ", " << delta.y);
+						Coord2 norm, polyNorm;
+						gFloat t(0), polyT(0);
+						const CollisionResult expected(collides(circle, pos, delta, rectPoly, Coord2(0, 0), polyNorm, polyT));
+						REQUIRE(collides(circle, pos, delta, rect, Coord2(0, 0), norm, t) == expected);
+						if (expected == CollisionResult::Sweep) {
+							++sweeps;
+							CHECK(t == Approx(polyT).margin(0.0001));
+							CHECK(norm.x == Approx(polyNorm.x).margin(0.0001));
+							CHECK(norm.y == Approx(polyNorm.y).margin(0.0001));
+						}
+					}
+				}
+			}
+			CHECK(sweeps > 1000);
+		}
+	}
+	GIVEN("A circle moving straight at the rectangle's side and corner.") {
+		Coord2 norm;
+		gFloat t;
+		THEN("It hits the side with the side's normal.") {
+			REQUIRE(collides(circle, Coord2(-4, 0), Coord2(4, 0), rect, Coord2(0, 0), norm, t) == CollisionResult::Sweep);
+			CHECK(t == ApproxEps((4 - 1 - 0.75f + constants::EPSILON) / 4));
+			CHECK(norm == Coord2(-1, 0));
+		}
+		THEN("It hits the corner with the normal from the corner.") {
+			REQUIRE(collides(circle, Coord2(-3, -2.5f), Coord2(4, 4), rect, Coord2(0, 0), norm, t) == CollisionResult::Sweep);
+			CHECK(norm.x == Approx(norm.y).margin(0.001)); // Diagonal, as it lines up with the corner.
+			CHECK(norm.x < 0);
+		}
+		THEN("It misses when moving parallel to the side.") {
+			CHECK(collides(circle, Coord2(-4, 1.3f), Coord2(8, 0), rect, Coord2(0, 0), norm, t) == CollisionResult::None);
+		}
+	}
+}
+
+SCENARIO("Benchmarking circle sweeps into rectangles.", "[.][benchmark][collides]") {
+	const Rect rect(0, 0, 1, 1);
+	const Polygon rectPoly(rect.toPoly());
+	const Circle circle(0.4f);
+	std::vector<Coord2> positions;
+	for (int i = 0; i < 10000; ++i)
+		positions.emplace_back(std::cos(static_cast<gFloat>(i)) * 3, std::sin(static_cast<gFloat>(i) * 1.3f) * 3);
+	int count(0);
+	Coord2 norm;
+	gFloat t;
+	BENCHMARK("10000 circle sweeps into a rectangle's polygon") {
+		for (const Coord2 pos : positions)
+			count += collides(circle, pos, Coord2(0.5f, 0.5f) - pos, rectPoly, Coord2(0, 0), norm, t) == CollisionResult::Sweep ? 1 : 0;
+	}
+	BENCHMARK("10000 circle sweeps into a rectangle") {
+		for (const Coord2 pos : positions)
+			count += collides(circle, pos, Coord2(0.5f, 0.5f) - pos, rect, Coord2(0, 0), norm, t) == CollisionResult::Sweep ? 1 : 0;
+	}
+	CHECK(count > 0);
+}
+
+SCENARIO("Rectangle pairs agree with the general separating axis tests.", "[collides][overlaps]") {
+	// Cached tests still go through the general separating axes. With an empty cache, they give its results for each pair.
+	const auto uncached = [] { return SeparatingAxisCache(); };
+	const std::vector<Rect> rects{Rect(0, 0, 1, 1), Rect(-0.5f, 0.25f, 2, 0.5f), Rect(0.3f, -1.1f, 0.7f, 3)};
+	const std::vector<Coord2> deltas{Coord2(0, 0), Coord2(3, 0.5f), Coord2(-0.7f, -2.5f), Coord2(0, 4), Coord2(-1.5f, 0)};
+	GIVEN("Pairs of rectangles at positions around each other.") {
+		THEN("Overlap tests, minimum translation vectors, and sweeps are identical.") {
+			for (const Rect& first : rects) {
+				for (const Rect& second : rects) {
+					for (int x = -8; x <= 8; ++x) {
+						for (int y = -8; y <= 8; ++y) {
+							const Coord2 firstPos(static_cast<gFloat>(x) * 0.25f, static_cast<gFloat>(y) * 0.25f);
+							const Coord2 secondPos(0.125f, -0.125f);
+							INFO("First rectangle at " << firstPos.x << ", " << firstPos.y);
+							SeparatingAxisCache cache(uncached());
+							const bool isOverlapping(overlaps(first, firstPos, second, secondPos, cache));
+							REQUIRE(overlaps(ConstShapeRef(first), firstPos, ConstShapeRef(second), secondPos) == isOverlapping);
+							REQUIRE(overlaps(ConstShapeRef(Rect(first.x + firstPos.x, first.y + firstPos.y, first.w, first.h)),
+								ConstShapeRef(Rect(second.x + secondPos.x, second.y + secondPos.y, second.w, second.h))) == isOverlapping);
+
+							Coord2 norm, expectedNorm;
+							gFloat dist(0), expectedDist(0);
+							cache = uncached();
+							REQUIRE(overlaps(first, firstPos, second, secondPos, expectedNorm, expectedDist, cache) == isOverlapping);
+							REQUIRE(overlaps(ConstShapeRef(first), firstPos, ConstShapeRef(second), secondPos, norm, dist) == isOverlapping);
+							if (isOverlapping) {
+								CHECK(norm == expectedNorm);
+								CHECK(dist == expectedDist);
+							}
+
+							for (const Coord2 delta : deltas) {
+								INFO("Moving " << delta.x << ", " << delta.y);
+								gFloat t(0), expectedT(0);
+								cache = uncached();
+								const CollisionResult expected(collides(first, firstPos, delta, second, secondPos, expectedNorm, expectedT, cache));
+								REQUIRE(collides(ConstShapeRef(first), firstPos, delta, ConstShapeRef(second), secondPos, norm, t) == expected);
+								if (expected != CollisionResult::None) {
+									CHECK(norm == expectedNorm);
+									CHECK(t == expectedT);
+								}
+							}
+						}
+					}
+				}
+			}
+		}
+	}
+}
+
+SCENARIO("Benchmarking rectangle pairs.", "[.][benchmark][collides][overlaps]") {
+	// A tile map: every tile is tested against a moving rectangle near it.
+	std::vector<Rect> tiles;
+	for (int i = 0; i < 1000; ++i)
+		tiles.emplace_back(static_cast<gFloat>(i % 40), static_cast<gFloat>(i / 40), 1.0f, 1.0f);
+	const Rect player(0, 0, 0.8f, 1.6f);
+	int count(0);
+	BENCHMARK("1000 rectangle overlap tests") {
+		for (const Rect& tile : tiles)
+			count += overlaps(ConstShapeRef(player), Coord2(tile.x + 0.5f, tile.y - 0.7f), ConstShapeRef(tile), Coord2(0, 0)) ? 1 : 0;
+	}
+	BENCHMARK("1000 rectangle minimum translation vectors") {
+		Coord2 norm;
+		gFloat dist;
+		for (const Rect& tile : tiles)
+			count += overlaps(ConstShapeRef(player), Coord2(tile.x + 0.5f, tile.y - 0.7f), ConstShapeRef(tile), Coord2(0, 0), norm, dist) ? 1 : 0;
+	}
+	BENCHMARK("1000 rectangle sweeps") {
+		Coord2 norm;
+		gFloat t;
+		for (const Rect& tile : tiles)
+			count += collides(ConstShapeRef(player), Coord2(tile.x - 1.5f, tile.y - 0.3f), Coord2(2, 0.5f), ConstShapeRef(tile), Coord2(0, 0), norm, t) != CollisionResult::None ? 1 : 0;
+	}
+	CHECK(count > 0);
+}
+
+SCENARIO("Benchmarking each pair of shape types.", "[.][benchmark][collides][overlaps]") {
+	// Each shape is tested against a copy of each shape type, at positions ranging from separated to overlapping.
+	const Rect rect(-1, -1, 2, 2);
+	const Polygon poly(shapes::octagon);
+	const Circle circle(1);
+	const std::vector<std::pair<std::string, ConstShapeRef>> types = {{"rectangle", rect}, {"polygon", poly}, {"circle", circle}};
+	std::vector<Coord2> positions;
+	for (int i = 0; i < 1000; ++i)
+		positions.emplace_back(static_cast<gFloat>(i % 40) * 0.1f - 2.0f, static_cast<gFloat>(i / 40) * 0.16f - 2.0f);
+	int count(0);
+	Coord2 norm;
+	gFloat dist;
+	for (const auto& first : types) {
+		for (const auto& second : types) {
+			const std::string pair(first.first + " and " + second.first);
+			BENCHMARK("1000 overlap tests, " + pair) {
+				for (const Coord2& pos : positions)
+					count += overlaps(first.second, pos, second.second, Coord2(0, 0)) ? 1 : 0;
+			}
+			BENCHMARK("1000 minimum translation vectors, " + pair) {
+				for (const Coord2& pos : positions)
+					count += overlaps(first.second, pos, second.second, Coord2(0, 0), norm, dist) ? 1 : 0;
+			}
+			BENCHMARK("1000 sweeps, " + pair) {
+				for (const Coord2& pos : positions)
+					count += collides(first.second, pos * 2.0f, -pos, second.second, Coord2(0, 0), norm, dist) != CollisionResult::None ? 1 : 0;
+			}
+		}
+	}
+	CHECK(count > 0);
+}
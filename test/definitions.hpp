@@ -4,6 +4,11 @@
 
 #include "catch.hpp"
 
+#include <algorithm>
+#include <cmath>
+#include <future>
+#include <memory>
+#include <utility>
 #include <vector>
 
 #include "../Geometry.hpp"
@@ -27,4 +32,141 @@ namespace separating_axes {
 constexpr std::size_t RECT_NUM_AXES = 2; // Rectangles are axis-alligned.
 }
 
+// A movable that keeps its own position, for moving through collision maps.
+struct MovableTest : public ctp::Movable {
+	ctp::ShapeContainer collider;
+	ctp::Coord2 position;
+
+	MovableTest(ctp::Movable::CollisionType type, ctp::ShapeContainer collider) : Movable{type}, collider{std::move(collider)} {}
+	MovableTest(ctp::Movable::CollisionType type, ctp::ShapeContainer collider, ctp::Coord2 position) : Movable{type}, collider{std::move(collider)}, position{position} {}
+	~MovableTest() override {}
+	ctp::Coord2 getPosition() const override { return position; }
+	ctp::ConstShapeRef getCollider() const override { return collider; }
+	void move(ctp::Coord2 delta, const ctp::CollisionMap& map) {
+		position = Movable::move(collider, position, delta, map);
+	}
+};
+
+// Returns every collidable: what the accelerated collision maps are measured against.
+class ListCollisionMap : public ctp::CollisionMap {
+public:
+	ListCollisionMap(std::vector<ctp::Collidable*> collidables) : collidables_(std::move(collidables)) {}
+	const std::vector<ctp::Collidable*> getColliding(const ctp::Collidable&, ctp::Coord2) const override {
+		return collidables_;
+	}
+private:
+	std::vector<ctp::Collidable*> collidables_;
+};
+
+inline bool contains(const std::vector<ctp::Collidable*>& collidables, const ctp::Collidable* c) {
+	return std::find(collidables.begin(), collidables.end(), c) != collidables.end();
+}
+
+// What every broadphase collision map has to find. Catch 2.4 has no TEMPLATE_TEST_CASE, so each map's tests
+// call this with a function that builds that map from a list of collidables and returns it.
+template<typename BuildMap>
+void checkCollisionMapBasics(BuildMap buildMap) {
+	using namespace ctp;
+	Wall left(Rect(0, 0, 5, 5), Coord2(10, 10));
+	Wall right(Rect(0, 0, 5, 5), Coord2(80, 10));
+	Wall far(Circle(2), Coord2(50, 90));
+	const std::unique_ptr<CollisionMap> map(buildMap(std::vector<Collidable*>{&left, &right, &far}));
+	MovableTest mover(Movable::CollisionType::Deflect, ShapeContainer(Circle(1)), Coord2(12, 12));
+	GIVEN("A collider that is stationary.") {
+		WHEN("It is only near one collidable.") {
+			const auto colliding = map->getColliding(mover);
+			THEN("Only that collidable is found.") {
+				CHECK(colliding.size() == 1);
+				CHECK(contains(colliding, &left));
+			}
+		}
+		WHEN("It is far from all collidables.") {
+			mover.position = Coord2(50, 50);
+			THEN("Nothing is found.")
+				CHECK(map->getColliding(mover).empty());
+		}
+	}
+	GIVEN("A collider that is moving.") {
+		WHEN("It sweeps across two collidables.") {
+			const auto colliding = map->getColliding(mover, Coord2(70, 0));
+			THEN("Both are found.") {
+				CHECK(colliding.size() == 2);
+				CHECK(contains(colliding, &left));
+				CHECK(contains(colliding, &right));
+			}
+		}
+		WHEN("It queries from a different position than its own.") {
+			const auto colliding = map->getColliding(mover, Coord2(50, 87), Coord2(0, 0));
+			THEN("The given position is used.") {
+				CHECK(colliding.size() == 1);
+				CHECK(contains(colliding, &far));
+			}
+		}
+	}
+	GIVEN("Several threads querying a map at once.") {
+		std::vector<std::unique_ptr<Wall>> walls;
+		std::vector<Collidable*> collidables;
+		for (int i = 0; i < 100; ++i) { // Boxes of varied sizes, many spanning several cells of the grid maps.
+			walls.push_back(std::make_unique<Wall>(Rect(0, 0, static_cast<gFloat>(1 + i % 7), static_cast<gFloat>(1 + i % 5)),
+				Coord2(static_cast<gFloat>((i * 37) % 90), static_cast<gFloat>((i * 53) % 90))));
+			collidables.push_back(walls.back().get());
+		}
+		const std::unique_ptr<CollisionMap> sharedMap(buildMap(collidables));
+		const Wall query(Rect(0, 0, 3, 3), Coord2(0, 0));
+		struct Results {
+			std::vector<std::vector<Collidable*>> colliding;
+			std::vector<Collidable*> hits;
+			bool operator==(const Results& other) const { return colliding == other.colliding && hits == other.hits; }
+		};
+		const auto findAll = [&sharedMap, &query] {
+			Results results;
+			std::vector<Collidable*> colliding;
+			for (int i = 0; i < 400; ++i) {
+				const Coord2 pos(static_cast<gFloat>(i % 20) * 4.5f, static_cast<gFloat>(i / 20) * 4.5f);
+				sharedMap->getColliding(query, pos, Coord2(static_cast<gFloat>(i % 3), 0), colliding);
+				std::sort(colliding.begin(), colliding.end());
+				results.colliding.push_back(colliding);
+				const gFloat angle(static_cast<gFloat>(i) * 0.731f);
+				results.hits.push_back(sharedMap->raycast(Ray{pos, Coord2(std::cos(angle), std::sin(angle))}, 50).collidable);
+			}
+			return results;
+		};
+		const Results expected(findAll());
+		std::vector<std::future<Results>> results;
+		for (int i = 0; i < 4; ++i)
+			results.push_back(std::async(std::launch::async, findAll));
+		THEN("Each thread finds the same collidables, once each.") {
+			for (auto& result : results)
+				CHECK(result.get() == expected);
+			for (const auto& colliding : expected.colliding)
+				CHECK(std::adjacent_find(colliding.begin(), colliding.end()) == colliding.end());
+		}
+	}
+	GIVEN("A floor of unit squares.") {
+		std::vector<std::unique_ptr<Wall>> walls;
+		std::vector<Collidable*> floor;
+		for (int i = -10; i < 10; ++i) {
+			walls.push_back(std::make_unique<Wall>(Rect(0, 0, 1, 1), Coord2(static_cast<gFloat>(i), 0)));
+			floor.push_back(walls.back().get());
+		}
+		const std::unique_ptr<CollisionMap> floorMap(buildMap(floor));
+		WHEN("A movable that deflects moves diagonally into the floor.") {
+			MovableTest deflects(Movable::CollisionType::Deflect, ShapeContainer(Rect(0, 0, 1, 1)), Coord2(-5.5f, -5));
+			deflects.move(Coord2(8, 8), *floorMap);
+			THEN("It slides along the floor.") {
+				CHECK(deflects.position.x == ApproxCollides(2.5f));
+				CHECK(deflects.position.y == ApproxCollides(-1));
+			}
+		}
+		WHEN("A movable that reflects moves diagonally into the floor.") {
+			MovableTest reflects(Movable::CollisionType::Reflect, ShapeContainer(Rect(0, 0, 1, 1)), Coord2(-5.5f, -5));
+			reflects.move(Coord2(6, 6), *floorMap);
+			THEN("It bounces off of the floor from its new position.") {
+				CHECK(reflects.position.x == ApproxCollides(0.5f));
+				CHECK(reflects.position.y == Approx(-3).margin(Movable::COLLISION_BUFFER * 3));
+			}
+		}
+	}
+}
+
 #endif // INCLUDE_TEST_DEFINITIONS_HPP
@@ -0,0 +1,114 @@
+#include "catch.hpp"
+#include "definitions.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <memory>
+
+using namespace ctp;
+
+SCENARIO("Finding collidables in a dynamic tree collision map.", "[DynamicTreeCollisionMap]") {
+	DynamicTreeCollisionMap map;
+	Wall left(Rect(0, 0, 5, 5), Coord2(10, 10));
+	Wall right(Rect(0, 0, 5, 5), Coord2(80, 10));
+	Wall far(Circle(2), Coord2(50, 90));
+	map.insert(&left);
+	map.insert(&right);
+	map.insert(&far);
+	MovableTest mover(Movable::CollisionType::Deflect, ShapeContainer(Circle(1)), Coord2(12, 12));
+	GIVEN("A collider that is in the map.") {
+		map.insert(&mover);
+		WHEN("It queries the map.") {
+			const auto colliding = map.getColliding(mover);
+			THEN("It doesn't find itself.") {
+				CHECK(colliding.size() == 1);
+				CHECK(contains(colliding, &left));
+			}
+		}
+	}
+}
+
+SCENARIO("Changing the contents of a dynamic tree collision map.", "[DynamicTreeCollisionMap]") {
+	DynamicTreeCollisionMap map(1);
+	Wall first(Rect(0, 0, 5, 5), Coord2(10, 10));
+	Wall second(Rect(0, 0, 5, 5), Coord2(12, 12));
+	map.insert(&first);
+	map.insert(&second);
+	MovableTest mover(Movable::CollisionType::Deflect, ShapeContainer(Circle(1)), Coord2(12, 12));
+	GIVEN("A collidable that is removed.") {
+		map.remove(&first);
+		THEN("It is no longer found.") {
+			CHECK(map.size() == 1);
+			CHECK_FALSE(map.contains(&first));
+			const auto colliding = map.getColliding(mover);
+			CHECK(colliding.size() == 1);
+			CHECK(contains(colliding, &second));
+		}
+	}
+	GIVEN("A collidable that moves.") {
+		MovableTest moving(Movable::CollisionType::Deflect, ShapeContainer(Rect(0, 0, 5, 5)), Coord2(10, 10));
+		map.insert(&moving);
+		WHEN("It moves less than the margin.") {
+			moving.position = Coord2(10.5f, 9.5f);
+			THEN("It isn't reinserted.")
+				CHECK_FALSE(map.update(&moving));
+		}
+		WHEN("It moves out of its fat box.") {
+			moving.position = Coord2(70, 70);
+			THEN("It is reinserted, and found in its new position.") {
+				CHECK(map.update(&moving));
+				CHECK_FALSE(contains(map.getColliding(mover), &moving));
+				mover.position = Coord2(72, 72);
+				CHECK(contains(map.getColliding(mover), &moving));
+			}
+		}
+	}
+	GIVEN("A map that is cleared.") {
+		map.clear();
+		THEN("Nothing is found.") {
+			CHECK(map.size() == 0);
+			CHECK(map.height() == 0);
+			CHECK(map.getColliding(mover).empty());
+		}
+	}
+}
+
+SCENARIO("A dynamic tree collision map stays balanced.", "[DynamicTreeCollisionMap]") {
+	DynamicTreeCollisionMap map;
+	std::vector<std::unique_ptr<Wall>> walls;
+	constexpr int numWalls = 1024;
+	for (int i = 0; i < numWalls; ++i) { // Insert in sorted order, the worst case for an unbalanced tree.
+		walls.push_back(std::make_unique<Wall>(Rect(0, 0, 1, 1), Coord2(static_cast<gFloat>(i * 2), 0)));
+		map.insert(walls.back().get());
+	}
+	THEN("The height is logarithmic.")
+		CHECK(map.height() <= 2 * static_cast<int>(std::log2(numWalls)) + 1);
+	WHEN("Half of the collidables are removed.") {
+		for (int i = 0; i < numWalls; i += 2)
+			map.remove(walls[i].get());
+		THEN("It finds the same results as testing every collidable.") {
+			MovableTest mover(Movable::CollisionType::Deflect, ShapeContainer(Rect(0, 0, 1, 1)), Coord2(100, -2));
+			const Coord2 delta(50, 3);
+			const Rect swept(100, -2, 51, 4);
+			const auto colliding = map.getColliding(mover, delta);
+			std::size_t expected = 0;
+			for (int i = 1; i < numWalls; i += 2) {
+				const Rect aabb(getAABB(walls[i]->getCollider()) + walls[i]->getPosition());
+				if (aabb.right() + map.margin() >= swept.left() && aabb.left() - map.margin() <= swept.right()) {
+					++expected;
+					CHECK(contains(colliding, walls[i].get()));
+				}
+			}
+			CHECK(colliding.size() == expected);
+		}
+	}
+}
+
+SCENARIO("A dynamic tree collision map behaves like every collision map.", "[DynamicTreeCollisionMap][movable]") {
+	checkCollisionMapBasics([](const std::vector<Collidable*>& collidables) {
+		auto map = std::make_unique<DynamicTreeCollisionMap>();
+		for (Collidable* c : collidables)
+			map->insert(c);
+		return map;
+	});
+}
@@ -0,0 +1,307 @@
+#include "catch.hpp"
+#include "definitions.hpp"
+
+#include <cmath>
+#include <utility>
+#include <vector>
+
+using namespace ctp;
+
+namespace {
+// A regular polygon centered on the origin, wound like the other polygons.
+Polygon makeRegular(std::size_t vertices, gFloat radius) {
+	std::vector<Coord2> points;
+	for (std::size_t i = 0; i < vertices; ++i) {
+		const gFloat angle(-constants::TAU * static_cast<gFloat>(i) / static_cast<gFloat>(vertices));
+		points.emplace_back(radius * std::cos(angle), radius * std::sin(angle));
+	}
+	return Polygon(points);
+}
+
+bool hasCircle(ConstShapeRef first, ConstShapeRef second) {
+	return first.type() == ShapeType::Circle || second.type() == ShapeType::Circle;
+}
+}
+
+SCENARIO("Finding support points of shapes.", "[gjk]") {
+	GIVEN("A rectangle.") {
+		const Rect rect(1, 2, 3, 4);
+		THEN("Its support points are its corners.") {
+			CHECK(gjk::support(rect, Coord2(1, 1)) == Coord2(4, 6));
+			CHECK(gjk::support(rect, Coord2(-1, 0.5f)) == Coord2(1, 6));
+			CHECK(gjk::support(rect, Coord2(-2, -3)) == Coord2(1, 2));
+		}
+	}
+	GIVEN("A polygon.") {
+		const Polygon octagon(shapes::octagon);
+		THEN("Its support points are its farthest vertices.") {
+			CHECK(gjk::support(octagon, Coord2(0, 1)) == Coord2(0, 2));
+			CHECK(gjk::support(octagon, Coord2(-1, -1)) == Coord2(-1.5f, -1.5f));
+		}
+	}
+	GIVEN("A circle.") {
+		const Circle circle(1, 1, 2);
+		THEN("Its support points are on its edge.") {
+			const Coord2 point(gjk::support(circle, Coord2(3, 4)));
+			CHECK(point.x == ApproxEps(1 + 2 * 0.6f));
+			CHECK(point.y == ApproxEps(1 + 2 * 0.8f));
+		}
+	}
+}
+
+SCENARIO("Finding the distance between shapes with GJK.", "[gjk]") {
+	const Polygon big(makeRegular(32, 2));
+	GIVEN("Separated shapes.") {
+		THEN("The distance between them is found.") {
+			CHECK(gjk::distance(Rect(0, 0, 1, 1), Coord2(0, 0), Rect(0, 0, 1, 1), Coord2(3, 0)) == ApproxEps(2));
+			CHECK(gjk::distance(Circle(1), Coord2(0, 0), Circle(2), Coord2(0, 5)) == ApproxEps(2));
+			CHECK(gjk::distance(big, Coord2(0, 0), Rect(0, 0, 1, 1), Coord2(5, -0.5f)) == ApproxEps(3));
+		}
+	}
+	GIVEN("Overlapping or touching shapes.") {
+		THEN("The distance is 0.") {
+			CHECK(gjk::distance(Rect(0, 0, 1, 1), Coord2(0, 0), Rect(0, 0, 1, 1), Coord2(0.5f, 0)) == 0);
+			CHECK(gjk::distance(Rect(0, 0, 1, 1), Coord2(0, 0), Rect(0, 0, 1, 1), Coord2(1, 0)) == 0);
+			CHECK(gjk::distance(big, Coord2(0, 0), Circle(1), Coord2(2, 0)) == 0);
+		}
+	}
+}
+
+SCENARIO("Sweeping shapes with GJK.", "[gjk][collides]") {
+	const Polygon big(makeRegular(32, 2)); // Has a vertex at (2, 0).
+	const Rect rect(0, -0.5f, 1, 1);
+	Coord2 norm;
+	gFloat t;
+	GIVEN("A rectangle moving into a vertex of the polygon.") {
+		THEN("It collides with the rectangle's edge normal.") {
+			REQUIRE(gjk::collides(rect, Coord2(5, 0), Coord2(-8, 0), big, Coord2(0, 0), norm, t) == CollisionResult::Sweep);
+			CHECK(t == ApproxEps(0.375f));
+			CHECK(norm.x == ApproxEps(1));
+			CHECK(norm.y == ApproxEps(0));
+		}
+	}
+	GIVEN("A rectangle moving away from the polygon.") {
+		THEN("They don't collide.")
+			CHECK(gjk::collides(rect, Coord2(5, 0), Coord2(8, 0), big, Coord2(0, 0), norm, t) == CollisionResult::None);
+	}
+	GIVEN("A rectangle that doesn't move far enough to reach the polygon.") {
+		THEN("They don't collide.")
+			CHECK(gjk::collides(rect, Coord2(5, 0), Coord2(-2.5f, 0), big, Coord2(0, 0), norm, t) == CollisionResult::None);
+	}
+	GIVEN("A rectangle overlapping the polygon.") {
+		THEN("It gives the minimum translation vector.") {
+			REQUIRE(gjk::collides(rect, Coord2(1.5f, 0), Coord2(-8, 0), big, Coord2(0, 0), norm, t) == CollisionResult::MinimumTranslationVector);
+			CHECK(t == ApproxEps(0.5f));
+			CHECK(norm.x == ApproxEps(1));
+			CHECK(norm.y == ApproxEps(0));
+		}
+	}
+}
+
+SCENARIO("Choosing between SAT and GJK.", "[gjk]") {
+	const Polygon octagon(shapes::octagon);
+	const Polygon big(makeRegular(32, 2));
+	THEN("GJK is only preferred for pairs with many vertices.") {
+		CHECK_FALSE(gjk::isPreferred(octagon, octagon));
+		CHECK_FALSE(gjk::isPreferred(Circle(1), Rect(0, 0, 1, 1)));
+		CHECK(gjk::isPreferred(big, Circle(1)));
+		CHECK(gjk::isPreferred(big, big));
+	}
+	GIVEN("Shapes that touch.") {
+		THEN("They don't overlap, as with SAT.") {
+			CHECK_FALSE(gjk::overlaps(big, Coord2(0, 0), Rect(0, 0, 1, 1), Coord2(2, -0.5f)));
+			CHECK_FALSE(overlaps(big, Coord2(0, 0), Rect(0, 0, 1, 1), Coord2(2, -0.5f)));
+			CHECK(overlaps(big, Coord2(0, 0), Rect(0, 0, 1, 1), Coord2(1.9f, -0.5f)));
+		}
+	}
+}
+
+SCENARIO("GJK agrees with SAT.", "[gjk][overlaps][collides]") {
+	const Rect rect(-1, -0.5f, 2, 1);
+	const Polygon octagon(shapes::octagon);
+	const Polygon tri(shapes::tri);
+	const Polygon arb(shapes::arb);
+	const Polygon big(makeRegular(32, 2.5f));
+	const Polygon huge(makeRegular(64, 1.75f));
+	const Circle circle(1.25f);
+	const Polygon circlePoly(Circle(1.5f).toPoly());
+	const std::vector<ConstShapeRef> shapes{rect, octagon, tri, arb, big, huge, circle, circlePoly};
+	// Positions on a grid around the second shape, with steps that don't line up with the shapes' edges.
+	std::vector<Coord2> positions;
+	for (int x = -7; x <= 7; ++x) {
+		for (int y = -7; y <= 7; ++y)
+			positions.emplace_back(static_cast<gFloat>(x) * 0.613f, static_cast<gFloat>(y) * 0.571f);
+	}
+	const Coord2 secondPos(0.25f, -0.125f);
+	GIVEN("Each pair of shapes at many positions.") {
+		THEN("Overlap tests and minimum translation vectors agree.") {
+			for (const ConstShapeRef first : shapes) {
+				for (const ConstShapeRef second : shapes) {
+					const gFloat margin(hasCircle(first, second) ? 0.0001f : 0.00001f);
+					for (const Coord2 firstPos : positions) {
+						INFO("Shapes " << static_cast<int>(first.type()) << " and " << static_cast<int>(second.type()) << " at " << firstPos.x << ", " << firstPos.y);
+						const bool isOverlapping(sat::overlaps(first, firstPos, second, secondPos));
+						REQUIRE(gjk::overlaps(first, firstPos, second, secondPos) == isOverlapping);
+						Coord2 satNorm, gjkNorm;
+						gFloat satDist(0), gjkDist(0);
+						REQUIRE(sat::overlaps(first, firstPos, second, secondPos, satNorm, satDist) == isOverlapping);
+						REQUIRE(gjk::overlaps(first, firstPos, second, secondPos, gjkNorm, gjkDist) == isOverlapping);
+						if (isOverlapping) {
+							// SAT pushes shapes out the side their projections are ordered on, which can be farther than the minimum
+							// EPA finds when they overlap deeply. They agree on shallow overlaps.
+							if (satDist < 0.25f)
+								CHECK(gjkDist == Approx(satDist).margin(margin));
+							else
+								CHECK(gjkDist <= satDist + margin);
+							// Pushing out along the normal by the distance should separate the shapes.
+							CHECK_FALSE(sat::overlaps(first, firstPos + gjkNorm * (gjkDist + 0.001f), second, secondPos));
+						}
+					}
+				}
+			}
+		}
+		THEN("Sweep tests agree.") {
+			const std::vector<Coord2> deltas{Coord2(6, 0.5f), Coord2(-3, 4), Coord2(0.7f, -9), Coord2(-5, -5.5f)};
+			for (const ConstShapeRef first : shapes) {
+				for (const ConstShapeRef second : shapes) {
+					for (const Coord2 firstPos : positions) {
+						for (const Coord2 delta : deltas) {
+							INFO("Shapes " << static_cast<int>(first.type()) << " and " << static_cast<int>(second.type()) << " at "
+								<< firstPos.x << ", " << firstPos.y << " moving " << delta.x << ", " << delta.y);
+							Coord2 satNorm, gjkNorm;
+							gFloat satT(0), gjkT(0);
+							const CollisionResult expected(sat::collides(first, firstPos, delta, second, secondPos, satNorm, satT));
+							REQUIRE(gjk::collides(first, firstPos, delta, second, secondPos, gjkNorm, gjkT) == expected);
+							if (expected == CollisionResult::Sweep) {
+								CHECK(gjkT == Approx(satT).margin(0.0001));
+								CHECK_FALSE(sat::overlaps(first, firstPos + delta * (gjkT - 0.001f), second, secondPos));
+								// Where vertices meet, either shape's edge can give the normal, so only check that it opposes the movement.
+								CHECK(gjkNorm.magnitude() == Approx(1));
+								CHECK(gjkNorm.dot(delta) < 0);
+							}
+						}
+					}
+				}
+			}
+		}
+	}
+}
+
+SCENARIO("overlaps and collides switch to GJK at the vertex threshold.", "[gjk][overlaps][collides]") {
+	const std::size_t threshold(gjk::AUTO_VERTEX_THRESHOLD);
+	const Polygon half(makeRegular(threshold / 2, 1.5f));
+	const Polygon withRect(makeRegular(threshold - 4, 2));
+	const Polygon withCircle(makeRegular(threshold - 1, 1.75f));
+	const Polygon below(makeRegular(threshold - 5, 2));
+	const Rect rect(-1, -0.75f, 2, 1.5f);
+	const Circle circle(1.25f);
+	PolygonPool pool;
+	const PolygonPool::Handle pooled(pool.add(withRect));
+	const std::vector<std::pair<ConstShapeRef, ConstShapeRef>> pairs{
+		{half, half}, {withRect, rect}, {rect, withRect}, {withCircle, circle}, {circle, withCircle}, {pool.get(pooled), rect}};
+	std::vector<Coord2> positions;
+	for (int x = -6; x <= 6; ++x) {
+		for (int y = -6; y <= 6; ++y)
+			positions.emplace_back(static_cast<gFloat>(x) * 0.587f, static_cast<gFloat>(y) * 0.613f);
+	}
+	const Coord2 secondPos(0.25f, -0.125f);
+	THEN("Only pairs with at least the threshold's vertices between them are preferred.") {
+		for (const auto& [first, second] : pairs)
+			CHECK(gjk::isPreferred(first, second));
+		CHECK_FALSE(gjk::isPreferred(below, rect));
+	}
+	THEN("Overlap tests give GJK's results, which agree with SAT.") {
+		for (const auto& [first, second] : pairs) {
+			const gFloat margin(hasCircle(first, second) ? 0.0001f : 0.00001f);
+			for (const Coord2 firstPos : positions) {
+				INFO("Shapes " << static_cast<int>(first.type()) << " and " << static_cast<int>(second.type()) << " at " << firstPos.x << ", " << firstPos.y);
+				const bool isOverlapping(sat::overlaps(first, firstPos, second, secondPos));
+				REQUIRE(overlaps(first, firstPos, second, secondPos) == isOverlapping);
+				Coord2 norm, gjkNorm, satNorm;
+				gFloat dist(0), gjkDist(0), satDist(0);
+				REQUIRE(overlaps(first, firstPos, second, secondPos, norm, dist) == isOverlapping);
+				REQUIRE(gjk::overlaps(first, firstPos, second, secondPos, gjkNorm, gjkDist) == isOverlapping);
+				REQUIRE(sat::overlaps(first, firstPos, second, secondPos, satNorm, satDist) == isOverlapping);
+				if (isOverlapping) {
+					CHECK(norm == gjkNorm);
+					CHECK(dist == gjkDist);
+					if (satDist < 0.25f)
+						CHECK(dist == Approx(satDist).margin(margin));
+					else
+						CHECK(dist <= satDist + margin);
+					CHECK_FALSE(sat::overlaps(first, firstPos + norm * (dist + 0.001f), second, secondPos));
+				}
+			}
+		}
+	}
+	GIVEN("Deeply overlapping regular polygons, nearly on top of each other.") {
+		const Coord2 firstPos(secondPos + Coord2(0.2f, 0.1f));
+		Coord2 norm;
+		gFloat dist(0);
+		REQUIRE(overlaps(half, firstPos, half, secondPos, norm, dist));
+		THEN("The minimum translation vector pushes them apart by about their diameter, less their offset.") {
+			CHECK(norm.magnitude() == Approx(1));
+			CHECK(dist > 2 * 1.5f * std::cos(constants::PI / static_cast<gFloat>(threshold / 2)) - 0.25f);
+			CHECK(dist < 2 * 1.5f);
+			Coord2 satNorm;
+			gFloat satDist(0);
+			REQUIRE(sat::overlaps(half, firstPos, half, secondPos, satNorm, satDist));
+			CHECK(dist <= satDist + 0.00001f);
+			CHECK_FALSE(sat::overlaps(half, firstPos + norm * (dist + 0.001f), half, secondPos));
+			CHECK(sat::overlaps(half, firstPos + norm * (dist - 0.01f), half, secondPos));
+		}
+		THEN("collides gives the same minimum translation vector for a shape that doesn't move.") {
+			Coord2 collideNorm;
+			gFloat t(0);
+			REQUIRE(collides(half, firstPos, Coord2(0, 0), half, secondPos, collideNorm, t) == CollisionResult::MinimumTranslationVector);
+			CHECK(collideNorm == norm);
+			CHECK(t == dist);
+		}
+	}
+	THEN("Sweep tests give GJK's results, which agree with SAT.") {
+		const std::vector<Coord2> deltas{Coord2(6, 0.5f), Coord2(-3, 4), Coord2(0.7f, -9)};
+		for (const auto& [first, second] : pairs) {
+			for (const Coord2 firstPos : positions) {
+				for (const Coord2 delta : deltas) {
+					INFO("Shapes " << static_cast<int>(first.type()) << " and " << static_cast<int>(second.type()) << " at "
+						<< firstPos.x << ", " << firstPos.y << " moving " << delta.x << ", " << delta.y);
+					Coord2 norm, gjkNorm, satNorm;
+					gFloat t(0), gjkT(0), satT(0);
+					const CollisionResult expected(sat::collides(first, firstPos, delta, second, secondPos, satNorm, satT));
+					REQUIRE(collides(first, firstPos, delta, second, secondPos, norm, t) == expected);
+					REQUIRE(gjk::collides(first, firstPos, delta, second, secondPos, gjkNorm, gjkT) == expected);
+					if (expected == CollisionResult::Sweep) {
+						CHECK(t == gjkT);
+						CHECK(t == Approx(satT).margin(0.0001));
+						CHECK_FALSE(sat::overlaps(first, firstPos + delta * (t - 0.001f), second, secondPos));
+					}
+				}
+			}
+		}
+	}
+}
+
+SCENARIO("Benchmarking GJK against SAT.", "[.][benchmark][gjk]") {
+	const Polygon octagon(shapes::octagon);
+	const Polygon big(makeRegular(32, 2));
+	const Polygon huge(makeRegular(64, 2));
+	std::vector<Coord2> positions;
+	for (int i = 0; i < 1000; ++i)
+		positions.emplace_back(std::cos(static_cast<gFloat>(i)) * 5, std::sin(static_cast<gFloat>(i) * 1.3f) * 5);
+	const auto run = [&positions](auto test, ConstShapeRef first, ConstShapeRef second) {
+		int count(0);
+		Coord2 norm;
+		gFloat t;
+		for (const Coord2 position : positions)
+			count += test(first, position, Coord2(3, -2), second, Coord2(0, 0), norm, t) != CollisionResult::None ? 1 : 0;
+		return count;
+	};
+	const auto satTest = [](auto&&... args) { return sat::collides(args...); };
+	const auto gjkTest = [](auto&&... args) { return gjk::collides(args...); };
+	BENCHMARK("SAT: 1000 octagon sweeps") { run(satTest, octagon, octagon); }
+	BENCHMARK("GJK: 1000 octagon sweeps") { run(gjkTest, octagon, octagon); }
+	BENCHMARK("SAT: 1000 32-gon sweeps") { run(satTest, big, big); }
+	BENCHMARK("GJK: 1000 32-gon sweeps") { run(gjkTest, big, big); }
+	BENCHMARK("SAT: 1000 64-gon sweeps") { run(satTest, huge, huge); }
+	BENCHMARK("GJK: 1000 64-gon sweeps") { run(gjkTest, huge, huge); }
+}
@@ -0,0 +1,169 @@
+#include "catch.hpp"
+#include "definitions.hpp"
+
+#include <limits>
+#include <memory>
+#include <vector>
+
+using namespace ctp;
+
+SCENARIO("Finding collidables in a grid collision map.", "[GridCollisionMap]") {
+	GridCollisionMap map(Rect(0, 0, 100, 100), 10);
+	Wall left(Rect(0, 0, 5, 5), Coord2(10, 10));   // Cell (1, 1).
+	Wall right(Rect(0, 0, 5, 5), Coord2(80, 10));  // Cell (8, 1).
+	Wall big(Rect(0, 0, 45, 5), Coord2(15, 50));   // Cells (1, 5) to (6, 5).
+	map.insert(&left);
+	map.insert(&right);
+	map.insert(&big);
+	MovableTest mover(Movable::CollisionType::Deflect, ShapeContainer(Circle(1)), Coord2(12, 12));
+	GIVEN("A collider that is moving.") {
+		WHEN("It sweeps across many cells of one large collidable.") {
+			mover.position = Coord2(10, 52);
+			const auto colliding = map.getColliding(mover, Coord2(60, 0));
+			THEN("The collidable is only found once.") {
+				CHECK(colliding.size() == 1);
+				CHECK(contains(colliding, &big));
+			}
+		}
+		WHEN("It queries into a buffer that already has contents.") {
+			std::vector<Collidable*> colliding{&big, &big, &big};
+			map.getColliding(mover, mover.position, Coord2(70, 0), colliding);
+			THEN("The buffer is replaced with the result.") {
+				CHECK(colliding.size() == 2);
+				CHECK(contains(colliding, &left));
+				CHECK(contains(colliding, &right));
+			}
+		}
+	}
+	GIVEN("A collider that is in the map.") {
+		map.insert(&mover);
+		WHEN("It queries the map.") {
+			const auto colliding = map.getColliding(mover);
+			THEN("It doesn't find itself.") {
+				CHECK(colliding.size() == 1);
+				CHECK(contains(colliding, &left));
+			}
+		}
+	}
+	GIVEN("A collidable outside of the grid's bounds.") {
+		Wall outside(Rect(0, 0, 5, 5), Coord2(-50, -50));
+		map.insert(&outside);
+		WHEN("A collider is in the edge cell.") {
+			mover.position = Coord2(2, 2);
+			const auto colliding = map.getColliding(mover);
+			THEN("The collidable is found in the edge cell.") {
+				CHECK(colliding.size() == 1);
+				CHECK(contains(colliding, &outside));
+			}
+		}
+	}
+	GIVEN("Collidables far outside of the grid's bounds, beyond what an int can index.") {
+		Wall farAway(Rect(0, 0, 5, 5), Coord2(1e30f, -1e30f));
+		map.insert(&farAway);
+		WHEN("A collider is in the nearest edge cell.") {
+			mover.position = Coord2(98, 2);
+			THEN("The collidable is found there.")
+				CHECK(contains(map.getColliding(mover), &farAway));
+		}
+		WHEN("A collider sweeps an infinite distance.") {
+			const auto colliding = map.getColliding(mover, Coord2(std::numeric_limits<gFloat>::infinity(), 0));
+			THEN("It covers the row of cells to the grid's edge.") {
+				CHECK_FALSE(contains(colliding, &farAway));
+				CHECK(contains(colliding, &left));
+				CHECK(contains(colliding, &right));
+			}
+		}
+	}
+}
+
+SCENARIO("Making a grid collision map with an invalid cell size.", "[GridCollisionMap]") {
+	Wall wall(Rect(0, 0, 5, 5), Coord2(10, 10));
+	MovableTest mover(Movable::CollisionType::Deflect, ShapeContainer(Circle(1)), Coord2(12, 12));
+	THEN("The map is one cell covering its bounds, which still finds collidables.") {
+		for (const gFloat cellSize : {gFloat(0), gFloat(-10), std::numeric_limits<gFloat>::infinity(), std::numeric_limits<gFloat>::quiet_NaN()}) {
+			INFO("Cell size " << cellSize);
+			GridCollisionMap map(Rect(0, 0, 100, 100), cellSize);
+			map.insert(&wall);
+			CHECK(map.cellSize() == 100);
+			CHECK(contains(map.getColliding(mover), &wall));
+		}
+	}
+}
+
+SCENARIO("Changing the contents of a grid collision map.", "[GridCollisionMap]") {
+	GridCollisionMap map(Rect(0, 0, 100, 100), 10);
+	Wall first(Rect(0, 0, 5, 5), Coord2(10, 10));
+	Wall second(Rect(0, 0, 5, 5), Coord2(12, 12));
+	map.insert(&first);
+	map.insert(&second);
+	MovableTest mover(Movable::CollisionType::Deflect, ShapeContainer(Circle(1)), Coord2(12, 12));
+	GIVEN("Collidables that are inserted twice.") {
+		map.insert(&first);
+		THEN("They are only in the map once.") {
+			CHECK(map.size() == 2);
+			CHECK(map.getColliding(mover).size() == 2);
+		}
+	}
+	GIVEN("A collidable that is removed.") {
+		map.remove(&first);
+		THEN("It is no longer found.") {
+			CHECK(map.size() == 1);
+			CHECK_FALSE(map.contains(&first));
+			const auto colliding = map.getColliding(mover);
+			CHECK(colliding.size() == 1);
+			CHECK(contains(colliding, &second));
+		}
+		WHEN("Another collidable is inserted.") {
+			Wall third(Rect(0, 0, 5, 5), Coord2(14, 14));
+			map.insert(&third);
+			THEN("It is found along with the remaining collidable.") {
+				const auto colliding = map.getColliding(mover);
+				CHECK(colliding.size() == 2);
+				CHECK(contains(colliding, &second));
+				CHECK(contains(colliding, &third));
+			}
+		}
+	}
+	GIVEN("A collidable that moves.") {
+		MovableTest moving(Movable::CollisionType::Deflect, ShapeContainer(Rect(0, 0, 5, 5)), Coord2(10, 10));
+		map.insert(&moving);
+		moving.position = Coord2(70, 70);
+		WHEN("The map isn't updated.") {
+			THEN("It is found in its old cells.")
+				CHECK(contains(map.getColliding(mover), &moving));
+		}
+		WHEN("The map is updated.") {
+			map.update(&moving);
+			THEN("It is found in its new cells.") {
+				CHECK_FALSE(contains(map.getColliding(mover), &moving));
+				mover.position = Coord2(72, 72);
+				CHECK(contains(map.getColliding(mover), &moving));
+			}
+		}
+		WHEN("It moves to overlap some of its old cells.") {
+			moving.position = Coord2(15, 15);
+			map.update(&moving);
+			THEN("It is found in both the shared and new cells.") {
+				CHECK(contains(map.getColliding(mover), &moving));
+				mover.position = Coord2(22, 22);
+				CHECK(contains(map.getColliding(mover), &moving));
+			}
+		}
+	}
+	GIVEN("A map that is cleared.") {
+		map.clear();
+		THEN("Nothing is found.") {
+			CHECK(map.size() == 0);
+			CHECK(map.getColliding(mover).empty());
+		}
+	}
+}
+
+SCENARIO("A grid collision map behaves like every collision map.", "[GridCollisionMap][movable]") {
+	checkCollisionMapBasics([](const std::vector<Collidable*>& collidables) {
+		auto map = std::make_unique<GridCollisionMap>(Rect(-100, -100, 200, 200), 5);
+		for (Collidable* c : collidables)
+			map->insert(c);
+		return map;
+	});
+}
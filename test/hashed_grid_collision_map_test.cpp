@@ -0,0 +1,179 @@
+#include "catch.hpp"
+#include "definitions.hpp"
+
+#include <limits>
+#include <memory>
+#include <vector>
+
+using namespace ctp;
+
+SCENARIO("Finding collidables in a hashed grid collision map.", "[HashedGridCollisionMap]") {
+	HashedGridCollisionMap map(10);
+	Wall left(Rect(0, 0, 5, 5), Coord2(10, 10));          // Cell (1, 1).
+	Wall right(Rect(0, 0, 5, 5), Coord2(80, 10));         // Cell (8, 1).
+	Wall big(Rect(0, 0, 45, 5), Coord2(15, 50));          // Cells (1, 5) to (6, 5).
+	Wall distant(Rect(0, 0, 5, 5), Coord2(-1e6f, 1e6f));  // Cell (-100000, 100000).
+	map.insert(&left);
+	map.insert(&right);
+	map.insert(&big);
+	map.insert(&distant);
+	MovableTest mover(Movable::CollisionType::Deflect, ShapeContainer(Circle(1)), Coord2(12, 12));
+	CHECK(map.cellCount() == 9);
+	GIVEN("A collider that is stationary.") {
+		WHEN("It is near a collidable far from the origin.") {
+			const auto colliding = map.getColliding(mover, Coord2(-1e6f + 2, 1e6f + 2), Coord2(0, 0));
+			THEN("That collidable is found.") {
+				CHECK(colliding.size() == 1);
+				CHECK(contains(colliding, &distant));
+			}
+		}
+	}
+	GIVEN("A collider that is moving.") {
+		WHEN("It sweeps across many cells of one large collidable.") {
+			mover.position = Coord2(10, 52);
+			const auto colliding = map.getColliding(mover, Coord2(60, 0));
+			THEN("The collidable is only found once.") {
+				CHECK(colliding.size() == 1);
+				CHECK(contains(colliding, &big));
+			}
+		}
+		WHEN("It sweeps across more cells than the map has.") {
+			const auto colliding = map.getColliding(mover, Coord2(-1e6f - 10, 1e6f));
+			THEN("The collidables in the swept cells are found.") {
+				CHECK(colliding.size() == 3);
+				CHECK(contains(colliding, &left));
+				CHECK(contains(colliding, &big));
+				CHECK(contains(colliding, &distant));
+			}
+		}
+	}
+	GIVEN("Coordinates outside of the range of cells.") {
+		Wall far(Rect(0, 0, 5, 5), Coord2(1e30f, 1e30f));
+		map.insert(&far);
+		WHEN("A collider is near the collidable that is that far away.") {
+			const auto colliding = map.getColliding(mover, Coord2(1e30f, 1e30f), Coord2(0, 0));
+			THEN("That collidable is found.") {
+				CHECK(colliding.size() == 1);
+				CHECK(contains(colliding, &far));
+			}
+		}
+		WHEN("A collider sweeps an infinite distance.") {
+			const auto colliding = map.getColliding(mover, Coord2(std::numeric_limits<gFloat>::infinity(), 0));
+			THEN("The collidables in its row are found.") {
+				CHECK(colliding.size() == 2);
+				CHECK(contains(colliding, &left));
+				CHECK(contains(colliding, &right));
+			}
+		}
+		WHEN("A collider is at a position that isn't a number.") {
+			const gFloat nan(std::numeric_limits<gFloat>::quiet_NaN());
+			THEN("The query doesn't fail.")
+				CHECK_NOTHROW(map.getColliding(mover, Coord2(nan, nan), Coord2(0, 0)));
+		}
+	}
+	GIVEN("A collider that is in the map.") {
+		map.insert(&mover);
+		WHEN("It queries the map.") {
+			const auto colliding = map.getColliding(mover);
+			THEN("It doesn't find itself.") {
+				CHECK(colliding.size() == 1);
+				CHECK(contains(colliding, &left));
+			}
+		}
+	}
+}
+
+SCENARIO("Changing the contents of a hashed grid collision map.", "[HashedGridCollisionMap]") {
+	HashedGridCollisionMap map(10);
+	Wall first(Rect(0, 0, 5, 5), Coord2(10, 10));
+	Wall second(Rect(0, 0, 5, 5), Coord2(12, 12));
+	map.insert(&first);
+	map.insert(&second);
+	MovableTest mover(Movable::CollisionType::Deflect, ShapeContainer(Circle(1)), Coord2(12, 12));
+	GIVEN("Collidables that are inserted twice.") {
+		map.insert(&first);
+		THEN("They are only in the map once.") {
+			CHECK(map.size() == 2);
+			CHECK(map.getColliding(mover).size() == 2);
+		}
+	}
+	GIVEN("A collidable that is removed.") {
+		map.remove(&first);
+		THEN("It is no longer found.") {
+			CHECK(map.size() == 1);
+			CHECK_FALSE(map.contains(&first));
+			const auto colliding = map.getColliding(mover);
+			CHECK(colliding.size() == 1);
+			CHECK(contains(colliding, &second));
+		}
+		WHEN("The last collidable in its cells is removed.") {
+			map.remove(&second);
+			THEN("The cells are freed.") {
+				CHECK(map.cellCount() == 0);
+				CHECK(map.getColliding(mover).empty());
+			}
+		}
+	}
+	GIVEN("A collidable that moves.") {
+		MovableTest moving(Movable::CollisionType::Deflect, ShapeContainer(Rect(0, 0, 5, 5)), Coord2(10, 10));
+		map.insert(&moving);
+		moving.position = Coord2(70, 70);
+		WHEN("The map isn't updated.") {
+			THEN("It is found in its old cells.")
+				CHECK(contains(map.getColliding(mover), &moving));
+		}
+		WHEN("The map is updated.") {
+			map.update(&moving);
+			THEN("It is found in its new cells.") {
+				CHECK_FALSE(contains(map.getColliding(mover), &moving));
+				mover.position = Coord2(72, 72);
+				CHECK(contains(map.getColliding(mover), &moving));
+				CHECK(map.cellCount() == 2);
+			}
+		}
+		WHEN("It moves to overlap some of its old cells.") {
+			moving.position = Coord2(15, 15);
+			map.update(&moving);
+			THEN("It is found in both the shared and new cells.") {
+				CHECK(contains(map.getColliding(mover), &moving));
+				mover.position = Coord2(22, 22);
+				CHECK(contains(map.getColliding(mover), &moving));
+			}
+		}
+	}
+	GIVEN("Many collidables, so the table grows.") {
+		std::vector<std::unique_ptr<Wall>> walls;
+		for (int i = 0; i < 200; ++i) {
+			walls.push_back(std::make_unique<Wall>(Rect(0, 0, 1, 1), Coord2(static_cast<gFloat>(i * 10 + 2), -100)));
+			map.insert(walls.back().get());
+		}
+		WHEN("Every other one is removed.") {
+			for (std::size_t i = 0; i < walls.size(); i += 2)
+				map.remove(walls[i].get());
+			THEN("The rest are still found.") {
+				CHECK(map.cellCount() == 101);
+				for (std::size_t i = 0; i < walls.size(); ++i) {
+					const auto colliding = map.getColliding(mover, walls[i]->getPosition(), Coord2(0, 0));
+					CHECK(contains(colliding, walls[i].get()) == (i % 2 == 1));
+				}
+			}
+		}
+	}
+	GIVEN("A map that is cleared.") {
+		map.clear();
+		THEN("Nothing is found.") {
+			CHECK(map.size() == 0);
+			CHECK(map.cellCount() == 0);
+			CHECK(map.getColliding(mover).empty());
+		}
+	}
+}
+
+SCENARIO("A hashed grid collision map behaves like every collision map.", "[HashedGridCollisionMap][movable]") {
+	checkCollisionMapBasics([](const std::vector<Collidable*>& collidables) {
+		auto map = std::make_unique<HashedGridCollisionMap>(1);
+		for (Collidable* c : collidables)
+			map->insert(c);
+		return map;
+	});
+}
@@ -1,6 +1,11 @@
 #include "catch.hpp"
 #include "definitions.hpp"
 
+#include <cmath>
+#include <limits>
+#include <optional>
+#include <string>
+
 using namespace ctp;
 
 TEST_CASE("Ray and rectangle intersections.", "[isect][ray][rect]") {
@@ -287,4 +292,161 @@ TEST_CASE("Ray and rectangle intersections, with output distance and normals to
 		CHECK(out_norm_exit.x == ApproxEps(1));
 		CHECK(out_norm_exit.y == ApproxEps(0));
 	}
-}
\ No newline at end of file
+}
+TEST_CASE("Ray and batched rectangle intersections.", "[isect][ray][rect][batch]") {
+	// A grid of tiles with gaps between them.
+	std::vector<Rect> tiles;
+	for (int x = 0; x < 20; ++x) {
+		for (int y = 0; y < 20; ++y)
+			tiles.emplace_back(static_cast<gFloat>(x) * 1.5f, static_cast<gFloat>(y) * 1.25f, 1.0f, 1.0f);
+	}
+	tiles.emplace_back(-3, -3, 0.5f, 0.5f); // Leaves the last register partly padding.
+	const RectBatch batch(tiles);
+	REQUIRE(batch.size() == tiles.size());
+	std::vector<std::uint32_t> hits;
+	std::vector<gFloat> ts;
+	SECTION("The batch holds the rectangles it was given.") {
+		for (std::size_t i = 0; i < tiles.size(); ++i) {
+			CHECK(batch[i].x == tiles[i].x);
+			CHECK(batch[i].y == tiles[i].y);
+			CHECK(batch[i].right() == tiles[i].right());
+			CHECK(batch[i].bottom() == tiles[i].bottom());
+		}
+	}
+	SECTION("Batched results agree with testing each rectangle.") {
+		std::vector<Ray> rays;
+		for (const Coord2 origin : {Coord2(-2, -1), Coord2(14.2f, 12.1f), Coord2(0.5f, 0.5f), Coord2(31, 3.7f)}) {
+			for (int i = 0; i < 64; ++i) {
+				const gFloat angle(constants::TAU * static_cast<gFloat>(i) / 64.0f + 0.01f);
+				rays.push_back(Ray{origin, Coord2(std::cos(angle), std::sin(angle))});
+			}
+		}
+		// Axis aligned rays, through tiles and along their edges.
+		rays.push_back(Ray{Coord2(-2, 0.5f), Coord2(1, 0)});
+		rays.push_back(Ray{Coord2(40, 2.5f), Coord2(-1, 0)});
+		rays.push_back(Ray{Coord2(1.5f, -5), Coord2(0, 1)});
+		rays.push_back(Ray{Coord2(3.25f, 40), Coord2(0, -1)});
+		rays.push_back(Ray{Coord2(1.25f, 40), Coord2(0, -1)});
+		const gFloat maxT(25.3f);
+		for (const Ray& ray : rays) {
+			intersects(ray, batch, maxT, hits, ts);
+			REQUIRE(ts.size() == tiles.size());
+			std::size_t closestIndex(0);
+			gFloat closestT(-1);
+			const bool isAnyHit(intersects(ray, batch, maxT, closestIndex, closestT));
+			std::optional<gFloat> expectedClosest;
+			for (std::size_t i = 0; i < tiles.size(); ++i) {
+				INFO("Ray from " << ray.origin.x << ", " << ray.origin.y << " towards " << ray.dir.x << ", " << ray.dir.y << " and tile " << i);
+				gFloat t(0);
+				const bool isHit(intersects(ray, tiles[i], Coord2(0, 0), t) && t <= maxT);
+				REQUIRE(((hits[i / 32] >> (i % 32)) & 1) == (isHit ? 1u : 0u));
+				if (isHit) {
+					CHECK(ts[i] == Approx(t).margin(0.0001));
+					if (!expectedClosest || t < *expectedClosest)
+						expectedClosest = t;
+				}
+			}
+			REQUIRE(isAnyHit == expectedClosest.has_value());
+			if (isAnyHit) {
+				CHECK(closestT == Approx(*expectedClosest).margin(0.0001));
+				CHECK(ts[closestIndex] == closestT);
+			}
+		}
+	}
+	SECTION("The ray's origin is inside a rectangle.") {
+		const Ray ray{Coord2(1.75f, 0.5f), Coord2(-1, 0)};
+		std::size_t index(0);
+		gFloat t(-1);
+		REQUIRE(intersects(ray, batch, 10, index, t));
+		CHECK(t == 0);
+		CHECK(index == 20); // The tile at (1.5, 0).
+	}
+	SECTION("Rectangles beyond the maximum distance aren't hit.") {
+		const Ray ray{Coord2(-2, 0.5f), Coord2(1, 0)};
+		std::size_t index(0);
+		gFloat t(-1);
+		CHECK_FALSE(intersects(ray, batch, 1.9f, index, t));
+		REQUIRE(intersects(ray, batch, 2, index, t));
+		CHECK(index == 0);
+		CHECK(t == ApproxEps(2));
+	}
+	SECTION("Padding isn't hit with an infinite maximum distance.") {
+		const gFloat inf(std::numeric_limits<gFloat>::infinity());
+		const RectBatch single(std::vector<Rect>{Rect(0, 0, 1, 1)});
+		REQUIRE(single.paddedSize() > single.size());
+		std::size_t index(0);
+		gFloat t(-1);
+		for (const Coord2 dir : {Coord2(1, 0), Coord2(0, 1), Coord2(1, 1).normalize()}) {
+			const Ray miss{Coord2(-5, -5) - dir.perpCCW() * 3, dir};
+			intersects(miss, single, inf, hits, ts);
+			CHECK(hits == std::vector<std::uint32_t>{0});
+			CHECK_FALSE(intersects(miss, single, inf, index, t));
+			const Ray hit{Coord2(0.5f, 0.5f) - dir * 10, dir};
+			intersects(hit, single, inf, hits, ts);
+			CHECK(hits == std::vector<std::uint32_t>{1});
+			REQUIRE(intersects(hit, single, inf, index, t));
+			CHECK(index == 0);
+		}
+		// A missing ray against every tile of the larger batch, whose last register is also partly padding.
+		intersects(Ray{Coord2(-10, -10), Coord2(1, 0)}, batch, inf, hits, ts);
+		for (const std::uint32_t bits : hits)
+			CHECK(bits == 0);
+	}
+	SECTION("An empty batch.") {
+		const RectBatch empty;
+		std::size_t index(0);
+		gFloat t(0);
+		CHECK_FALSE(intersects(Ray{Coord2(0, 0), Coord2(1, 0)}, empty, 100, index, t));
+		intersects(Ray{Coord2(0, 0), Coord2(1, 0)}, empty, 100, hits, ts);
+		CHECK(hits.empty());
+		CHECK(ts.empty());
+	}
+}
+
+TEST_CASE("Benchmarking batched ray and rectangle intersections.", "[.][benchmark][isect][ray][rect][batch]") {
+	std::vector<Rect> tiles;
+	for (int x = 0; x < 64; ++x) {
+		for (int y = 0; y < 64; ++y) {
+			if ((x * 7 + y * 3) % 5 == 0) // Scattered solid tiles.
+				tiles.emplace_back(static_cast<gFloat>(x), static_cast<gFloat>(y), 1.0f, 1.0f);
+		}
+	}
+	const RectBatch batch(tiles);
+	std::vector<Ray> rays;
+	for (int i = 0; i < 256; ++i) {
+		const gFloat angle(static_cast<gFloat>(i) * 0.731f);
+		rays.push_back(Ray{Coord2(32.5f, 32.5f) + Coord2(std::cos(angle * 3), std::sin(angle * 5)) * 20.0f, Coord2(std::cos(angle), std::sin(angle))});
+	}
+	const gFloat maxT(100);
+	std::size_t hitCount(0);
+	BENCHMARK("256 closest hits against " + std::to_string(tiles.size()) + " tiles, one rectangle at a time") {
+		for (const Ray& ray : rays) {
+			gFloat closest(maxT);
+			bool isHit(false);
+			for (const Rect& tile : tiles) {
+				gFloat t;
+				if (intersects(ray, tile, Coord2(0, 0), t) && t <= closest) {
+					closest = t;
+					isHit = true;
+				}
+			}
+			hitCount += isHit ? 1 : 0;
+		}
+	}
+	BENCHMARK("256 closest hits against " + std::to_string(tiles.size()) + " tiles, batched") {
+		for (const Ray& ray : rays) {
+			std::size_t index;
+			gFloat t;
+			hitCount += intersects(ray, batch, maxT, index, t) ? 1 : 0;
+		}
+	}
+	std::vector<std::uint32_t> hits;
+	std::vector<gFloat> ts;
+	BENCHMARK("256 hit masks against " + std::to_string(tiles.size()) + " tiles, batched") {
+		for (const Ray& ray : rays) {
+			intersects(ray, batch, maxT, hits, ts);
+			hitCount += hits[0] & 1;
+		}
+	}
+	CHECK(hitCount > 0);
+}
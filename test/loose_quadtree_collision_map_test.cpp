@@ -0,0 +1,111 @@
+#include "catch.hpp"
+#include "definitions.hpp"
+
+#include <algorithm>
+#include <memory>
+
+using namespace ctp;
+
+SCENARIO("Placing collidables in a loose quadtree collision map.", "[LooseQuadtreeCollisionMap]") {
+	LooseQuadtreeCollisionMap map(Rect(0, 0, 128, 128), 4);
+	GIVEN("Collidables of different sizes.") {
+		Wall room(Rect(0, 0, 100, 100), Coord2(10, 10));
+		Wall medium(Rect(0, 0, 20, 20), Coord2(10, 10));
+		Wall projectile(Circle(0.5f), Coord2(50, 50));
+		map.insert(&room);
+		map.insert(&medium);
+		map.insert(&projectile);
+		THEN("Each is placed at the deepest node it fits in.") {
+			CHECK(map.getDepth(&room) == 0);
+			CHECK(map.getDepth(&medium) == 2); // Node size 32: fits in a loose child of size 16 no longer.
+			CHECK(map.getDepth(&projectile) == 4);
+		}
+	}
+	GIVEN("A collidable outside of the bounds.") {
+		Wall outside(Circle(0.5f), Coord2(-50, -50));
+		map.insert(&outside);
+		THEN("It is placed in the root.")
+			CHECK(map.getDepth(&outside) == 0);
+	}
+	GIVEN("A minimum node size.") {
+		LooseQuadtreeCollisionMap limited(Rect(0, 0, 128, 128), 10, 32);
+		Wall projectile(Circle(0.5f), Coord2(50, 50));
+		limited.insert(&projectile);
+		THEN("Nodes are not subdivided past it.") {
+			CHECK(limited.maxDepth() == 2);
+			CHECK(limited.getDepth(&projectile) == 2);
+		}
+	}
+}
+
+SCENARIO("Finding collidables in a loose quadtree collision map.", "[LooseQuadtreeCollisionMap]") {
+	LooseQuadtreeCollisionMap map(Rect(0, 0, 100, 100));
+	Wall left(Rect(0, 0, 5, 5), Coord2(10, 10));
+	Wall right(Rect(0, 0, 5, 5), Coord2(80, 10));
+	Wall room(Rect(0, 0, 90, 2), Coord2(5, 50));
+	Wall outside(Rect(0, 0, 5, 5), Coord2(-20, 10));
+	map.build({&left, &right, &room, &outside});
+	MovableTest mover(Movable::CollisionType::Deflect, ShapeContainer(Circle(1)), Coord2(12, 12));
+	CHECK(map.size() == 4);
+	GIVEN("A collider that is stationary.") {
+		WHEN("It is only near one collidable.") {
+			const auto colliding = map.getColliding(mover);
+			THEN("Only that collidable is found.") {
+				CHECK(colliding.size() == 1);
+				CHECK(contains(colliding, &left));
+			}
+		}
+		WHEN("It is on a large collidable far from the large collidable's center.") {
+			const auto colliding = map.getColliding(mover, Coord2(90, 51), Coord2(0, 0));
+			THEN("The large collidable is found.") {
+				CHECK(colliding.size() == 1);
+				CHECK(contains(colliding, &room));
+			}
+		}
+		WHEN("It is near a collidable outside of the bounds.") {
+			const auto colliding = map.getColliding(mover, Coord2(-18, 12), Coord2(0, 0));
+			THEN("That collidable is found.") {
+				CHECK(colliding.size() == 1);
+				CHECK(contains(colliding, &outside));
+			}
+		}
+	}
+	GIVEN("A collider that is moving.") {
+		WHEN("It sweeps across several collidables.") {
+			const auto colliding = map.getColliding(mover, Coord2(70, 40));
+			THEN("They are all found.") {
+				CHECK(colliding.size() == 3);
+				CHECK(contains(colliding, &left));
+				CHECK(contains(colliding, &right));
+				CHECK(contains(colliding, &room));
+			}
+		}
+	}
+	GIVEN("A collidable that moves.") {
+		MovableTest moving(Movable::CollisionType::Deflect, ShapeContainer(Rect(0, 0, 2, 2)), Coord2(11, 11));
+		map.insert(&moving);
+		moving.position = Coord2(70, 70);
+		map.update(&moving);
+		THEN("It is found in its new position.") {
+			CHECK_FALSE(contains(map.getColliding(mover), &moving));
+			mover.position = Coord2(71, 71);
+			CHECK(contains(map.getColliding(mover), &moving));
+		}
+		WHEN("It is removed.") {
+			map.remove(&moving);
+			THEN("It is no longer found.") {
+				mover.position = Coord2(71, 71);
+				CHECK(map.getColliding(mover).empty());
+				CHECK(map.getDepth(&moving) == -1);
+			}
+		}
+	}
+}
+
+SCENARIO("A loose quadtree collision map behaves like every collision map.", "[LooseQuadtreeCollisionMap][movable]") {
+	checkCollisionMapBasics([](const std::vector<Collidable*>& collidables) {
+		auto map = std::make_unique<LooseQuadtreeCollisionMap>(Rect(-16, -16, 32, 32));
+		map->build(collidables);
+		return map;
+	});
+}
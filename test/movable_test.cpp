@@ -3,20 +3,6 @@
 
 using namespace ctp;
 
-struct MovableTest : public Movable {
-	ShapeContainer collider;
-	Coord2 position;
-
-	MovableTest(Movable::CollisionType type, ShapeContainer collider) : Movable{type}, collider{std::move(collider)} {}
-	MovableTest(Movable::CollisionType type, ShapeContainer collider, Coord2 position) : Movable{type}, collider{std::move(collider)}, position{position} {}
-	~MovableTest() override {}
-	Coord2 getPosition() const override { return position; }
-	ConstShapeRef getCollider() const override { return collider; }
-	void move(Coord2 delta, const CollisionMap& map) {
-		position = Movable::move(collider, position, delta, map);
-	}
-};
-
 class CollisionMapTest : public CollisionMap {
 public:
 	CollisionMapTest() = default;
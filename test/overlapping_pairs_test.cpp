@@ -0,0 +1,111 @@
+#include "catch.hpp"
+#include "definitions.hpp"
+
+#include <algorithm>
+#include <memory>
+
+using namespace ctp;
+
+namespace {
+bool containsPair(const std::vector<OverlappingPair>& pairs, const Collidable* a, const Collidable* b) {
+	return std::any_of(pairs.begin(), pairs.end(), [a, b](const OverlappingPair& p) { return p.first == a && p.second == b; });
+}
+
+// A scattered scene of rectangles, circles, and polygons, with some overlapping.
+std::vector<std::unique_ptr<Wall>> makeScene(int count, int width, int height) {
+	std::vector<std::unique_ptr<Wall>> walls;
+	unsigned int seed = 12345;
+	const auto random = [&seed](int max) { // Small deterministic generator, so tests are repeatable.
+		seed = seed * 1103515245u + 12345u;
+		return static_cast<int>((seed >> 16) % static_cast<unsigned int>(max));
+	};
+	for (int i = 0; i < count; ++i) {
+		const Coord2 position(static_cast<gFloat>(random(width * 10)) * 0.1f, static_cast<gFloat>(random(height * 10)) * 0.1f);
+		switch (i % 3) {
+		case 0: walls.push_back(std::make_unique<Wall>(Rect(0, 0, 1 + random(30) * 0.1f, 1 + random(30) * 0.1f), position)); break;
+		case 1: walls.push_back(std::make_unique<Wall>(Circle(0.5f + random(10) * 0.1f), position)); break;
+		case 2: walls.push_back(std::make_unique<Wall>(Polygon(shapes::octagon), position)); break;
+		}
+	}
+	return walls;
+}
+}
+
+SCENARIO("Finding overlapping pairs of collidables.", "[overlapping_pairs]") {
+	Wall rect(Rect(0, 0, 2, 2), Coord2(0, 0));
+	Wall circle(Circle(1), Coord2(2.5f, 1));         // Overlaps rect.
+	Wall octagon(Polygon(shapes::octagon), Coord2(4, 1)); // Overlaps circle.
+	Wall touching(Rect(0, 0, 2, 2), Coord2(-2, 0));   // Touches rect.
+	Wall alone(Rect(0, 0, 1, 1), Coord2(50, 50));
+	GIVEN("A small scene.") {
+		const auto pairs = findOverlappingPairs({&rect, &circle, &octagon, &touching, &alone});
+		THEN("Each overlapping pair is found once, in the order given.") {
+			CHECK(pairs.size() == 2);
+			CHECK(containsPair(pairs, &rect, &circle));
+			CHECK(containsPair(pairs, &circle, &octagon));
+		}
+	}
+	GIVEN("A scene with null and repeated collidables.") {
+		const auto pairs = findOverlappingPairs({&circle, nullptr, &rect, &circle, &rect, &alone});
+		THEN("They are skipped.") {
+			CHECK(pairs.size() == 1);
+			CHECK(containsPair(pairs, &circle, &rect));
+		}
+	}
+	GIVEN("Minimum translation vectors are requested.") {
+		const auto pairs = findOverlappingPairs({&rect, &circle}, true);
+		THEN("They separate the first collidable from the second.") {
+			REQUIRE(pairs.size() == 1);
+			CHECK(pairs[0].normal.x == ApproxEps(-1));
+			CHECK(pairs[0].normal.y == ApproxEps(0));
+			CHECK(pairs[0].dist == ApproxEps(0.5f));
+		}
+	}
+	GIVEN("An empty scene.") {
+		THEN("There are no pairs.")
+			CHECK(findOverlappingPairs({}).empty());
+	}
+}
+
+SCENARIO("Finding overlapping pairs in a large scene on multiple threads.", "[overlapping_pairs]") {
+	const auto walls = makeScene(600, 100, 50);
+	std::vector<Collidable*> collidables;
+	for (const auto& wall : walls)
+		collidables.push_back(wall.get());
+	std::vector<std::pair<Collidable*, Collidable*>> expected;
+	for (std::size_t i = 0; i < collidables.size(); ++i) {
+		for (std::size_t k = i + 1; k < collidables.size(); ++k) {
+			if (overlaps(collidables[i]->getCollider(), collidables[i]->getPosition(), collidables[k]->getCollider(), collidables[k]->getPosition()))
+				expected.emplace_back(collidables[i], collidables[k]);
+		}
+	}
+	REQUIRE(expected.size() > 512); // Enough to be split across threads.
+	const auto serial = findOverlappingPairs(collidables, true, 1);
+	const auto parallel = findOverlappingPairs(collidables, true, 4);
+	THEN("The same pairs are found as by testing every pair.") {
+		REQUIRE(serial.size() == expected.size());
+		REQUIRE(parallel.size() == expected.size());
+		for (std::size_t i = 0; i < expected.size(); ++i) {
+			CHECK(parallel[i].first == expected[i].first);
+			CHECK(parallel[i].second == expected[i].second);
+			CHECK(parallel[i].normal == serial[i].normal);
+			CHECK(parallel[i].dist == serial[i].dist);
+		}
+	}
+}
+
+SCENARIO("Benchmarking finding overlapping pairs.", "[.][benchmark][overlapping_pairs]") {
+	const auto walls = makeScene(50000, 2000, 1000);
+	std::vector<Collidable*> collidables;
+	for (const auto& wall : walls)
+		collidables.push_back(wall.get());
+	BENCHMARK("50k collidables on one thread") {
+		findOverlappingPairs(collidables, false, 1);
+	}
+	BENCHMARK("50k collidables on all threads") {
+		findOverlappingPairs(collidables);
+	}
+	BENCHMARK("50k collidables with minimum translation vectors") {
+		findOverlappingPairs(collidables, true);
+	}
+}
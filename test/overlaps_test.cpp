@@ -1,6 +1,10 @@
 #include "catch.hpp"
 #include "definitions.hpp"
 
+#include <algorithm>
+#include <limits>
+#include <vector>
+
 using namespace ctp;
 
 TEST_CASE("Rectangle overlap.", "[overlaps]") {
@@ -737,3 +741,115 @@ SCENARIO("Two shapes are overlapping, and need to be separated (by the minimum t
 		}
 	}
 }
+
+SCENARIO("A circle overlapping a polygon is pushed out of the polygon's closest edge or vertex.", "[overlaps]") {
+	const Circle circle(1);
+	const Polygon square(Rect(0, 0, 2, 2).toPoly());
+	const Coord2 squarePos(0, 0);
+	Coord2 out_norm;
+	gFloat out_dist;
+	GIVEN("The circle's center is beside the top edge.") {
+		const Coord2 circlePos(1, -0.5f);
+		THEN("It is pushed out by the edge's normal.") {
+			REQUIRE(overlaps(circle, circlePos, square, squarePos, out_norm, out_dist));
+			CHECK(out_norm.x == ApproxEps(0));
+			CHECK(out_norm.y == ApproxEps(-1));
+			CHECK(out_dist == ApproxEps(0.5f));
+		}
+	}
+	GIVEN("The circle's center is past the top left vertex.") {
+		const Coord2 circlePos(-0.5f, -0.5f);
+		THEN("It is pushed out diagonally, away from the vertex.") {
+			const Coord2 expected_norm(Coord2(-1, -1).normalize());
+			REQUIRE(overlaps(circle, circlePos, square, squarePos, out_norm, out_dist));
+			CHECK(out_norm.x == ApproxEps(expected_norm.x));
+			CHECK(out_norm.y == ApproxEps(expected_norm.y));
+			CHECK(out_dist == ApproxEps(1.0f - std::sqrt(0.5f)));
+		}
+	}
+	GIVEN("The circle's center is past the top left vertex, within a radius of both edges, but not of the vertex.") {
+		const Coord2 circlePos(-0.8f, -0.8f);
+		THEN("They do not overlap.") {
+			CHECK_FALSE(overlaps(circle, circlePos, square, squarePos));
+			CHECK_FALSE(overlaps(circle, circlePos, square, squarePos, out_norm, out_dist));
+		}
+	}
+	GIVEN("The circle's center is inside the polygon, nearest its right edge.") {
+		const Coord2 circlePos(1.5f, 1);
+		THEN("It is pushed out the right edge.") {
+			REQUIRE(overlaps(circle, circlePos, square, squarePos, out_norm, out_dist));
+			CHECK(out_norm.x == ApproxEps(1));
+			CHECK(out_norm.y == ApproxEps(0));
+			CHECK(out_dist == ApproxEps(1.5f));
+		}
+		THEN("With the polygon first, the polygon is pushed the other way.") {
+			REQUIRE(overlaps(square, squarePos, circle, circlePos, out_norm, out_dist));
+			CHECK(out_norm.x == ApproxEps(-1));
+			CHECK(out_norm.y == ApproxEps(0));
+			CHECK(out_dist == ApproxEps(1.5f));
+		}
+	}
+	GIVEN("The circle is touching the right edge.") {
+		const Coord2 circlePos(3, 1);
+		THEN("Touching shapes are not overlapping.") {
+			CHECK_FALSE(overlaps(circle, circlePos, square, squarePos));
+			CHECK_FALSE(overlaps(circle, circlePos, square, squarePos, out_norm, out_dist));
+		}
+	}
+	GIVEN("Polygons, and the circle at many positions around and inside them.") {
+		const std::vector<Polygon> polys = {Polygon(shapes::tri), Polygon(shapes::octagon), Polygon(shapes::arb, true)};
+		const Coord2 polyPos(0, 0);
+		THEN("They agree with projecting both shapes onto every separating axis.") {
+			for (const Polygon& poly : polys) {
+				for (int i = 0; i < 1600; ++i) {
+					const Coord2 circlePos(static_cast<gFloat>(i % 40) * 0.13f - 2.5f, static_cast<gFloat>(i / 40) * 0.13f - 2.5f);
+					gFloat depth(std::numeric_limits<gFloat>::max());
+					for (const Coord2& axis : sat::getSeparatingAxes(circle, poly, circlePos)) {
+						Projection projCircle(circle.getProjection(axis));
+						projCircle += circlePos.dot(axis);
+						const Projection projPoly(poly.getProjection(axis));
+						depth = std::min({depth, projCircle.max - projPoly.min, projPoly.max - projCircle.min});
+					}
+					if (std::abs(depth - constants::EPSILON) < 0.0001f)
+						continue; // Too close to touching for rounding to agree.
+					INFO("Circle at " << circlePos.x << ", " << circlePos.y << " with a polygon of " << poly.size() << " vertices");
+					const bool isOverlapping(depth >= constants::EPSILON);
+					CHECK(overlaps(circle, circlePos, poly, polyPos) == isOverlapping);
+					CHECK(overlaps(ConstShapeRef(poly), polyPos, circle, circlePos) == isOverlapping);
+					REQUIRE(overlaps(circle, circlePos, poly, polyPos, out_norm, out_dist) == isOverlapping);
+					if (isOverlapping) {
+						CHECK(out_dist == Approx(depth).margin(0.0001f));
+						// Moving the circle out by the translation leaves it touching.
+						CHECK_FALSE(overlaps(circle, circlePos + out_norm * (out_dist + 0.0001f), poly, polyPos));
+					}
+				}
+			}
+		}
+	}
+}
+
+SCENARIO("Benchmarking circles against polygons.", "[.][benchmark][overlaps]") {
+	// Circles at positions ranging from separated to overlapping, against polygon terrain.
+	const Circle circle(1);
+	const Polygon octagon(shapes::octagon, true);
+	const Polygon boulder(Circle(2).toPoly());
+	std::vector<Coord2> positions;
+	for (int i = 0; i < 1000; ++i)
+		positions.emplace_back(static_cast<gFloat>(i % 40) * 0.15f - 3.0f, static_cast<gFloat>(i / 40) * 0.24f - 3.0f);
+	int count(0);
+	Coord2 norm;
+	gFloat dist;
+	BENCHMARK("1000 overlap tests with an octagon") {
+		for (const Coord2& pos : positions)
+			count += overlaps(circle, pos, octagon, Coord2(0, 0)) ? 1 : 0;
+	}
+	BENCHMARK("1000 minimum translation vectors with an octagon") {
+		for (const Coord2& pos : positions)
+			count += overlaps(circle, pos, octagon, Coord2(0, 0), norm, dist) ? 1 : 0;
+	}
+	BENCHMARK("1000 minimum translation vectors with a polygon of Circle::SEGS_IN_POLY vertices") {
+		for (const Coord2& pos : positions)
+			count += overlaps(circle, pos, boulder, Coord2(0, 0), norm, dist) ? 1 : 0;
+	}
+	CHECK(count > 0);
+}
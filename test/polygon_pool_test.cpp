@@ -0,0 +1,168 @@
+#include "catch.hpp"
+#include "definitions.hpp"
+
+#include <array>
+#include <cmath>
+#include <memory>
+
+using namespace ctp;
+
+SCENARIO("Storing polygons in a pool.", "[PolygonPool][poly]") {
+	PolygonPool pool;
+	GIVEN("An empty pool.") {
+		THEN("It has no polygons.") {
+			CHECK(pool.empty());
+			CHECK(pool.size() == 0);
+		}
+	}
+	GIVEN("A pool with some polygons.") {
+		const PolygonPool::Handle tri = pool.add(shapes::tri);
+		const PolygonPool::Handle octagon = pool.add(shapes::octagon.data(), shapes::octagon.size());
+		const PolygonPool::Handle moved = pool.add(Polygon(shapes::arb), Coord2(5, -1));
+		THEN("Handles are given out in order, and refer to copies of the polygons.") {
+			REQUIRE(pool.size() == 3);
+			CHECK(tri == 0);
+			CHECK(octagon == 1);
+			CHECK(moved == 2);
+			for (std::size_t i = 0; i < shapes::tri.size(); ++i)
+				CHECK(pool[tri][i] == shapes::tri[i]);
+			for (std::size_t i = 0; i < shapes::octagon.size(); ++i)
+				CHECK(pool[octagon][i] == shapes::octagon[i]);
+		}
+		THEN("Polygons added at a position are translated.") {
+			REQUIRE(pool[moved].size() == shapes::arb.size());
+			for (std::size_t i = 0; i < shapes::arb.size(); ++i)
+				CHECK(pool[moved][i] == shapes::arb[i] + Coord2(5, -1));
+			CHECK(pool[moved].left() == ApproxEps(5));
+			CHECK(pool[moved].top() == ApproxEps(-3));
+		}
+		THEN("Their edge normals are precomputed.") {
+			const Polygon computed(shapes::octagon, true);
+			for (std::size_t i = 0; i < computed.size(); ++i)
+				CHECK(pool[octagon].getEdgeNorm(i) == computed.getEdgeNorm(i));
+		}
+		THEN("Pooled polygons can be tested directly.") {
+			CHECK(overlaps(pool.get(tri), Coord2(0, 0), pool.get(octagon), Coord2(1, 0)));
+			CHECK_FALSE(overlaps(pool.get(tri), Coord2(0, 0), pool.get(moved), Coord2(0, 0)));
+			Coord2 norm;
+			gFloat t;
+			CHECK(collides(pool.get(octagon), Coord2(-10, 0), Coord2(20, 0), pool.get(moved), Coord2(0, 0), norm, t) == CollisionResult::Sweep);
+			const ConstShapeRef ref(pool.get(octagon));
+			CHECK(intersects(Ray{Coord2(-5, 0), Coord2(1, 0)}, ref, Coord2(0, 0), t));
+			CHECK(t == ApproxEps(3));
+			CHECK(intersects(Ray{Coord2(-5, 0), Coord2(1, 0)}, pool[octagon], Coord2(0, 0), t));
+			CHECK(t == ApproxEps(3));
+			CHECK(overlaps(Circle(1), Coord2(-2.5f, 0), pool[octagon], Coord2(0, 0)));
+			CHECK_FALSE(overlaps(Circle(1), Coord2(-3.5f, 0), pool[octagon], Coord2(0, 0)));
+		}
+		THEN("Pooled polygons give the same results as the polygons they were made from.") {
+			const Polygon polygon(shapes::arb, true);
+			const PolygonView pooled(pool[moved]);
+			const Coord2 dirs[] = {Coord2(1, 0), Coord2(0, -1), Coord2(-1, 1).normalize(), Coord2(0.3f, 0.7f).normalize()};
+			for (const Coord2 dir : dirs) {
+				CHECK(pooled.getSupportIndex(dir) == polygon.getSupportIndex(dir));
+				CHECK(pooled.getProjection(dir).min == ApproxEps(polygon.getProjection(dir).min + dir.dot(Coord2(5, -1))));
+				CHECK(pooled.getVerticesInDirection(dir).first_index == polygon.getVerticesInDirection(dir).first_index);
+				CHECK(pooled.getVerticesInDirection(dir).last_index == polygon.getVerticesInDirection(dir).last_index);
+			}
+			CHECK(pooled.getNumAxes() == polygon.getNumAxes());
+			const Polygon copy(pool[moved].toPoly());
+			CHECK(copy.size() == polygon.size());
+			CHECK(copy[0] == polygon[0] + Coord2(5, -1));
+			CHECK(copy.getEdgeNorm(2) == polygon.getEdgeNorm(2));
+		}
+		WHEN("A polygon big enough for a table of edge normal angles is added.") {
+			Polygon big(Circle(2).toPoly());
+			big.computeNormals();
+			REQUIRE(big.size() >= Polygon::SUPPORT_TABLE_MIN_SIZE);
+			const PolygonPool::Handle handle = pool.add(big);
+			THEN("It finds the same vertices as the polygon.") {
+				for (int i = 0; i < 16; ++i) {
+					const gFloat angle(static_cast<gFloat>(i) * 0.4f);
+					const Coord2 dir(std::cos(angle), std::sin(angle));
+					CHECK(pool[handle].getSupportIndex(dir) == big.getSupportIndex(dir));
+					CHECK(pool[handle].getVerticesInDirection(dir).first_index == big.getVerticesInDirection(dir).first_index);
+					CHECK(pool[handle].getVerticesInDirection(dir).last_index == big.getVerticesInDirection(dir).last_index);
+				}
+				CHECK(pool[tri][0] == shapes::tri[0]);
+			}
+		}
+		WHEN("More polygons are added.") {
+			for (int i = 0; i < 100; ++i)
+				pool.add(shapes::rightTri);
+			THEN("Earlier handles still refer to the same polygons.") {
+				CHECK(pool.size() == 103);
+				CHECK(pool[octagon].size() == shapes::octagon.size());
+				CHECK(pool[moved][0] == shapes::arb[0] + Coord2(5, -1));
+			}
+		}
+		WHEN("The pool is cleared.") {
+			pool.clear();
+			THEN("It is empty.")
+				CHECK(pool.empty());
+		}
+	}
+}
+
+SCENARIO("Benchmarking pooled polygons.", "[.][benchmark][PolygonPool]") {
+	// A level of small polygons, with their vertices loaded into one flat array.
+	constexpr int NUM_POLYGONS = 20000;
+	const std::vector<std::vector<Coord2>> kinds{shapes::rightTri, shapes::tri, shapes::arb, shapes::octagon};
+	std::vector<Coord2> levelVertices;
+	std::vector<std::size_t> levelSizes;
+	std::vector<Coord2> positions;
+	for (int i = 0; i < NUM_POLYGONS; ++i) {
+		const std::vector<Coord2>& kind = kinds[i % kinds.size()];
+		const Coord2 pos(static_cast<gFloat>(i % 200) * 5, static_cast<gFloat>(i / 200) * 5);
+		for (const Coord2 vertex : kind)
+			levelVertices.push_back(vertex + pos);
+		levelSizes.push_back(kind.size());
+		positions.push_back(pos);
+	}
+	const auto loadSeparately = [&] {
+		std::vector<std::unique_ptr<Polygon>> polygons;
+		for (std::size_t i = 0, offset = 0; i < levelSizes.size(); offset += levelSizes[i++]) {
+			std::vector<Coord2> vertices(levelVertices.begin() + offset, levelVertices.begin() + offset + levelSizes[i]);
+			polygons.push_back(std::make_unique<Polygon>(vertices, true));
+		}
+		return polygons;
+	};
+	const auto loadPool = [&](PolygonPool& pool) {
+		pool.reserve(levelSizes.size(), levelVertices.size());
+		for (std::size_t i = 0, offset = 0; i < levelSizes.size(); offset += levelSizes[i++])
+			pool.add(levelVertices.data() + offset, levelSizes[i]);
+	};
+	std::size_t loaded(0);
+	BENCHMARK("Loading 20000 separately allocated polygons") { loaded += loadSeparately().size(); }
+	BENCHMARK("Loading 20000 pooled polygons") {
+		PolygonPool pool;
+		loadPool(pool);
+		loaded += pool.size();
+	}
+	CHECK(loaded > 0);
+
+	// Separately allocated polygons end up spread over the heap, between whatever else is allocated while loading a level.
+	std::vector<std::unique_ptr<Polygon>> separate;
+	std::vector<std::unique_ptr<std::array<char, 256>>> otherAllocations;
+	for (std::size_t i = 0, offset = 0; i < levelSizes.size(); offset += levelSizes[i++]) {
+		separate.push_back(std::make_unique<Polygon>(std::vector<Coord2>(levelVertices.begin() + offset, levelVertices.begin() + offset + levelSizes[i]), true));
+		otherAllocations.push_back(std::make_unique<std::array<char, 256>>());
+	}
+	PolygonPool pool;
+	loadPool(pool);
+	const Polygon probe(shapes::octagon, true);
+	int hits(0);
+	BENCHMARK("Sweeping against 20000 separately allocated polygons") {
+		Coord2 norm;
+		gFloat t;
+		for (std::size_t i = 0; i < separate.size(); ++i)
+			hits += collides(probe, positions[i] + Coord2(-2, 1), Coord2(3, 0.5f), *separate[i], Coord2(0, 0), norm, t) != CollisionResult::None ? 1 : 0;
+	}
+	BENCHMARK("Sweeping against 20000 pooled polygons") {
+		Coord2 norm;
+		gFloat t;
+		for (PolygonPool::Handle i = 0; i < pool.size(); ++i)
+			hits += collides(probe, positions[i] + Coord2(-2, 1), Coord2(3, 0.5f), pool.get(i), Coord2(0, 0), norm, t) != CollisionResult::None ? 1 : 0;
+	}
+	CHECK(hits > 0);
+}
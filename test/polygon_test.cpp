@@ -1,6 +1,9 @@
 #include "catch.hpp"
 #include "definitions.hpp"
 
+#include <cmath>
+#include <string>
+
 using namespace ctp;
 
 SCENARIO("Translate a polygon.", "[poly]") {
@@ -237,6 +240,277 @@ SCENARIO("A polygon computes its normals." "[poly]") {
 	}
 }
 
+static std::vector<Coord2> _get_regular_polygon(std::size_t vertices, gFloat radius, gFloat rotation = 0) {
+	std::vector<Coord2> points;
+	points.reserve(vertices);
+	for (std::size_t i = 0; i < vertices; ++i) {
+		const gFloat angle = rotation - constants::TAU * static_cast<gFloat>(i) / static_cast<gFloat>(vertices);
+		points.emplace_back(radius * std::cos(angle), radius * std::sin(angle));
+	}
+	return points;
+}
+
+SCENARIO("A polygon merges its parallel edge normals into axes.", "[poly]") {
+	GIVEN("Polygons with and without parallel sides.") {
+		Polygon oct(shapes::octagon);
+		Polygon tri(shapes::tri);
+		Polygon rect(Rect(1, 2, 3, 4).toPoly());
+		Polygon hexagon(_get_regular_polygon(6, 2.0f));
+		Polygon heptagon(_get_regular_polygon(7, 2.0f));
+		WHEN("Their normals aren't computed.") {
+			THEN("Each edge normal is an axis.") {
+				CHECK_FALSE(oct.hasMergedAxes());
+				REQUIRE(oct.getNumAxes() == oct.size());
+				for (std::size_t i = 0; i < oct.size(); ++i)
+					CHECK(oct.isAxis(i));
+			}
+		}
+		WHEN("Their normals are computed.") {
+			for (Polygon* p : {&oct, &tri, &rect, &hexagon, &heptagon})
+				p->computeNormals();
+			THEN("Opposite sides share an axis.") {
+				CHECK(oct.hasMergedAxes());
+				CHECK(oct.getNumAxes() == 4);
+				CHECK(rect.getNumAxes() == 2);
+				CHECK(hexagon.getNumAxes() == 3);
+				CHECK(tri.getNumAxes() == 3);
+				CHECK(heptagon.getNumAxes() == 7);
+			}
+			THEN("Axes are the first edge normal in each direction.") {
+				for (std::size_t i = 0; i < oct.size(); ++i)
+					CHECK(oct.isAxis(i) == (i < 4));
+				CHECK(rect.isAxis(0));
+				CHECK(rect.isAxis(1));
+				CHECK_FALSE(rect.isAxis(2));
+				CHECK_FALSE(rect.isAxis(3));
+			}
+		}
+	}
+	GIVEN("A polygon too big to merge its axes.") {
+		Polygon big(_get_regular_polygon(Polygon::MERGED_AXES_MAX_SIZE, 10.0f), true);
+		THEN("Each edge normal is an axis.") {
+			CHECK_FALSE(big.hasMergedAxes());
+			CHECK(big.getNumAxes() == big.size());
+		}
+	}
+	GIVEN("A polygon with merged axes.") {
+		Polygon oct(shapes::octagon, true);
+		WHEN("It's extended into another polygon.") {
+			Polygon out;
+			oct.extend(Coord2(1, 0), 5.0f, out);
+			THEN("The extended polygon merges its own axes.") {
+				REQUIRE(out.hasMergedAxes());
+				CHECK(out.getNumAxes() < out.size());
+				for (std::size_t i = 0; i < out.size(); ++i) {
+					bool isCovered = false;
+					for (std::size_t k = 0; k < out.size(); ++k)
+						isCovered = isCovered || (out.isAxis(k) && math::areParallelAxes(out.getEdgeNorm(i), out.getEdgeNorm(k)));
+					CHECK(isCovered);
+				}
+			}
+		}
+	}
+}
+
+SCENARIO("Polygons on either side of the inline vertex storage size.", "[poly]") {
+	const std::vector<Coord2> small = _get_regular_polygon(Polygon::INLINE_SIZE - 1, 2);
+	const std::vector<Coord2> full = _get_regular_polygon(Polygon::INLINE_SIZE, 2);
+	const std::vector<Coord2> large = _get_regular_polygon(Polygon::INLINE_SIZE + 3, 2);
+	THEN("Their vertices, normals, and bounds are kept the same way.") {
+		for (const std::vector<Coord2>& vertices : {small, full, large}) {
+			INFO("Polygon with " << vertices.size() << " vertices.");
+			const Polygon p(vertices, true);
+			Polygon copy(p);
+			copy.translate(Coord2(1, 1));
+			REQUIRE(p.size() == vertices.size());
+			REQUIRE(copy.size() == vertices.size());
+			for (std::size_t i = 0; i < vertices.size(); ++i) {
+				CHECK(p[i] == vertices[i]);
+				CHECK(copy[i] == vertices[i] + Coord2(1, 1));
+				CHECK(copy.getEdgeNorm(i) == p.getEdgeNorm(i));
+			}
+			CHECK(copy.left() == ApproxEps(p.left() + 1));
+			CHECK(copy.bottom() == ApproxEps(p.bottom() + 1));
+		}
+	}
+	THEN("Computing their normals later, which may move them out of place, gives the same polygon.") {
+		const std::vector<Coord2> noNormalsFull = _get_regular_polygon(2 * Polygon::INLINE_SIZE, 2);
+		for (const std::vector<Coord2>& vertices : {small, full, large, noNormalsFull}) {
+			INFO("Polygon with " << vertices.size() << " vertices.");
+			const Polygon expected(vertices, true);
+			Polygon p(vertices);
+			const Polygon copy(p);
+			p.computeNormals();
+			REQUIRE(p.size() == vertices.size());
+			for (std::size_t i = 0; i < vertices.size(); ++i) {
+				CHECK(p[i] == vertices[i]);
+				CHECK(copy[i] == vertices[i]);
+				CHECK(p.getEdgeNorm(i) == expected.getEdgeNorm(i));
+				CHECK(p.isAxis(i) == expected.isAxis(i));
+			}
+			CHECK(p.getSupportIndex(Coord2(1, 0.3f)) == expected.getSupportIndex(Coord2(1, 0.3f)));
+			CHECK(p.right() == expected.right());
+		}
+	}
+	THEN("Extending them across the inline size keeps their vertices and normals.") {
+		for (const std::vector<Coord2>& vertices : {small, full}) {
+			INFO("Polygon with " << vertices.size() << " vertices.");
+			const Polygon p(vertices, true);
+			const Polygon extended = p.extend(Coord2(0.6f, 0.8f), 3);
+			REQUIRE(extended.size() == vertices.size() + 2);
+			std::vector<Coord2> extendedVertices;
+			for (std::size_t i = 0; i < extended.size(); ++i)
+				extendedVertices.push_back(extended[i]);
+			const Polygon expected(extendedVertices, true);
+			for (std::size_t i = 0; i < extended.size(); ++i) {
+				CHECK(extended.getEdgeNorm(i).x == ApproxEps(expected.getEdgeNorm(i).x));
+				CHECK(extended.getEdgeNorm(i).y == ApproxEps(expected.getEdgeNorm(i).y));
+			}
+			CHECK(extended.top() == ApproxEps(p.top()));
+			CHECK(extended.bottom() == ApproxEps(p.bottom() + 2.4f));
+		}
+	}
+}
+
+SCENARIO("Searching the vertices of a large polygon in a direction.", "[poly]") {
+	// A lopsided polygon, with a long flat side and unevenly spaced vertices on an elliptical arc.
+	std::vector<Coord2> dome;
+	for (int i = 0; i <= 20; ++i) {
+		const gFloat angle = constants::PI * static_cast<gFloat>(i * i) / 400.0f;
+		dome.emplace_back(-4 * std::cos(angle), 3 * std::sin(angle));
+	}
+	const std::vector<std::vector<Coord2>> vertexSets = {_get_regular_polygon(16, 2), _get_regular_polygon(24, 3, 0.1f),
+		_get_regular_polygon(64, 1.5f, 2.5f), _get_regular_polygon(128, 6, 1), dome};
+	// Plenty of arbitrary directions, plus directions lined up with each polygon's edges.
+	std::vector<Coord2> arbitraryDirs;
+	for (int i = 0; i < 720; ++i) {
+		const gFloat angle = constants::TAU * static_cast<gFloat>(i) / 720.0f;
+		arbitraryDirs.emplace_back(std::cos(angle), std::sin(angle));
+	}
+	const auto getDirs = [&arbitraryDirs](const Polygon& poly) {
+		std::vector<Coord2> dirs(arbitraryDirs);
+		for (std::size_t i = 0; i < poly.size(); ++i) {
+			const Coord2 norm = poly.getEdgeNorm(i);
+			dirs.insert(dirs.end(), {norm, -norm, norm.perpCCW(), norm.perpCW(), norm * 3.5f});
+		}
+		return dirs;
+	};
+	GIVEN("Large polygons with their normals computed, and the same polygons without them.") {
+		THEN("Searching gives the same results as checking every vertex.") {
+			for (const auto& vertices : vertexSets) {
+				const Polygon linear(vertices);
+				const Polygon searched(vertices, true);
+				REQUIRE(searched.size() >= Polygon::SUPPORT_TABLE_MIN_SIZE);
+				for (const Coord2 dir : getDirs(searched)) {
+					INFO("Polygon with " << searched.size() << " vertices, direction " << dir.x << ", " << dir.y);
+					CHECK(searched[searched.getSupportIndex(dir)].dot(dir) == ApproxEps(linear[linear.getSupportIndex(dir)].dot(dir)));
+					const Projection expectedProj = linear.getProjection(dir);
+					const Projection proj = searched.getProjection(dir);
+					CHECK(proj.min == ApproxEps(expectedProj.min));
+					CHECK(proj.max == ApproxEps(expectedProj.max));
+					const auto expected = linear.getVerticesInDirection(dir);
+					const auto result = searched.getVerticesInDirection(dir);
+					CHECK(result.first_index == expected.first_index);
+					CHECK(result.last_index == expected.last_index);
+					CHECK(result.is_first_edge_perpendicular == expected.is_first_edge_perpendicular);
+					CHECK(result.is_last_edge_perpendicular == expected.is_last_edge_perpendicular);
+				}
+			}
+		}
+		THEN("Extended polygons keep searching correctly.") {
+			// The extended polygon keeps its original edge normals, which can differ from recomputed ones by float error,
+			// so directions lined up with its edges could be classified differently.
+			for (const auto& vertices : vertexSets) {
+				const Polygon extended = Polygon(vertices, true).extend(Coord2(0.6f, 0.8f), 3);
+				std::vector<Coord2> extendedVertices;
+				for (std::size_t i = 0; i < extended.size(); ++i)
+					extendedVertices.push_back(extended[i]);
+				const Polygon extendedLinear(extendedVertices);
+				for (const Coord2 dir : arbitraryDirs) {
+					INFO("Extended polygon with " << extended.size() << " vertices, direction " << dir.x << ", " << dir.y);
+					const auto expected = extendedLinear.getVerticesInDirection(dir);
+					const auto result = extended.getVerticesInDirection(dir);
+					CHECK(result.first_index == expected.first_index);
+					CHECK(result.last_index == expected.last_index);
+				}
+			}
+		}
+	}
+	GIVEN("A small polygon.") {
+		Polygon oct(shapes::octagon, true);
+		THEN("Support queries find its farthest vertices.") {
+			CHECK(oct[oct.getSupportIndex(Coord2(0, 1))] == Coord2(0, 2));
+			CHECK(oct[oct.getSupportIndex(Coord2(-1, -1))] == Coord2(-1.5f, -1.5f));
+		}
+	}
+}
+
+SCENARIO("Benchmarking searches of large polygons' vertices.", "[.][benchmark][poly]") {
+	std::vector<Coord2> dirs;
+	for (int i = 0; i < 10000; ++i)
+		dirs.emplace_back(std::cos(static_cast<gFloat>(i) * 0.37f), std::sin(static_cast<gFloat>(i) * 0.37f));
+	const auto project = [&dirs](const Polygon& poly) {
+		gFloat total = 0;
+		for (const Coord2 dir : dirs)
+			total += poly.getProjection(dir).max;
+		return total;
+	};
+	const auto findRegions = [&dirs](const Polygon& poly) {
+		int total = 0;
+		for (const Coord2 dir : dirs)
+			total += poly.getVerticesInDirection(dir).first_index;
+		return total;
+	};
+	for (const std::size_t size : {8, 12, 16, 24, 64, 256}) {
+		const Polygon linear(_get_regular_polygon(size, 2));
+		const Polygon searched(_get_regular_polygon(size, 2), true);
+		const std::string name = std::to_string(size) + "-gon";
+		BENCHMARK("Linear: 10000 projections of a " + name) { project(linear); }
+		BENCHMARK("Search: 10000 projections of a " + name) { project(searched); }
+		BENCHMARK("Linear: 10000 regions of a " + name) { findRegions(linear); }
+		BENCHMARK("Search: 10000 regions of a " + name) { findRegions(searched); }
+	}
+}
+
+SCENARIO("Benchmarking polygon projections.", "[.][benchmark][poly]") {
+	std::vector<Coord2> axes;
+	for (int i = 0; i < 10000; ++i)
+		axes.emplace_back(std::cos(static_cast<gFloat>(i) * 0.37f), std::sin(static_cast<gFloat>(i) * 0.37f));
+	gFloat total = 0; // Keeps the results in use.
+	for (const std::size_t size : {8, 16, 32, 64}) {
+		const std::vector<Coord2> vertices(_get_regular_polygon(size, 2, 0.3f));
+		Polygon poly(vertices);
+		const std::string name = std::to_string(size) + "-gon";
+		// What getProjection did before vertices were stored as structure of arrays.
+		BENCHMARK("Array of structures: 10000 projections of a " + name) {
+			for (const Coord2 axis : axes) {
+				gFloat min = vertices[0].dot(axis);
+				gFloat max = min;
+				for (std::size_t i = 1; i < vertices.size(); ++i) {
+					const gFloat proj = vertices[i].dot(axis);
+					if (proj < min)
+						min = proj;
+					else if (proj > max)
+						max = proj;
+				}
+				total += max - min;
+			}
+		}
+		BENCHMARK("Structure of arrays: 10000 projections of a " + name) {
+			for (const Coord2 axis : axes) {
+				const Projection proj = poly.getProjection(axis);
+				total += proj.max - proj.min;
+			}
+		}
+		BENCHMARK("10000 translations of a " + name) {
+			for (int i = 0; i < 10000; ++i)
+				poly.translate(axes[static_cast<std::size_t>(i)]);
+		}
+		total += poly.left();
+	}
+	CHECK_FALSE(std::isnan(total));
+}
+
 SCENARIO("Extending a polygon.", "[poly]") {
 	GIVEN("A triangle.") {
 		Polygon tri(shapes::isoTri);
@@ -371,4 +645,76 @@ SCENARIO("A polygon is clip-extended: extended in a direction, and only the exte
 			REQUIRE(_polygons_equal(t, Polygon(extendSet, true)));
 		}
 	}
-}
\ No newline at end of file
+}
+static void _check_same_polygon(const Polygon& p, const Polygon& o) {
+	REQUIRE(p.size() == o.size());
+	for (std::size_t i = 0; i < p.size(); ++i) {
+		CHECK(p[i] == o[i]);
+		CHECK(p.getEdgeNorm(i) == o.getEdgeNorm(i));
+	}
+	CHECK(p.left() == o.left());
+	CHECK(p.right() == o.right());
+	CHECK(p.top() == o.top());
+	CHECK(p.bottom() == o.bottom());
+}
+
+SCENARIO("Extending polygons into a reused polygon.", "[poly]") {
+	const std::vector<Polygon> polygons{Polygon(shapes::tri, true), Polygon(shapes::octagon, true), Polygon(shapes::arb),
+		Polygon(_get_regular_polygon(20, 3, 0.2f), true), Polygon(shapes::rightTri, true), Polygon(_get_regular_polygon(40, 2))};
+	const std::vector<Coord2> dirs{Coord2(1, 0), Coord2(0.6f, -0.8f), Coord2(-1, 1).normalize()};
+	GIVEN("One polygon extended into over and over, from polygons of different sizes.") {
+		Polygon extended, clipExtended;
+		THEN("The results are the same as extending into new polygons.") {
+			for (const Polygon& p : polygons) {
+				for (const Coord2 dir : dirs) {
+					INFO("Polygon with " << p.size() << " vertices, extended in " << dir.x << ", " << dir.y);
+					p.extend(dir, 4, extended);
+					_check_same_polygon(extended, p.extend(dir, 4));
+					p.clipExtend(dir, 4, clipExtended);
+					_check_same_polygon(clipExtended, p.clipExtend(dir, 4));
+				}
+			}
+		}
+		THEN("Large results can be searched the same way as new polygons.") {
+			const Polygon& large = polygons[3];
+			large.extend(Coord2(0, 1), 5, extended);
+			const Polygon expected(large.extend(Coord2(0, 1), 5));
+			for (const Coord2 dir : dirs) {
+				CHECK(extended.getSupportIndex(dir) == expected.getSupportIndex(dir));
+				CHECK(extended.getProjection(dir).min == expected.getProjection(dir).min);
+				CHECK(extended.getProjection(dir).max == expected.getProjection(dir).max);
+			}
+		}
+	}
+}
+
+SCENARIO("Benchmarking extending polygons into a reused polygon.", "[.][benchmark][poly]") {
+	const Polygon octagon(shapes::octagon, true);
+	const Polygon large(_get_regular_polygon(24, 3), true);
+	std::vector<Coord2> dirs;
+	for (int i = 0; i < 1000; ++i)
+		dirs.push_back(Coord2(std::cos(static_cast<gFloat>(i)), std::sin(static_cast<gFloat>(i))));
+	std::size_t vertices(0);
+	Polygon extended;
+	BENCHMARK("Extending an octagon 1000 times into new polygons") {
+		for (const Coord2 dir : dirs)
+			vertices += octagon.extend(dir, 5).size();
+	}
+	BENCHMARK("Extending an octagon 1000 times into a reused polygon") {
+		for (const Coord2 dir : dirs) {
+			octagon.extend(dir, 5, extended);
+			vertices += extended.size();
+		}
+	}
+	BENCHMARK("Extending a 24-gon 1000 times into new polygons") {
+		for (const Coord2 dir : dirs)
+			vertices += large.extend(dir, 5).size();
+	}
+	BENCHMARK("Extending a 24-gon 1000 times into a reused polygon") {
+		for (const Coord2 dir : dirs) {
+			large.extend(dir, 5, extended);
+			vertices += extended.size();
+		}
+	}
+	CHECK(vertices > 0);
+}
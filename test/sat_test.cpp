@@ -2,6 +2,9 @@
 #include "definitions.hpp"
 #include "../geom/intersections/sat.hpp"
 
+#include <utility>
+#include <vector>
+
 using namespace ctp;
 
 SCENARIO("Finding the separating axes for two shapes.", "[sat]") {
@@ -124,4 +127,151 @@ SCENARIO("Finding the separating axes for two shapes.", "[sat]") {
 				CHECK(axes.size() == expected);
 		}
 	}
-}
\ No newline at end of file
+}
+SCENARIO("Finding separating axes into a fixed-capacity buffer.", "[sat]") {
+	const Rect r(0, 0, 2, 1);
+	const Circle c(1.5f);
+	const Polygon octagon(shapes::octagon);
+	const Polygon tri(shapes::tri);
+	const Polygon circlePoly(Circle(2).toPoly());
+	const std::vector<ConstShapeRef> shapes{r, c, octagon, tri, circlePoly};
+	GIVEN("Each pair of shapes.") {
+		THEN("The buffer holds the same axes as the vector version.") {
+			sat::AxisBuffer buffer;
+			for (const ConstShapeRef first : shapes) {
+				for (const ConstShapeRef second : shapes) {
+					const Coord2 offset(0.75f, -0.5f);
+					const std::vector<Coord2> axes(sat::getSeparatingAxes(first, second, offset));
+					sat::getSeparatingAxes(first, second, offset, buffer); // Reused, so it must replace its previous contents.
+					REQUIRE(buffer.size() == axes.size());
+					for (std::size_t i = 0; i < axes.size(); ++i)
+						CHECK(buffer[i] == axes[i]);
+				}
+			}
+		}
+	}
+	GIVEN("A pair with more axes than fit inline.") {
+		const std::size_t expected(circlePoly.size() * 2);
+		REQUIRE(expected > sat::AxisBuffer::INLINE_CAPACITY);
+		THEN("The buffer spills onto the heap, keeping its axes in order.") {
+			sat::AxisBuffer buffer;
+			sat::getSeparatingAxes(circlePoly, circlePoly, Coord2(0, 0), buffer);
+			REQUIRE(buffer.size() == expected);
+			for (std::size_t i = 0; i < circlePoly.size(); ++i) {
+				CHECK(buffer[i] == circlePoly.getEdgeNorm(i));
+				CHECK(buffer[i + circlePoly.size()] == circlePoly.getEdgeNorm(i));
+			}
+			CHECK(static_cast<std::size_t>(buffer.end() - buffer.begin()) == expected);
+		}
+	}
+}
+SCENARIO("Pairs with merged polygon axes skip the axes they share.", "[sat]") {
+	const Rect r(0, 0, 2, 1);
+	Polygon octagon(shapes::octagon);
+	Polygon rectPoly(Rect(-1, -1, 3, 2).toPoly());
+	Polygon tri(shapes::tri);
+	Polygon rightTri(shapes::rightTri);
+	GIVEN("Polygons without their normals computed.") {
+		THEN("Pairs have every axis from both shapes.") {
+			CHECK(sat::getSeparatingAxes(rectPoly, r).size() == rectPoly.size() + separating_axes::RECT_NUM_AXES);
+			CHECK(sat::getSeparatingAxes(tri, rightTri).size() == tri.size() + rightTri.size());
+		}
+	}
+	GIVEN("Polygons with their normals computed.") {
+		for (Polygon* p : {&octagon, &rectPoly, &tri, &rightTri})
+			p->computeNormals();
+		THEN("Their parallel axes are only tested once.") {
+			CHECK(sat::getSeparatingAxes(octagon, octagon).size() == 4);
+			CHECK(sat::getSeparatingAxes(octagon, r).size() == 4 + separating_axes::RECT_NUM_AXES);
+		}
+		THEN("Axes shared with the other shape are skipped, in either order.") {
+			CHECK(sat::getSeparatingAxes(rectPoly, r).size() == 2);
+			CHECK(sat::getSeparatingAxes(r, rectPoly).size() == 2);
+			// The triangles each have an edge with a slope of one.
+			CHECK(sat::getSeparatingAxes(tri, rightTri).size() == tri.size() + rightTri.size() - 1);
+			CHECK(sat::getSeparatingAxes(rightTri, tri).size() == tri.size() + rightTri.size() - 1);
+			// Only one of the shapes needs to merge its axes.
+			const Polygon plainTri(shapes::tri);
+			CHECK(sat::getSeparatingAxes(plainTri, rightTri).size() == tri.size() + rightTri.size() - 1);
+		}
+	}
+	GIVEN("The same polygons, with and without merged axes.") {
+		const Polygon plainOctagon(shapes::octagon), plainRectPoly(rectPoly), plainTri(shapes::tri);
+		const Circle c(1.0f);
+		for (Polygon* p : {&octagon, &rectPoly, &tri})
+			p->computeNormals();
+		const std::vector<std::pair<ConstShapeRef, ConstShapeRef>> shapes{
+			{octagon, plainOctagon}, {rectPoly, plainRectPoly}, {tri, plainTri}, {r, r}, {c, c}};
+		THEN("SAT tests give the same results.") {
+			Coord2 norm, plainNorm;
+			gFloat dist, plainDist;
+			for (const auto& first : shapes) {
+				for (const auto& second : shapes) {
+					for (int i = 0; i < 100; ++i) {
+						const Coord2 pos(static_cast<gFloat>(i % 10) * 0.5f - 2.5f, static_cast<gFloat>(i / 10) * 0.5f - 2.5f);
+						CHECK(sat::overlaps(first.first, pos, second.first, Coord2(0, 0)) ==
+							sat::overlaps(first.second, pos, second.second, Coord2(0, 0)));
+						const bool isOverlapping(sat::overlaps(first.first, pos, second.first, Coord2(0, 0), norm, dist));
+						REQUIRE(isOverlapping == sat::overlaps(first.second, pos, second.second, Coord2(0, 0), plainNorm, plainDist));
+						if (isOverlapping) { // Symmetric shapes can tie on several axes, and each pair tests them in its own order.
+							CHECK(dist == ApproxEps(plainDist));
+							CHECK_FALSE(sat::overlaps(first.first, pos + norm * dist, second.first, Coord2(0, 0)));
+						}
+						const CollisionResult result(sat::collides(first.first, pos * 2.0f, -pos, second.first, Coord2(0, 0), norm, dist));
+						REQUIRE(result == sat::collides(first.second, pos * 2.0f, -pos, second.second, Coord2(0, 0), plainNorm, plainDist));
+						if (result == CollisionResult::MinimumTranslationVector) {
+							CHECK(dist == ApproxEps(plainDist));
+							CHECK_FALSE(sat::overlaps(first.first, pos * 2.0f + norm * dist, second.first, Coord2(0, 0)));
+						} else if (result == CollisionResult::Sweep) {
+							CHECK(dist == ApproxEps(plainDist));
+							CHECK(norm.x == ApproxEps(plainNorm.x));
+							CHECK(norm.y == ApproxEps(plainNorm.y));
+						}
+					}
+				}
+			}
+		}
+	}
+}
+
+SCENARIO("Finding the minimum translation vector for a shape contained in another.", "[sat]") {
+	const Rect small(0, 0, 1, 1);
+	const Coord2 pos(1, 4.5f); // Nearer the left side of the larger shape than any other.
+	Coord2 norm;
+	gFloat dist;
+	GIVEN("A larger rectangle.") {
+		const Rect large(0, 0, 10, 10);
+		THEN("Each axis pushes out the side the smaller shape's projection starts on.") {
+			REQUIRE(sat::overlaps(small, pos, large, Coord2(0, 0), norm, dist));
+			CHECK(norm.x == ApproxEps(0));
+			CHECK(norm.y == ApproxEps(1));
+			CHECK(dist == ApproxEps(5.5f));
+			REQUIRE(sat::collides(small, pos, Coord2(0, 0), large, Coord2(0, 0), norm, dist) == CollisionResult::MinimumTranslationVector);
+			CHECK(norm.x == ApproxEps(0));
+			CHECK(norm.y == ApproxEps(1));
+			CHECK(dist == ApproxEps(5.5f));
+		}
+	}
+	GIVEN("A larger polygon, with and without merged axes.") {
+		Polygon plain(Rect(0, 0, 10, 10).toPoly());
+		Polygon merged(Rect(0, 0, 10, 10).toPoly());
+		merged.computeNormals();
+		REQUIRE(merged.hasMergedAxes());
+		THEN("Its opposite sides push out the nearer side.") {
+			for (const Polygon* large : {&plain, &merged}) {
+				REQUIRE(sat::overlaps(small, pos, *large, Coord2(0, 0), norm, dist));
+				CHECK(norm.x == ApproxEps(-1));
+				CHECK(norm.y == ApproxEps(0));
+				CHECK(dist == ApproxEps(2));
+				REQUIRE(sat::overlaps(*large, Coord2(0, 0), small, pos, norm, dist));
+				CHECK(norm.x == ApproxEps(1));
+				CHECK(norm.y == ApproxEps(0));
+				CHECK(dist == ApproxEps(2));
+				REQUIRE(sat::collides(small, pos, Coord2(0, 0), *large, Coord2(0, 0), norm, dist) == CollisionResult::MinimumTranslationVector);
+				CHECK(norm.x == ApproxEps(-1));
+				CHECK(norm.y == ApproxEps(0));
+				CHECK(dist == ApproxEps(2));
+			}
+		}
+	}
+}
@@ -0,0 +1,170 @@
+#include "catch.hpp"
+#include "definitions.hpp"
+
+#include <cmath>
+
+using namespace ctp;
+
+SCENARIO("Caching separating axes between tests.", "[SeparatingAxisCache][overlaps]") {
+	SeparatingAxisCache cache;
+	Polygon first(shapes::octagon);
+	Polygon second(shapes::arb);
+	GIVEN("An empty cache.") {
+		THEN("It has no pairs or tests.") {
+			CHECK(cache.size() == 0);
+			CHECK(cache.hits() == 0);
+			CHECK(cache.misses() == 0);
+			CHECK(cache.hitRate() == 0);
+		}
+	}
+	GIVEN("Two separated shapes.") {
+		const Coord2 firstPos(0, 0), secondPos(10, 0);
+		WHEN("They are tested once.") {
+			CHECK_FALSE(overlaps(first, firstPos, second, secondPos, cache));
+			THEN("It is a miss, and their separating axis is cached.") {
+				CHECK(cache.size() == 1);
+				CHECK(cache.hits() == 0);
+				CHECK(cache.misses() == 1);
+			}
+			AND_WHEN("They are tested again after moving a little.") {
+				CHECK_FALSE(overlaps(first, firstPos + Coord2(0.5f, 0.5f), second, secondPos, cache));
+				THEN("It is a hit.") {
+					CHECK(cache.hits() == 1);
+					CHECK(cache.misses() == 1);
+					CHECK(cache.hitRate() == Approx(0.5));
+				}
+			}
+			AND_WHEN("They are tested in the other order.") {
+				CHECK_FALSE(overlaps(second, secondPos, first, firstPos, cache));
+				THEN("They share the cached axis.") {
+					CHECK(cache.size() == 1);
+					CHECK(cache.hits() == 1);
+				}
+			}
+			AND_WHEN("They move so that the cached axis no longer separates them.") {
+				THEN("It is a miss, and the test is still correct.") {
+					CHECK(overlaps(first, Coord2(9, 0), second, secondPos, cache));
+					CHECK(cache.misses() == 2);
+					CHECK_FALSE(overlaps(first, Coord2(9, 10), second, secondPos, cache));
+					CHECK(cache.misses() == 3);
+					CHECK(cache.size() == 1);
+				}
+			}
+			AND_WHEN("Statistics are reset.") {
+				cache.resetStats();
+				THEN("The cached pairs are kept.") {
+					CHECK(cache.hits() == 0);
+					CHECK(cache.misses() == 0);
+					CHECK(cache.size() == 1);
+				}
+			}
+			AND_WHEN("The pair is erased.") {
+				cache.erase(second, first);
+				CHECK(cache.size() == 0);
+				THEN("The next test is a miss.") {
+					CHECK_FALSE(overlaps(first, firstPos, second, secondPos, cache));
+					CHECK(cache.misses() == 2);
+				}
+			}
+			AND_WHEN("The cache is cleared.") {
+				cache.clear();
+				THEN("The statistics are kept.") {
+					CHECK(cache.size() == 0);
+					CHECK(cache.misses() == 1);
+				}
+			}
+		}
+	}
+	GIVEN("Two overlapping shapes.") {
+		Coord2 norm;
+		gFloat dist;
+		REQUIRE(overlaps(first, Coord2(0, 0), second, Coord2(1, 0), norm, dist, cache));
+		THEN("Their minimum axis is cached, so they are ruled out quickly once separated along it.") {
+			CHECK(cache.size() == 1);
+			CHECK_FALSE(overlaps(first, norm * (dist + 0.5f), second, Coord2(1, 0), cache));
+			CHECK(cache.hits() == 1);
+		}
+	}
+}
+
+SCENARIO("Cached tests agree with uncached tests.", "[SeparatingAxisCache][overlaps][collisions]") {
+	const Rect rect(0, 0, 2, 1);
+	const Polygon octagon(shapes::octagon);
+	const Polygon tri(shapes::tri);
+	const Circle circle(1.5f);
+	const std::vector<ConstShapeRef> shapes{rect, octagon, tri, circle};
+	SeparatingAxisCache overlapCache, mtvCache, collideCache;
+	const Coord2 secondPos(0.5f, -0.25f);
+	GIVEN("Each pair of shapes, with the first shape circling the second over many steps.") {
+		for (const ConstShapeRef firstShape : shapes) {
+			for (const ConstShapeRef secondShape : shapes) {
+				for (int step = 0; step < 200; ++step) {
+					const gFloat angle(static_cast<gFloat>(step) * 0.05f);
+					const gFloat radius(1.5f + 2.5f * std::sin(static_cast<gFloat>(step) * 0.11f));
+					const Coord2 firstPos(radius * std::cos(angle), radius * std::sin(angle));
+					const Coord2 delta(-std::sin(angle), std::cos(angle) * 0.5f);
+					INFO("Step " << step << " between " << static_cast<int>(firstShape.type()) << " and " << static_cast<int>(secondShape.type()));
+
+					CHECK(overlaps(firstShape, firstPos, secondShape, secondPos, overlapCache) ==
+						overlaps(firstShape, firstPos, secondShape, secondPos));
+
+					Coord2 norm, cachedNorm;
+					gFloat dist(0), cachedDist(0);
+					const bool isOverlapping(overlaps(firstShape, firstPos, secondShape, secondPos, norm, dist));
+					REQUIRE(overlaps(firstShape, firstPos, secondShape, secondPos, cachedNorm, cachedDist, mtvCache) == isOverlapping);
+					if (isOverlapping) {
+						CHECK(cachedNorm == norm);
+						CHECK(cachedDist == dist);
+					}
+
+					gFloat t(0), cachedT(0);
+					const CollisionResult result(collides(firstShape, firstPos, delta, secondShape, secondPos, norm, t));
+					REQUIRE(collides(firstShape, firstPos, delta, secondShape, secondPos, cachedNorm, cachedT, collideCache) == result);
+					if (result != CollisionResult::None) {
+						CHECK(cachedNorm == norm);
+						CHECK(cachedT == t);
+					}
+				}
+			}
+		}
+		THEN("Every test is counted, and many are ruled out by a cached axis.") {
+			CHECK(overlapCache.hits() + overlapCache.misses() == shapes.size() * shapes.size() * 200);
+			CHECK(overlapCache.hitRate() > 0.25);
+			CHECK(mtvCache.hitRate() > 0.25);
+			CHECK(collideCache.hits() > 0);
+		}
+	}
+}
+
+SCENARIO("Benchmarking cached separating axis tests.", "[.][benchmark][SeparatingAxisCache]") {
+	// A field of polygons, each tested against its neighbours every frame while drifting slightly.
+	std::vector<Polygon> polygons;
+	std::vector<Coord2> positions;
+	for (int i = 0; i < 1000; ++i) {
+		polygons.emplace_back(i % 2 == 0 ? shapes::octagon : shapes::arb);
+		positions.emplace_back(static_cast<gFloat>(i % 40) * 4.5f, static_cast<gFloat>(i / 40) * 4.5f);
+	}
+	const auto runFrames = [&](SeparatingAxisCache* cache) {
+		int overlapping(0);
+		for (int frame = 0; frame < 10; ++frame) {
+			const Coord2 drift(std::sin(static_cast<gFloat>(frame)) * 0.5f, std::cos(static_cast<gFloat>(frame)) * 0.5f);
+			for (std::size_t i = 0; i < polygons.size(); ++i) {
+				for (std::size_t k = i + 1; k < polygons.size() && k <= i + 41; ++k) {
+					const Coord2 firstPos(positions[i] + (i % 3 == 0 ? drift : Coord2(0, 0)));
+					const bool isOverlapping(cache ? overlaps(polygons[i], firstPos, polygons[k], positions[k], *cache)
+					                               : overlaps(polygons[i], firstPos, polygons[k], positions[k]));
+					overlapping += isOverlapping ? 1 : 0;
+				}
+			}
+		}
+		return overlapping;
+	};
+	BENCHMARK("10 frames of 41k pairs without a cache") {
+		runFrames(nullptr);
+	}
+	SeparatingAxisCache cache;
+	BENCHMARK("10 frames of 41k pairs with a cache") {
+		runFrames(&cache);
+	}
+	WARN("Cache hit rate: " << cache.hitRate());
+}
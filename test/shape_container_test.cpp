@@ -1,6 +1,11 @@
 #include "catch.hpp"
 #include "definitions.hpp"
 
+#include <cstring>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
 using namespace ctp;
 
 SCENARIO("Copying and moving shape containers around.", "[ShapeContainer]") {
@@ -159,3 +164,107 @@ SCENARIO("In place construction.", "[ShapeContainer]") {
 		}
 	}
 }
+
+SCENARIO("Rectangles and circles are plain data.", "[ShapeContainer]") {
+	GIVEN("Arrays of rectangles and circles.") {
+		const Rect rects[2] = {Rect(1, 2, 3, 4), Rect(-1, -2, 5, 6)};
+		const Circle circles[2] = {Circle(1, 2, 3), Circle(-4, 5, 6)};
+		WHEN("They are copied byte for byte.") {
+			Rect rectCopies[2];
+			Circle circleCopies[2];
+			std::memcpy(rectCopies, rects, sizeof(rects));
+			std::memcpy(circleCopies, circles, sizeof(circles));
+			THEN("The copies are the same shapes.") {
+				CHECK(sizeof(Rect) == 4 * sizeof(gFloat));
+				for (std::size_t i = 0; i < 2; ++i) {
+					CHECK(rectCopies[i] == rects[i]);
+					CHECK(circleCopies[i].center == circles[i].center);
+					CHECK(circleCopies[i].radius == circles[i].radius);
+				}
+			}
+		}
+	}
+}
+
+SCENARIO("Using shapes through references.", "[ShapeContainer]") {
+	GIVEN("A circle in a ShapeContainer.") {
+		ShapeContainer container{Circle{1, 2, 3}};
+		const ShapeRef ref(container);
+		const ConstShapeRef constRef(container);
+		THEN("References to it refer to the contained circle.") {
+			CHECK(ref.type() == ShapeType::Circle);
+			CHECK(constRef.type() == ShapeType::Circle);
+			CHECK(ref.address() == &container.circle());
+			CHECK(constRef.address() == &container.circle());
+			CHECK(ConstShapeRef(ref).address() == &container.circle());
+		}
+		THEN("A new ShapeContainer can be made from a reference.") {
+			const ShapeContainer copy(constRef);
+			CHECK(copy.type() == ShapeType::Circle);
+			CHECK(copy.circle().center == Coord2(1, 2));
+			CHECK(copy.circle().radius == 3);
+		}
+		THEN("Shape functions are dispatched to the circle.") {
+			const Rect aabb(getAABB(constRef));
+			CHECK(aabb.left() == ApproxEps(-2));
+			CHECK(aabb.top() == ApproxEps(-1));
+			CHECK(aabb.w == ApproxEps(6));
+			CHECK(aabb.h == ApproxEps(6));
+			const Projection proj(getProjection(constRef, Coord2(1, 0)));
+			CHECK(proj.min == ApproxEps(-2));
+			CHECK(proj.max == ApproxEps(4));
+			CHECK(toPoly(constRef).size() == Circle::SEGS_IN_POLY);
+		}
+	}
+	GIVEN("A rectangle and a polygon.") {
+		const Rect rect(1, 2, 3, 4);
+		const Polygon poly(shapes::octagon);
+		THEN("Shape functions are dispatched to each.") {
+			CHECK(getAABB(rect) == rect);
+			CHECK(getAABB(poly).left() == ApproxEps(-2));
+			CHECK(getAABB(poly).bottom() == ApproxEps(2));
+			CHECK(getProjection(rect, Coord2(0, 1)).max == ApproxEps(6));
+			CHECK(getProjection(poly, Coord2(0, 1)).max == ApproxEps(2));
+			CHECK(getClosestTo(rect, Coord2(10, 10)) == rect.bottomRight());
+			CHECK(toPoly(rect).size() == 4);
+			CHECK(toPoly(poly).size() == poly.size());
+		}
+	}
+	GIVEN("A polygon in a pool.") {
+		PolygonPool pool;
+		const PolygonPool::Handle handle = pool.add(shapes::octagon);
+		const ShapeContainer container(pool.get(handle));
+		THEN("Containers and references hold its handle.") {
+			CHECK(container.type() == ShapeType::PooledPolygon);
+			CHECK(container.pooled().handle() == handle);
+			CHECK(&container.pooled().pool() == &pool);
+			CHECK(ConstShapeRef(container).address() == ConstShapeRef(pool.get(handle)).address());
+			const ShapeContainer copy(container);
+			CHECK(copy.type() == ShapeType::PooledPolygon);
+			CHECK(copy.address() == container.address());
+		}
+		THEN("Shape functions are dispatched to the pooled polygon.") {
+			CHECK(getAABB(container).left() == ApproxEps(-2));
+			CHECK(getAABB(container).bottom() == ApproxEps(2));
+			CHECK(getProjection(container, Coord2(0, 1)).max == ApproxEps(2));
+			CHECK(toPoly(container).size() == shapes::octagon.size());
+		}
+	}
+}
+
+SCENARIO("Shape containers stay small.", "[ShapeContainer]") {
+	THEN("Pooled polygon handles are plain data.")
+		CHECK(std::is_trivially_copyable_v<PooledPolygon>);
+	THEN("Polygons are kept in place, and containers add little to them.")
+		CHECK(sizeof(ShapeContainer) <= sizeof(Polygon) + 2 * sizeof(ConstShapeRef));
+	THEN("Moving containers doesn't throw, but copying them may allocate.") {
+		CHECK(std::is_nothrow_move_constructible_v<ShapeContainer>);
+		CHECK(std::is_nothrow_move_assignable_v<ShapeContainer>);
+		CHECK(std::is_nothrow_constructible_v<ShapeContainer, Polygon&&>);
+		CHECK_FALSE(std::is_nothrow_copy_constructible_v<ShapeContainer>);
+		CHECK_FALSE(std::is_nothrow_copy_assignable_v<ShapeContainer>);
+		CHECK_FALSE(std::is_nothrow_constructible_v<ShapeContainer, ConstShapeRef>);
+		CHECK_FALSE(std::is_nothrow_constructible_v<ShapeContainer, std::in_place_type_t<Polygon>, std::vector<Coord2>>);
+		CHECK(std::is_nothrow_constructible_v<ShapeContainer, std::in_place_type_t<Circle>, gFloat>);
+	}
+}
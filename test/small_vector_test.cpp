@@ -0,0 +1,85 @@
+#include "catch.hpp"
+#include "definitions.hpp"
+#include "../geom/small_vector.hpp"
+
+using namespace ctp;
+
+SCENARIO("Storing values in a small vector.", "[SmallVector]") {
+	SmallVector<int, 4> values;
+	GIVEN("An empty small vector.") {
+		THEN("It has no values.") {
+			CHECK(values.empty());
+			CHECK(values.size() == 0);
+			CHECK(values.begin() == values.end());
+		}
+	}
+	GIVEN("A small vector with values that fit inline.") {
+		for (int i = 0; i < 4; ++i)
+			values.push_back(i);
+		THEN("They are kept in order.") {
+			REQUIRE(values.size() == 4);
+			for (int i = 0; i < 4; ++i)
+				CHECK(values[i] == i);
+		}
+		WHEN("It grows past its inline capacity.") {
+			values.push_back(4);
+			values.push_back(5);
+			THEN("The values are moved to the heap, and stay in order.") {
+				REQUIRE(values.size() == 6);
+				for (int i = 0; i < 6; ++i)
+					CHECK(values[i] == i);
+				CHECK(values.end() - values.begin() == 6);
+			}
+			AND_WHEN("It is copied.") {
+				SmallVector<int, 4> copy(values);
+				copy[0] = 10;
+				THEN("The copy has its own values.") {
+					CHECK(copy.size() == 6);
+					CHECK(copy[0] == 10);
+					CHECK(copy[5] == 5);
+					CHECK(values[0] == 0);
+				}
+			}
+			AND_WHEN("It is used as a stack, popping back into its inline storage.") {
+				for (int i = 5; i >= 0; --i) {
+					REQUIRE(values.back() == i);
+					values.pop_back();
+					REQUIRE(values.size() == static_cast<std::size_t>(i));
+				}
+				THEN("It is empty, and pushes go inline again.") {
+					CHECK(values.empty());
+					values.push_back(8);
+					CHECK(values.back() == 8);
+				}
+			}
+			AND_WHEN("It is resized to fit inline again.") {
+				values.resize(3);
+				THEN("The remaining values are kept.") {
+					REQUIRE(values.size() == 3);
+					for (int i = 0; i < 3; ++i)
+						CHECK(values[i] == i);
+				}
+			}
+		}
+		WHEN("It is resized.") {
+			values.resize(2);
+			values.resize(7, -1);
+			THEN("New values are filled in.") {
+				REQUIRE(values.size() == 7);
+				CHECK(values[0] == 0);
+				CHECK(values[1] == 1);
+				for (std::size_t i = 2; i < 7; ++i)
+					CHECK(values[i] == -1);
+			}
+		}
+		WHEN("It is cleared.") {
+			values.clear();
+			THEN("It is empty, and can be reused.") {
+				CHECK(values.empty());
+				values.push_back(7);
+				CHECK(values.size() == 1);
+				CHECK(values[0] == 7);
+			}
+		}
+	}
+}
@@ -0,0 +1,222 @@
+#include "catch.hpp"
+#include "definitions.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <memory>
+
+using namespace ctp;
+
+namespace {
+// A grid of unit squares with gaps between them.
+std::vector<std::unique_ptr<Wall>> makeWallGrid(int columns, int rows) {
+	std::vector<std::unique_ptr<Wall>> walls;
+	walls.reserve(static_cast<std::size_t>(columns) * rows);
+	for (int y = 0; y < rows; ++y) {
+		for (int x = 0; x < columns; ++x)
+			walls.push_back(std::make_unique<Wall>(Rect(0, 0, 1, 1), Coord2(static_cast<gFloat>(x * 2), static_cast<gFloat>(y * 2))));
+	}
+	return walls;
+}
+
+// Fans of rays from a few origins.
+std::vector<Ray> makeRayFans(const std::vector<Coord2>& origins, int raysPerOrigin) {
+	std::vector<Ray> rays;
+	for (int i = 0; i < raysPerOrigin; ++i) {
+		const gFloat angle(static_cast<gFloat>(i) * 6.2831853f / static_cast<gFloat>(raysPerOrigin));
+		for (const Coord2 origin : origins) // Interleave origins, so the batch has to group them itself.
+			rays.push_back(Ray{origin, Coord2(std::cos(angle), std::sin(angle))});
+	}
+	return rays;
+}
+
+std::vector<Collidable*> getPointers(const std::vector<std::unique_ptr<Wall>>& walls) {
+	std::vector<Collidable*> collidables;
+	collidables.reserve(walls.size());
+	for (const auto& wall : walls)
+		collidables.push_back(wall.get());
+	return collidables;
+}
+}
+
+SCENARIO("Finding collidables in a static BVH collision map.", "[StaticBVHCollisionMap]") {
+	Wall left(Rect(0, 0, 5, 5), Coord2(10, 10));
+	Wall right(Rect(0, 0, 5, 5), Coord2(80, 10));
+	Wall far(Circle(2), Coord2(50, 90));
+	std::vector<std::unique_ptr<Wall>> filler; // Enough walls that the tree has branches.
+	std::vector<Collidable*> collidables{&left, &right, &far};
+	for (int i = 0; i < 20; ++i) {
+		filler.push_back(std::make_unique<Wall>(Rect(0, 0, 1, 1), Coord2(static_cast<gFloat>(i * 5), 150)));
+		collidables.push_back(filler.back().get());
+	}
+	const StaticBVHCollisionMap map(collidables);
+	MovableTest mover(Movable::CollisionType::Deflect, ShapeContainer(Circle(1)), Coord2(12, 12));
+	CHECK(map.size() == 23);
+	CHECK(map.height() > 1);
+	GIVEN("A collider that is stationary.") {
+		WHEN("It is only near one collidable.") {
+			const auto colliding = map.getColliding(mover);
+			THEN("Only that collidable is found.") {
+				CHECK(colliding.size() == 1);
+				CHECK(contains(colliding, &left));
+			}
+		}
+		WHEN("It is far from all collidables.") {
+			mover.position = Coord2(50, 50);
+			THEN("Nothing is found.")
+				CHECK(map.getColliding(mover).empty());
+		}
+	}
+	GIVEN("A collider that is moving.") {
+		WHEN("It sweeps across two collidables.") {
+			const auto colliding = map.getColliding(mover, Coord2(70, 0));
+			THEN("Both are found.") {
+				CHECK(colliding.size() == 2);
+				CHECK(contains(colliding, &left));
+				CHECK(contains(colliding, &right));
+			}
+		}
+		WHEN("It queries from a different position than its own.") {
+			const auto colliding = map.getColliding(mover, Coord2(50, 87), Coord2(0, 0));
+			THEN("The given position is used.") {
+				CHECK(colliding.size() == 1);
+				CHECK(contains(colliding, &far));
+			}
+		}
+	}
+	GIVEN("An empty map.") {
+		const StaticBVHCollisionMap empty;
+		THEN("Nothing is found.") {
+			CHECK(empty.getColliding(mover, Coord2(100, 100)).empty());
+			CHECK(empty.height() == 0);
+		}
+	}
+}
+
+SCENARIO("Building a large static BVH collision map on multiple threads.", "[StaticBVHCollisionMap]") {
+	const auto walls = makeWallGrid(320, 320);
+	const auto collidables = getPointers(walls);
+	REQUIRE(collidables.size() >= StaticBVHCollisionMap::PARALLEL_BUILD_THRESHOLD);
+	const StaticBVHCollisionMap serial(collidables, 1);
+	const StaticBVHCollisionMap parallel(collidables, 4);
+	THEN("It builds the same tree as a single thread.") {
+		CHECK(parallel.size() == collidables.size());
+		CHECK(parallel.nodeCount() == serial.nodeCount());
+		CHECK(parallel.height() == serial.height());
+	}
+	THEN("It finds the same collidables as a brute force search.") {
+		MovableTest mover(Movable::CollisionType::Deflect, ShapeContainer(Rect(0, 0, 1.5f, 1.5f)), Coord2(100.5f, 200.5f));
+		const Coord2 deltas[] = {Coord2(0, 0), Coord2(10, 0), Coord2(-7, 13), Coord2(0.25f, 0.25f)};
+		for (const Coord2 delta : deltas) {
+			const broadphase::AABB query(broadphase::sweep(broadphase::getAABB(mover), delta));
+			std::vector<Collidable*> expected;
+			for (Collidable* c : collidables) {
+				if (broadphase::overlaps(broadphase::getAABB(*c), query))
+					expected.push_back(c);
+			}
+			auto colliding = parallel.getColliding(mover, delta);
+			std::sort(expected.begin(), expected.end());
+			std::sort(colliding.begin(), colliding.end());
+			CHECK(colliding == expected);
+		}
+	}
+}
+
+SCENARIO("Raycasting batches of rays against a static BVH collision map.", "[StaticBVHCollisionMap][raycast]") {
+	const auto walls = makeWallGrid(40, 40);
+	const StaticBVHCollisionMap map(getPointers(walls));
+	const std::vector<Ray> rays(makeRayFans({Coord2(10.5f, 10.5f), Coord2(41, 60.2f), Coord2(-10, 30)}, 100));
+	std::vector<gFloat> maxTs;
+	for (std::size_t i = 0; i < rays.size(); ++i)
+		maxTs.push_back(i % 5 == 0 ? 2.0f : 30.0f); // Some rays are too short to hit anything.
+	std::vector<RaycastHit> hits;
+	map.raycast(rays, maxTs, hits);
+	THEN("Each ray has the same hit as when cast on its own.") {
+		REQUIRE(hits.size() == rays.size());
+		for (std::size_t i = 0; i < rays.size(); ++i) {
+			const RaycastHit expected(map.raycast(rays[i], maxTs[i]));
+			CHECK(hits[i].collidable == expected.collidable);
+			CHECK(hits[i].t == ApproxEps(expected.t));
+			CHECK(hits[i].normal.x == ApproxEps(expected.normal.x));
+			CHECK(hits[i].normal.y == ApproxEps(expected.normal.y));
+		}
+	}
+	THEN("Rays hit and miss.") {
+		CHECK(std::any_of(hits.begin(), hits.end(), [](const RaycastHit& h) { return !h; }));
+		CHECK(std::any_of(hits.begin(), hits.end(), [](const RaycastHit& h) { return h && h.t > 0; }));
+	}
+	GIVEN("An empty batch.") {
+		map.raycast({}, {}, hits);
+		THEN("There are no hits.")
+			CHECK(hits.empty());
+	}
+	GIVEN("Fewer maximum distances than rays.") {
+		const std::vector<gFloat> fewerMaxTs(maxTs.begin(), maxTs.begin() + maxTs.size() / 2);
+		map.raycast(rays, fewerMaxTs, hits);
+		THEN("Only the rays with a maximum distance are cast.") {
+			REQUIRE(hits.size() == rays.size());
+			for (std::size_t i = 0; i < rays.size(); ++i) {
+				const RaycastHit expected(i < fewerMaxTs.size() ? map.raycast(rays[i], fewerMaxTs[i]) : RaycastHit());
+				CHECK(hits[i].collidable == expected.collidable);
+			}
+		}
+	}
+}
+
+SCENARIO("A static BVH collision map behaves like every collision map.", "[StaticBVHCollisionMap][movable]") {
+	checkCollisionMapBasics([](const std::vector<Collidable*>& collidables) {
+		return std::make_unique<StaticBVHCollisionMap>(collidables);
+	});
+}
+
+SCENARIO("Benchmarking a static BVH collision map against a list.", "[.][benchmark][StaticBVHCollisionMap]") {
+	const auto walls = makeWallGrid(320, 320);
+	const auto collidables = getPointers(walls);
+	BENCHMARK("Build on one thread") {
+		StaticBVHCollisionMap map(collidables, 1);
+	}
+	BENCHMARK("Build on all threads") {
+		StaticBVHCollisionMap map(collidables);
+	}
+	const StaticBVHCollisionMap bvh(collidables);
+	const ListCollisionMap list(collidables);
+	MovableTest mover(Movable::CollisionType::Deflect, ShapeContainer(Rect(0, 0, 1, 1)), Coord2(100.5f, 100.5f));
+	BENCHMARK("Move through the BVH") {
+		mover.position = Coord2(100.5f, 100.5f);
+		mover.move(Coord2(5, 3), bvh);
+	}
+	BENCHMARK("Move through the list") {
+		mover.position = Coord2(100.5f, 100.5f);
+		mover.move(Coord2(5, 3), list);
+	}
+}
+
+SCENARIO("Benchmarking batched raycasts against a static BVH collision map.", "[.][benchmark][StaticBVHCollisionMap]") {
+	const auto walls = makeWallGrid(100, 100);
+	const auto collidables = getPointers(walls);
+	const StaticBVHCollisionMap bvh(collidables);
+	const std::vector<Ray> rays(makeRayFans({Coord2(50.5f, 50.5f), Coord2(101, 120.2f), Coord2(-10, 30), Coord2(150.5f, 10.5f)}, 256));
+	const std::vector<gFloat> maxTs(rays.size(), 60.0f);
+	std::vector<RaycastHit> hits;
+	BENCHMARK("Loop over intersects") {
+		gFloat t;
+		Coord2 normal;
+		hits.assign(rays.size(), RaycastHit());
+		for (std::size_t i = 0; i < rays.size(); ++i) {
+			gFloat maxT(maxTs[i]);
+			for (Collidable* c : collidables) {
+				if (intersects(rays[i], c->getCollider(), c->getPosition(), t, normal) && t <= maxT) {
+					maxT = t;
+					hits[i] = RaycastHit{c, t, normal};
+				}
+			}
+		}
+	}
+	BENCHMARK("Raycast one at a time") {
+		for (std::size_t i = 0; i < rays.size(); ++i)
+			hits[i] = bvh.raycast(rays[i], maxTs[i]);
+	}
+	BENCHMARK("Raycast in packets") {
+		bvh.raycast(rays, maxTs, hits);
+	}
+}
@@ -0,0 +1,168 @@
+#include "catch.hpp"
+#include "definitions.hpp"
+
+#include <algorithm>
+#include <memory>
+
+using namespace ctp;
+
+namespace {
+bool containsPair(const std::vector<std::pair<Collidable*, Collidable*>>& pairs, const Collidable* a, const Collidable* b) {
+	return std::any_of(pairs.begin(), pairs.end(), [a, b](const auto& p) { return (p.first == a && p.second == b) || (p.first == b && p.second == a); });
+}
+}
+
+SCENARIO("Finding collidables in a sweep and prune collision map.", "[SweepAndPruneCollisionMap]") {
+	SweepAndPruneCollisionMap map;
+	Wall left(Rect(0, 0, 5, 5), Coord2(10, 10));
+	Wall right(Rect(0, 0, 5, 5), Coord2(80, 10));
+	Wall below(Rect(0, 0, 5, 5), Coord2(10, 80));
+	map.insert(&right);
+	map.insert(&below);
+	map.insert(&left);
+	MovableTest mover(Movable::CollisionType::Deflect, ShapeContainer(Circle(1)), Coord2(12, 12));
+	GIVEN("A collider that is stationary.") {
+		WHEN("It is only near one collidable.") {
+			const auto colliding = map.getColliding(mover);
+			THEN("Only that collidable is found, even though another shares its x interval.") {
+				CHECK(colliding.size() == 1);
+				CHECK(contains(colliding, &left));
+			}
+		}
+	}
+	GIVEN("A collider that is moving.") {
+		WHEN("It sweeps across two collidables.") {
+			const auto colliding = map.getColliding(mover, Coord2(70, 0));
+			THEN("Both are found.") {
+				CHECK(colliding.size() == 2);
+				CHECK(contains(colliding, &left));
+				CHECK(contains(colliding, &right));
+			}
+		}
+		WHEN("It starts past a wide collidable that it is inside of.") {
+			Wall wide(Rect(0, 0, 100, 1), Coord2(0, 50));
+			map.insert(&wide);
+			const auto colliding = map.getColliding(mover, Coord2(50, 50), Coord2(0, 0));
+			THEN("The wide collidable is found.") {
+				CHECK(colliding.size() == 1);
+				CHECK(contains(colliding, &wide));
+			}
+		}
+	}
+}
+
+SCENARIO("Updating a sweep and prune collision map.", "[SweepAndPruneCollisionMap]") {
+	SweepAndPruneCollisionMap map;
+	std::vector<std::unique_ptr<MovableTest>> movers;
+	for (int i = 0; i < 10; ++i) {
+		movers.push_back(std::make_unique<MovableTest>(Movable::CollisionType::Deflect, ShapeContainer(Rect(0, 0, 1, 1)), Coord2(static_cast<gFloat>(i * 2), 0)));
+		map.insert(movers.back().get());
+	}
+	GIVEN("No collidables overlap.") {
+		THEN("There are no overlapping pairs.")
+			CHECK(map.getOverlappingPairs().empty());
+	}
+	GIVEN("Collidables move to overlap.") {
+		movers[0]->position = Coord2(8.5f, 0.5f);
+		movers[9]->position = Coord2(2.5f, 0);
+		WHEN("The map isn't updated.") {
+			THEN("The pairs are from the old positions.")
+				CHECK(map.getOverlappingPairs().empty());
+		}
+		WHEN("The map is updated.") {
+			map.update();
+			const auto pairs = map.getOverlappingPairs();
+			THEN("The new pairs are found.") {
+				CHECK(pairs.size() == 2);
+				CHECK(containsPair(pairs, movers[0].get(), movers[4].get()));
+				CHECK(containsPair(pairs, movers[9].get(), movers[1].get()));
+			}
+		}
+	}
+	GIVEN("A collidable is removed.") {
+		movers[1]->position = Coord2(0.5f, 0.5f);
+		map.update();
+		map.remove(movers[0].get());
+		THEN("It is no longer in any pairs.") {
+			CHECK(map.size() == 9);
+			CHECK(map.getOverlappingPairs().empty());
+		}
+	}
+}
+
+SCENARIO("Inserting and removing collidables between updates of a sweep and prune collision map.", "[SweepAndPruneCollisionMap]") {
+	SweepAndPruneCollisionMap map;
+	std::vector<std::unique_ptr<Wall>> walls;
+	for (int i = 0; i < 6; ++i) { // A row of boxes, each overlapping the next.
+		walls.push_back(std::make_unique<Wall>(Rect(0, 0, 1.5f, 1), Coord2(static_cast<gFloat>(i), 0)));
+		if (i < 3)
+			map.insert(walls.back().get());
+	}
+	map.update();
+	map.insert(walls[5].get());
+	map.insert(walls[3].get());
+	map.insert(walls[4].get());
+	map.remove(walls[1].get()); // Sorted.
+	map.remove(walls[5].get()); // Not sorted in yet.
+	map.insert(walls[3].get());
+	MovableTest mover(Movable::CollisionType::Deflect, ShapeContainer(Rect(0, 0, 0.5f, 0.5f)), Coord2(3.7f, 0.25f));
+	GIVEN("The map isn't updated.") {
+		THEN("Inserted collidables are found, and removed ones aren't.") {
+			CHECK(map.size() == 4);
+			CHECK(map.contains(walls[3].get()));
+			CHECK_FALSE(map.contains(walls[1].get()));
+			CHECK_FALSE(map.contains(walls[5].get()));
+			const auto colliding = map.getColliding(mover);
+			CHECK(colliding.size() == 2);
+			CHECK(contains(colliding, walls[3].get()));
+			CHECK(contains(colliding, walls[4].get()));
+			const auto pairs = map.getOverlappingPairs();
+			CHECK(pairs.size() == 2);
+			CHECK(containsPair(pairs, walls[2].get(), walls[3].get()));
+			CHECK(containsPair(pairs, walls[3].get(), walls[4].get()));
+		}
+	}
+	GIVEN("The map is updated.") {
+		map.update();
+		map.remove(walls[3].get());
+		THEN("They are sorted in, and can still be removed.") {
+			CHECK(map.size() == 3);
+			const auto colliding = map.getColliding(mover);
+			CHECK(colliding.size() == 1);
+			CHECK(contains(colliding, walls[4].get()));
+			CHECK(map.getOverlappingPairs().empty());
+			map.update();
+			CHECK(map.getColliding(mover).size() == 1);
+		}
+	}
+}
+
+SCENARIO("A sweep and prune collision map chooses its axis.", "[SweepAndPruneCollisionMap]") {
+	SweepAndPruneCollisionMap map(true);
+	std::vector<std::unique_ptr<Wall>> walls;
+	for (int i = 0; i < 10; ++i) { // A column of boxes.
+		walls.push_back(std::make_unique<Wall>(Rect(0, 0, 1, 1), Coord2(0, static_cast<gFloat>(i * 2))));
+		map.insert(walls.back().get());
+	}
+	CHECK(map.axis() == SweepAndPruneCollisionMap::Axis::X);
+	WHEN("The map is updated.") {
+		map.update();
+		THEN("It sorts along the axis the collidables are spread out on.") {
+			CHECK(map.axis() == SweepAndPruneCollisionMap::Axis::Y);
+			MovableTest mover(Movable::CollisionType::Deflect, ShapeContainer(Rect(0, 0, 1, 2)), Coord2(0, 4.5f));
+			const auto colliding = map.getColliding(mover);
+			CHECK(colliding.size() == 2);
+			CHECK(contains(colliding, walls[2].get()));
+			CHECK(contains(colliding, walls[3].get()));
+		}
+	}
+}
+
+SCENARIO("A sweep and prune collision map behaves like every collision map.", "[SweepAndPruneCollisionMap][movable]") {
+	checkCollisionMapBasics([](const std::vector<Collidable*>& collidables) {
+		auto map = std::make_unique<SweepAndPruneCollisionMap>();
+		for (Collidable* c : collidables)
+			map->insert(c);
+		return map;
+	});
+}